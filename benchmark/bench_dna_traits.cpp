@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+/**
+ * Compare the DnaTraits kernels with the same kernels calling the virtual methods of the DNA alphabet.
+ *
+ * The kernels reproduce the inner loops of SiteFrequencySpectrumMafStatistics (site classification),
+ * VcfOutputMafIterator (genotype calls) and MafSequence::subSequence (start position of the subsequence),
+ * and are instantiated with DnaTraits and GenericAlphabetTraits on the same random alignment.
+ * MafSequence::subSequence itself is also timed, as it dispatches on the alphabet.
+ *
+ * Usage: bench_dna_traits [number of sequences] [number of sites] [number of repeats]
+ */
+
+#include <Bpp/Seq/Io/Maf/DnaTraits.h>
+#include <Bpp/Seq/Io/Maf/MafSequence.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Classify each site as unresolved, saturated (more than two states) or bi/monoallelic.
+ *
+ * @param sites The alignment, site after site.
+ */
+template<class Traits>
+size_t sfsKernel(const Traits& traits, const vector<int>& sites, size_t nbSequences)
+{
+  size_t result = 0;
+  for (size_t i = 0; i < sites.size(); i += nbSequences)
+  {
+    int states[2] = { -1, -1 };
+    size_t counts[2] = { 0, 0 };
+    bool isUnresolved = false;
+    bool isSaturated = false;
+    for (size_t j = 0; !isUnresolved && !isSaturated && j < nbSequences; ++j)
+    {
+      int state = sites[i + j];
+      if (!traits.isResolved(state))
+        isUnresolved = true;
+      else if (counts[0] == 0 || states[0] == state)
+      {
+        states[0] = state;
+        counts[0]++;
+      }
+      else if (counts[1] == 0 || states[1] == state)
+      {
+        states[1] = state;
+        counts[1]++;
+      }
+      else
+        isSaturated = true;
+    }
+    if (isSaturated)
+      result++;
+    else if (!isUnresolved)
+      result += min(counts[0], counts[1]);
+  }
+  return result;
+}
+
+/**
+ * @brief Count missing genotypes, position after position, in each sequence.
+ *
+ * @param rows The sequences of the alignment.
+ */
+template<class Traits>
+size_t vcfKernel(const Traits& traits, const vector<vector<int>>& rows)
+{
+  size_t result = 0;
+  for (size_t i = 0; i < rows[0].size(); ++i)
+  {
+    for (const auto& row : rows)
+    {
+      if (!traits.isResolved(row[i]))
+        result++;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Count the residues before a set of positions, for each sequence.
+ */
+template<class Traits>
+size_t subSequenceKernel(const Traits& traits, const vector<vector<int>>& rows, const vector<size_t>& positions)
+{
+  size_t result = 0;
+  for (const auto& row : rows)
+  {
+    for (size_t startAt : positions)
+    {
+      for (size_t i = 0; i < startAt; ++i)
+      {
+        if (!traits.isGap(row[i]))
+          result++;
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Run a kernel several times and return the best time, in milliseconds.
+ */
+double bestTime(const function<size_t()>& kernel, unsigned int nbRepeats, size_t& result)
+{
+  double best = -1;
+  for (unsigned int r = 0; r < nbRepeats; ++r)
+  {
+    auto start = chrono::steady_clock::now();
+    result = kernel();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    if (best < 0 || elapsed.count() < best)
+      best = elapsed.count();
+  }
+  return best;
+}
+
+int compare(const string& name, const function<size_t()>& dnaKernel, const function<size_t()>& genericKernel, unsigned int nbRepeats)
+{
+  size_t dnaResult = 0, genericResult = 0;
+  double dnaTime = bestTime(dnaKernel, nbRepeats, dnaResult);
+  double genericTime = bestTime(genericKernel, nbRepeats, genericResult);
+  cout << name << "\t" << genericTime << "\t" << dnaTime << "\t" << genericTime / dnaTime << endl;
+  if (dnaResult != genericResult)
+  {
+    cerr << name << ": results differ (" << dnaResult << " vs " << genericResult << ")." << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    size_t nbSequences = argc > 1 ? TextTools::to<size_t>(argv[1]) : 20;
+    size_t nbSites = argc > 2 ? TextTools::to<size_t>(argv[2]) : 1000000;
+    unsigned int nbRepeats = argc > 3 ? TextTools::to<unsigned int>(argv[3]) : 5;
+    const Alphabet& dna = *AlphabetTools::DNA_ALPHABET;
+    DnaTraits dnaTraits;
+    GenericAlphabetTraits genericTraits(dna);
+
+    // Mostly resolved sites, with a few gaps and ambiguity codes, and mostly conserved columns:
+    mt19937 rng(12345);
+    uniform_int_distribution<int> stateDist(0, 99);
+    vector<vector<int>> rows(nbSequences, vector<int>(nbSites));
+    vector<int> reference(nbSites);
+    for (auto& x : reference)
+    {
+      x = stateDist(rng) % 4;
+    }
+    for (auto& row : rows)
+    {
+      for (size_t i = 0; i < nbSites; ++i)
+      {
+        int r = stateDist(rng);
+        row[i] = r < 90 ? reference[i] : r < 95 ? r % 4 : r < 98 ? -1 : 4 + r % 11;
+      }
+    }
+    vector<int> sites(nbSequences * nbSites);
+    for (size_t i = 0; i < nbSites; ++i)
+    {
+      for (size_t j = 0; j < nbSequences; ++j)
+      {
+        sites[i * nbSequences + j] = rows[j][i];
+      }
+    }
+    vector<size_t> positions;
+    for (size_t k = 1; k <= 10; ++k)
+    {
+      positions.push_back(nbSites * k / 10);
+    }
+
+    cout << "# " << nbSequences << " sequences, " << nbSites << " sites, best of " << nbRepeats << " runs." << endl;
+    cout << "Kernel\tAlphabet (ms)\tDnaTraits (ms)\tSpeedup" << endl;
+    int status = 0;
+    status += compare("SFS",
+        [&]() { return sfsKernel(dnaTraits, sites, nbSequences); },
+        [&]() { return sfsKernel(genericTraits, sites, nbSequences); },
+        nbRepeats);
+    status += compare("VCF",
+        [&]() { return vcfKernel(dnaTraits, rows); },
+        [&]() { return vcfKernel(genericTraits, rows); },
+        nbRepeats);
+    status += compare("subSequence",
+        [&]() { return subSequenceKernel(dnaTraits, rows, positions); },
+        [&]() { return subSequenceKernel(genericTraits, rows, positions); },
+        nbRepeats);
+
+    // The library function, which uses DnaTraits for MAF sequences:
+    string letters;
+    for (int x : rows[0])
+    {
+      letters += DnaTraits::intToChar(x);
+    }
+    MafSequence seq("hg.chr1", letters, 0, '+', nbSites);
+    size_t result = 0;
+    double libraryTime = bestTime([&]() {
+          size_t n = 0;
+          for (size_t startAt : positions)
+          {
+            n += seq.subSequence(startAt, nbSites - startAt)->start();
+          }
+          return n;
+        }, nbRepeats, result);
+    cout << "MafSequence::subSequence\t\t" << libraryTime << "\t" << endl;
+    return status;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "BedGraphFeatureWriter.h"
+#include "BedGraphFeatureReader.h"
+
+using namespace bpp;
+using namespace std;
+
+BedGraphFeatureWriter::BedGraphFeatureWriter(ostream& output, const string& trackDefinition, size_t bufferSize) :
+  AbstractFeatureWriter(output, bufferSize)
+{
+  if (!trackDefinition.empty())
+  {
+    buffer_.append("track ");
+    buffer_.append(trackDefinition);
+    endLine_();
+  }
+}
+
+void BedGraphFeatureWriter::writeFeature(const SequenceFeature& feature)
+{
+  buffer_.append(feature.getSequenceId());
+  buffer_.push_back('\t');
+  appendUnsigned_(feature.getStart());
+  buffer_.push_back('\t');
+  appendUnsigned_(feature.getEnd());
+  buffer_.push_back('\t');
+  const string& value = feature.getAttribute(BedGraphFeatureReader::BED_VALUE);
+  if (value.empty())
+    buffer_.push_back('.');
+  else
+    buffer_.append(value);
+  endLine_();
+}
+
+void BedGraphFeatureWriter::writeInterval(const string& seqId, size_t start, size_t end, double value)
+{
+  buffer_.append(seqId);
+  buffer_.push_back('\t');
+  appendUnsigned_(start);
+  buffer_.push_back('\t');
+  appendUnsigned_(end);
+  buffer_.push_back('\t');
+  appendDouble_(value);
+  endLine_();
+}
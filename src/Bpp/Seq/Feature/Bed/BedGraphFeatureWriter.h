@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _BEDGRAPHFEATUREWRITER_H_
+#define _BEDGRAPHFEATUREWRITER_H_
+
+#include "../FeatureWriter.h"
+
+// From the STL:
+#include <string>
+
+namespace bpp
+{
+/**
+ * @brief A buffered writer for features in the BedGraph format.
+ *
+ * Features are written as with BedGraphFeatureReader::toString, the value being taken from the
+ * BedGraphFeatureReader::BED_VALUE attribute ('.' if absent).
+ * Lines are formatted in a reusable buffer and written by large chunks.
+ */
+class BedGraphFeatureWriter :
+  public AbstractFeatureWriter
+{
+public:
+  /**
+   * @param output The output stream.
+   * @param trackDefinition If not empty, a track definition line is written first, with this content after the 'track' keyword
+   * (for instance 'type=bedGraph name=coverage'). Such a line is required to read the file with BedGraphFeatureReader.
+   * @param bufferSize The number of characters to accumulate before writing to the stream.
+   */
+  BedGraphFeatureWriter(std::ostream& output, const std::string& trackDefinition = "", size_t bufferSize = 1048576);
+
+  virtual ~BedGraphFeatureWriter() {}
+
+public:
+  void writeFeature(const SequenceFeature& feature);
+
+  /**
+   * @brief Write an interval with a numerical value, without creating a SequenceFeature object.
+   *
+   * @param seqId The sequence id.
+   * @param start The start position, 0-based.
+   * @param end The end position, 0-based, excluded.
+   * @param value The value associated to the interval, NaN for '.'.
+   */
+  void writeInterval(const std::string& seqId, size_t start, size_t end, double value);
+};
+} // end of namespace bpp
+
+#endif // _BEDGRAPHFEATUREWRITER_H_
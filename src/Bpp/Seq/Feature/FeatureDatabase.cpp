@@ -0,0 +1,578 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "FeatureDatabase.h"
+#include "Gff/GffFeatureReader.h"
+#include "Gtf/GtfFeatureReader.h"
+#include "../Io/BinaryIoTools.h"
+
+// From bpp-core:
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <fstream>
+#include <algorithm>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_FEATUREDATABASE_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// File layout:
+// - Header (HEADER_SIZE bytes): magic, version, numbers of sequences, features, strings and types,
+//   and offsets of the string offsets, string data, sequence table, feature records, attribute blob,
+//   type table and type entries.
+// - String offsets: one 8 bytes offset per string in the string data, plus the total size.
+// - Sequence table (SEQUENCE_SIZE bytes per sequence): name, first feature, number of features, maximum feature length.
+// - Feature records (RECORD_SIZE bytes per feature): start, end, score, id, source, type, strand, phase, attributes offset.
+// - Attribute blob: for each feature, the number of attributes, then pairs of string indices (name, value).
+// - Type table (TYPE_SIZE bytes per type): name, first entry, number of entries. Entries are feature indices.
+
+static const char* FEATUREDATABASE_MAGIC = "BPPFTRDB";
+static constexpr uint32_t FEATUREDATABASE_VERSION = 1;
+static constexpr size_t HEADER_SIZE = 88;
+static constexpr size_t SEQUENCE_SIZE = 32;
+static constexpr size_t RECORD_SIZE = 48;
+static constexpr size_t TYPE_SIZE = 24;
+
+/******************************************************************************/
+
+uint32_t FeatureDatabaseWriter::intern_(const string& s)
+{
+  auto it = stringIndex_.find(s);
+  if (it != stringIndex_.end())
+    return it->second;
+  if (strings_.size() >= numeric_limits<uint32_t>::max())
+    throw Exception("FeatureDatabaseWriter::intern_. Too many distinct strings.");
+  uint32_t i = static_cast<uint32_t>(strings_.size());
+  strings_.push_back(s);
+  stringIndex_[s] = i;
+  return i;
+}
+
+void FeatureDatabaseWriter::addFeature(const SequenceFeature& feature)
+{
+  Record_ record;
+  record.seqId = intern_(feature.getSequenceId());
+  record.start = feature.getStart();
+  record.end = feature.getEnd();
+  record.score = feature.getScore();
+  record.id = intern_(feature.getId());
+  record.source = intern_(feature.getSource());
+  record.type = intern_(feature.getType());
+  record.strand = feature.isStranded() ? (feature.isNegativeStrand() ? '-' : '+') : '.';
+  string phase = feature.getAttribute(GffFeatureReader::GFF_PHASE);
+  if (phase == "")
+    phase = feature.getAttribute(GtfFeatureReader::GTF_PHASE);
+  phase = TextTools::removeSurroundingWhiteSpaces(phase);
+  if (phase != "" && phase != ".")
+    record.phase = static_cast<int8_t>(TextTools::to<int>(phase));
+  record.attributes = attributes_.size();
+  for (const auto& name : feature.getAttributeList())
+  {
+    attributes_.push_back(intern_(name));
+    attributes_.push_back(intern_(feature.getAttribute(name)));
+    record.nbAttributes++;
+  }
+  records_.push_back(record);
+}
+
+void FeatureDatabaseWriter::write(const string& path)
+{
+  // Sort features by sequence name, start and end:
+  stable_sort(records_.begin(), records_.end(), [this](const Record_& r1, const Record_& r2) {
+        if (r1.seqId != r2.seqId)
+          return strings_[r1.seqId] < strings_[r2.seqId];
+        if (r1.start != r2.start)
+          return r1.start < r2.start;
+        return r1.end < r2.end;
+      });
+
+  // Sequence table:
+  string sequences;
+  uint32_t nbSequences = 0;
+  for (size_t i = 0; i < records_.size(); )
+  {
+    size_t j = i;
+    uint64_t maxLength = 0;
+    while (j < records_.size() && records_[j].seqId == records_[i].seqId)
+    {
+      if (records_[j].end > records_[j].start)
+        maxLength = max(maxLength, records_[j].end - records_[j].start);
+      ++j;
+    }
+    BinaryIoTools::putInteger(sequences, records_[i].seqId, 4);
+    BinaryIoTools::putInteger(sequences, 0, 4);
+    BinaryIoTools::putInteger(sequences, i, 8);
+    BinaryIoTools::putInteger(sequences, j - i, 8);
+    BinaryIoTools::putInteger(sequences, maxLength, 8);
+    nbSequences++;
+    i = j;
+  }
+
+  // Type table, sorted by name:
+  map<string, vector<uint64_t>> typeEntries;
+  for (size_t i = 0; i < records_.size(); ++i)
+  {
+    typeEntries[strings_[records_[i].type]].push_back(i);
+  }
+  string types;
+  uint64_t nbEntries = 0;
+  for (const auto& type : typeEntries)
+  {
+    BinaryIoTools::putInteger(types, stringIndex_[type.first], 4);
+    BinaryIoTools::putInteger(types, 0, 4);
+    BinaryIoTools::putInteger(types, nbEntries, 8);
+    BinaryIoTools::putInteger(types, type.second.size(), 8);
+    nbEntries += type.second.size();
+  }
+
+  // Compute offsets:
+  uint64_t stringDataSize = 0;
+  for (const auto& s : strings_)
+  {
+    stringDataSize += s.size();
+  }
+  uint64_t attributesSize = 4 * (records_.size() + attributes_.size());
+  uint64_t stringOffsetsOffset = HEADER_SIZE;
+  uint64_t stringDataOffset = stringOffsetsOffset + 8 * (strings_.size() + 1);
+  uint64_t sequencesOffset = stringDataOffset + stringDataSize;
+  sequencesOffset += (8 - sequencesOffset % 8) % 8;
+  uint64_t recordsOffset = sequencesOffset + sequences.size();
+  uint64_t attributesOffset = recordsOffset + RECORD_SIZE * records_.size();
+  uint64_t typesOffset = attributesOffset + attributesSize;
+  typesOffset += (8 - typesOffset % 8) % 8;
+  uint64_t typeEntriesOffset = typesOffset + types.size();
+
+  ofstream output(path.c_str(), ios::out | ios::binary);
+  if (!output)
+    throw Exception("FeatureDatabaseWriter::write. Unable to open file " + path + ".");
+  string buffer;
+  auto flush = [&](bool force) {
+        if (force || buffer.size() >= 1048576)
+        {
+          output.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+          buffer.clear();
+        }
+      };
+  auto pad = [&]() {
+        while ((static_cast<uint64_t>(output.tellp()) + buffer.size()) % 8 != 0)
+        {
+          buffer.push_back('\0');
+        }
+      };
+
+  buffer.append(FEATUREDATABASE_MAGIC, 8);
+  BinaryIoTools::putInteger(buffer, FEATUREDATABASE_VERSION, 4);
+  BinaryIoTools::putInteger(buffer, nbSequences, 4);
+  BinaryIoTools::putInteger(buffer, records_.size(), 8);
+  BinaryIoTools::putInteger(buffer, strings_.size(), 4);
+  BinaryIoTools::putInteger(buffer, typeEntries.size(), 4);
+  BinaryIoTools::putInteger(buffer, stringOffsetsOffset, 8);
+  BinaryIoTools::putInteger(buffer, stringDataOffset, 8);
+  BinaryIoTools::putInteger(buffer, sequencesOffset, 8);
+  BinaryIoTools::putInteger(buffer, recordsOffset, 8);
+  BinaryIoTools::putInteger(buffer, attributesOffset, 8);
+  BinaryIoTools::putInteger(buffer, typesOffset, 8);
+  BinaryIoTools::putInteger(buffer, typeEntriesOffset, 8);
+
+  // Strings:
+  uint64_t offset = 0;
+  for (const auto& s : strings_)
+  {
+    BinaryIoTools::putInteger(buffer, offset, 8);
+    offset += s.size();
+    flush(false);
+  }
+  BinaryIoTools::putInteger(buffer, offset, 8);
+  for (const auto& s : strings_)
+  {
+    buffer.append(s);
+    flush(false);
+  }
+  pad();
+
+  // Sequences and features:
+  buffer.append(sequences);
+  uint64_t attributeOffset = 0;
+  for (const auto& record : records_)
+  {
+    BinaryIoTools::putInteger(buffer, record.start, 8);
+    BinaryIoTools::putInteger(buffer, record.end, 8);
+    BinaryIoTools::putDouble(buffer, record.score);
+    BinaryIoTools::putInteger(buffer, record.id, 4);
+    BinaryIoTools::putInteger(buffer, record.source, 4);
+    BinaryIoTools::putInteger(buffer, record.type, 4);
+    buffer.push_back(record.strand);
+    buffer.push_back(static_cast<char>(record.phase));
+    BinaryIoTools::putInteger(buffer, 0, 2);
+    BinaryIoTools::putInteger(buffer, attributeOffset, 8);
+    attributeOffset += 4 * (1 + 2 * static_cast<uint64_t>(record.nbAttributes));
+    flush(false);
+  }
+
+  // Attributes:
+  for (const auto& record : records_)
+  {
+    BinaryIoTools::putInteger(buffer, record.nbAttributes, 4);
+    for (size_t k = 0; k < 2 * static_cast<size_t>(record.nbAttributes); ++k)
+    {
+      BinaryIoTools::putInteger(buffer, attributes_[record.attributes + k], 4);
+    }
+    flush(false);
+  }
+  pad();
+
+  // Types:
+  buffer.append(types);
+  for (const auto& type : typeEntries)
+  {
+    for (auto i : type.second)
+    {
+      BinaryIoTools::putInteger(buffer, i, 8);
+      flush(false);
+    }
+  }
+  flush(true);
+  output.close();
+  if (!output)
+    throw Exception("FeatureDatabaseWriter::write. Error while writing file " + path + ".");
+}
+
+/******************************************************************************/
+
+FeatureDatabase::FeatureDatabase(const string& path) :
+  data_(nullptr),
+  size_(0),
+  isMapped_(false),
+  buffer_(),
+  nbFeatures_(0),
+  nbStrings_(0),
+  stringOffsets_(nullptr),
+  stringData_(nullptr),
+  records_(nullptr),
+  attributes_(nullptr),
+  typeEntries_(nullptr),
+  sequences_(),
+  sequenceStarts_(),
+  maxLengths_(),
+  sequenceIndex_(),
+  types_(),
+  typeStringIds_(),
+  typeStarts_(),
+  typeCounts_()
+{
+#ifdef BPP_FEATUREDATABASE_USE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw Exception("FeatureDatabase. Unable to open file " + path + ".");
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED)
+    {
+      data_ = static_cast<const char*>(p);
+      size_ = static_cast<size_t>(st.st_size);
+      isMapped_ = true;
+    }
+  }
+  close(fd);
+#endif
+  if (!isMapped_)
+  {
+    ifstream input(path.c_str(), ios::in | ios::binary);
+    if (!input)
+      throw Exception("FeatureDatabase. Unable to open file " + path + ".");
+    buffer_.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+  try
+  {
+    readHeader_(path);
+  }
+  catch (...)
+  {
+#ifdef BPP_FEATUREDATABASE_USE_MMAP
+    if (isMapped_)
+      munmap(const_cast<char*>(data_), size_);
+#endif
+    throw;
+  }
+}
+
+FeatureDatabase::~FeatureDatabase()
+{
+#ifdef BPP_FEATUREDATABASE_USE_MMAP
+  if (isMapped_)
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+void FeatureDatabase::readHeader_(const string& path)
+{
+  if (size_ < HEADER_SIZE || string(data_, 8) != FEATUREDATABASE_MAGIC)
+    throw Exception("FeatureDatabase. Not a feature database, or truncated file: " + path + ".");
+  if (BinaryIoTools::getUInt32(data_ + 8) != FEATUREDATABASE_VERSION)
+    throw Exception("FeatureDatabase. Unsupported format version in " + path + ".");
+  uint32_t nbSequences = BinaryIoTools::getUInt32(data_ + 12);
+  nbFeatures_ = BinaryIoTools::getInteger(data_ + 16, 8);
+  nbStrings_ = BinaryIoTools::getUInt32(data_ + 24);
+  uint32_t nbTypes = BinaryIoTools::getUInt32(data_ + 28);
+  auto section = [&](size_t pos, uint64_t length) {
+        uint64_t offset = BinaryIoTools::getInteger(data_ + pos, 8);
+        if (offset > size_ || length > size_ - offset)
+          throw Exception("FeatureDatabase. Corrupted file: " + path + ".");
+        return data_ + offset;
+      };
+  stringOffsets_ = section(32, 8 * (static_cast<uint64_t>(nbStrings_) + 1));
+  stringData_ = section(40, BinaryIoTools::getInteger(stringOffsets_ + 8 * static_cast<size_t>(nbStrings_), 8));
+  const char* sequences = section(48, SEQUENCE_SIZE * static_cast<uint64_t>(nbSequences));
+  records_ = section(56, RECORD_SIZE * nbFeatures_);
+  attributes_ = section(64, 4 * nbFeatures_);
+  const char* types = section(72, TYPE_SIZE * static_cast<uint64_t>(nbTypes));
+  typeEntries_ = section(80, 8 * nbFeatures_);
+
+  for (uint32_t i = 0; i < nbSequences; ++i)
+  {
+    const char* p = sequences + SEQUENCE_SIZE * i;
+    string name = getString_(BinaryIoTools::getUInt32(p));
+    sequenceIndex_[name] = sequences_.size();
+    sequences_.push_back(name);
+    sequenceStarts_.push_back(BinaryIoTools::getInteger(p + 8, 8));
+    maxLengths_.push_back(BinaryIoTools::getInteger(p + 24, 8));
+  }
+  sequenceStarts_.push_back(nbFeatures_);
+  for (uint32_t i = 0; i < nbTypes; ++i)
+  {
+    const char* p = types + TYPE_SIZE * i;
+    uint32_t name = BinaryIoTools::getUInt32(p);
+    types_[getString_(name)] = typeStringIds_.size();
+    typeStringIds_.push_back(name);
+    typeStarts_.push_back(BinaryIoTools::getInteger(p + 8, 8));
+    typeCounts_.push_back(BinaryIoTools::getInteger(p + 16, 8));
+  }
+}
+
+string FeatureDatabase::getString_(uint64_t i) const
+{
+  if (i >= nbStrings_)
+    throw Exception("FeatureDatabase::getString_. Invalid string index: " + TextTools::toString(i) + ".");
+  uint64_t begin = BinaryIoTools::getInteger(stringOffsets_ + 8 * i, 8);
+  uint64_t end = BinaryIoTools::getInteger(stringOffsets_ + 8 * (i + 1), 8);
+  return string(stringData_ + begin, static_cast<size_t>(end - begin));
+}
+
+const char* FeatureDatabase::record_(size_t i) const
+{
+  if (i >= nbFeatures_)
+    throw Exception("FeatureDatabase::record_. Invalid feature index: " + TextTools::toString(i) + ".");
+  return records_ + RECORD_SIZE * i;
+}
+
+/******************************************************************************/
+
+pair<size_t, size_t> FeatureDatabase::getFeatureIndices(const string& seqId) const
+{
+  auto it = sequenceIndex_.find(seqId);
+  if (it == sequenceIndex_.end())
+    return make_pair(0, 0);
+  return make_pair(static_cast<size_t>(sequenceStarts_[it->second]), static_cast<size_t>(sequenceStarts_[it->second + 1]));
+}
+
+vector<string> FeatureDatabase::getTypes() const
+{
+  vector<string> types;
+  for (const auto& type : types_)
+  {
+    types.push_back(type.first);
+  }
+  return types;
+}
+
+size_t FeatureDatabase::getStart(size_t i) const
+{
+  return static_cast<size_t>(BinaryIoTools::getInteger(record_(i), 8));
+}
+
+size_t FeatureDatabase::getEnd(size_t i) const
+{
+  return static_cast<size_t>(BinaryIoTools::getInteger(record_(i) + 8, 8));
+}
+
+double FeatureDatabase::getScore(size_t i) const
+{
+  return BinaryIoTools::getDouble(record_(i) + 16);
+}
+
+string FeatureDatabase::getId(size_t i) const
+{
+  return getString_(BinaryIoTools::getUInt32(record_(i) + 24));
+}
+
+string FeatureDatabase::getSource(size_t i) const
+{
+  return getString_(BinaryIoTools::getUInt32(record_(i) + 28));
+}
+
+string FeatureDatabase::getType(size_t i) const
+{
+  return getString_(BinaryIoTools::getUInt32(record_(i) + 32));
+}
+
+char FeatureDatabase::getStrand(size_t i) const
+{
+  return record_(i)[36];
+}
+
+int FeatureDatabase::getPhase(size_t i) const
+{
+  return static_cast<int>(static_cast<int8_t>(record_(i)[37]));
+}
+
+const string& FeatureDatabase::getSequenceId(size_t i) const
+{
+  if (i >= nbFeatures_)
+    throw Exception("FeatureDatabase::getSequenceId. Invalid feature index: " + TextTools::toString(i) + ".");
+  auto it = upper_bound(sequenceStarts_.begin(), sequenceStarts_.end(), static_cast<uint64_t>(i));
+  return sequences_[static_cast<size_t>(it - sequenceStarts_.begin()) - 1];
+}
+
+BasicSequenceFeature FeatureDatabase::getFeature(size_t i) const
+{
+  const char* p = record_(i);
+  BasicSequenceFeature feature(
+      getString_(BinaryIoTools::getUInt32(p + 24)),
+      getSequenceId(i),
+      getString_(BinaryIoTools::getUInt32(p + 28)),
+      getString_(BinaryIoTools::getUInt32(p + 32)),
+      static_cast<size_t>(BinaryIoTools::getInteger(p, 8)),
+      static_cast<size_t>(BinaryIoTools::getInteger(p + 8, 8)),
+      p[36],
+      BinaryIoTools::getDouble(p + 16));
+  uint64_t offset = BinaryIoTools::getInteger(p + 40, 8);
+  const char* a = attributes_ + offset;
+  uint32_t nbAttributes = BinaryIoTools::getUInt32(a);
+  for (uint32_t k = 0; k < nbAttributes; ++k)
+  {
+    feature.setAttribute(
+        getString_(BinaryIoTools::getUInt32(a + 4 + 8 * k)),
+        getString_(BinaryIoTools::getUInt32(a + 8 + 8 * k)));
+  }
+  return feature;
+}
+
+/******************************************************************************/
+
+vector<uint32_t> FeatureDatabase::getTypeStringIds_(const vector<string>& types) const
+{
+  vector<uint32_t> ids;
+  for (const auto& type : types)
+  {
+    auto it = types_.find(type);
+    if (it != types_.end())
+      ids.push_back(typeStringIds_[it->second]);
+  }
+  return ids;
+}
+
+bool FeatureDatabase::hasType_(size_t i, const vector<uint32_t>& types) const
+{
+  uint32_t type = BinaryIoTools::getUInt32(record_(i) + 32);
+  return find(types.begin(), types.end(), type) != types.end();
+}
+
+void FeatureDatabase::getFeatureIndicesForSequence(const string& seqId, vector<size_t>& indices, const vector<string>& types) const
+{
+  auto range = getFeatureIndices(seqId);
+  vector<uint32_t> typeIds = getTypeStringIds_(types);
+  if (!types.empty() && typeIds.empty())
+    return;
+  for (size_t i = range.first; i < range.second; ++i)
+  {
+    if (typeIds.empty() || hasType_(i, typeIds))
+      indices.push_back(i);
+  }
+}
+
+void FeatureDatabase::getOverlappingFeatureIndices(const string& seqId, size_t begin, size_t end, vector<size_t>& indices) const
+{
+  auto it = sequenceIndex_.find(seqId);
+  if (it == sequenceIndex_.end() || begin >= end)
+    return;
+  size_t first = static_cast<size_t>(sequenceStarts_[it->second]);
+  size_t last = static_cast<size_t>(sequenceStarts_[it->second + 1]);
+  // No feature starting before begin - maxLength can overlap the interval:
+  uint64_t maxLength = maxLengths_[it->second];
+  size_t minStart = begin > maxLength ? static_cast<size_t>(begin - maxLength) : 0;
+  size_t a = first, b = last;
+  while (a < b)
+  {
+    size_t m = a + (b - a) / 2;
+    if (getStart(m) < minStart)
+      a = m + 1;
+    else
+      b = m;
+  }
+  for (size_t i = a; i < last; ++i)
+  {
+    size_t start = getStart(i);
+    if (start >= end)
+      break;
+    if (getEnd(i) > begin)
+      indices.push_back(i);
+  }
+}
+
+void FeatureDatabase::fillRangeCollectionForSequence(const string& seqId, RangeCollection<size_t>& coords, const vector<string>& types) const
+{
+  vector<size_t> indices;
+  getFeatureIndicesForSequence(seqId, indices, types);
+  for (auto i : indices)
+  {
+    const char* p = record_(i);
+    coords.addRange(SeqRange(
+        static_cast<size_t>(BinaryIoTools::getInteger(p, 8)),
+        static_cast<size_t>(BinaryIoTools::getInteger(p + 8, 8)),
+        p[36]));
+  }
+}
+
+void FeatureDatabase::getAllFeatures(SequenceFeatureSet& features) const
+{
+  for (size_t i = 0; i < nbFeatures_; ++i)
+  {
+    features.addFeature(getFeature(i));
+  }
+}
+
+void FeatureDatabase::getFeaturesOfType(const string& type, SequenceFeatureSet& features) const
+{
+  auto it = types_.find(type);
+  if (it == types_.end())
+    return;
+  uint64_t first = typeStarts_[it->second];
+  for (uint64_t k = 0; k < typeCounts_[it->second]; ++k)
+  {
+    features.addFeature(getFeature(static_cast<size_t>(BinaryIoTools::getInteger(typeEntries_ + 8 * (first + k), 8))));
+  }
+}
+
+void FeatureDatabase::getFeaturesOfSequence(const string& seqId, SequenceFeatureSet& features) const
+{
+  auto range = getFeatureIndices(seqId);
+  for (size_t i = range.first; i < range.second; ++i)
+  {
+    features.addFeature(getFeature(i));
+  }
+}
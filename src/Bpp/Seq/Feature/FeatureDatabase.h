@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _FEATUREDATABASE_H_
+#define _FEATUREDATABASE_H_
+
+#include "SequenceFeature.h"
+#include "FeatureReader.h"
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+#include <Bpp/Numeric/Range.h>
+
+// From the STL:
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief Compile features into a binary feature database.
+ *
+ * Features are added one at a time, for instance while reading a GFF, GTF or BedGraph file,
+ * and only a compact representation is kept in memory: all strings (sequence ids, sources, types, ids,
+ * attribute names and values) are interned, so that repeated values are stored once.
+ * The database is written when write() is called, and can then be opened with FeatureDatabase.
+ *
+ * The file contains:
+ * - a string table,
+ * - one array of fixed-size feature records per sequence, sorted by start and end positions,
+ * - an attribute blob, where the attributes of each feature are stored as pairs of string indices,
+ * - a type index, listing the features of each type.
+ * All numbers are stored in little-endian order, so that files can be shared between platforms.
+ */
+class FeatureDatabaseWriter
+{
+private:
+  struct Record_
+  {
+    uint32_t seqId;
+    uint64_t start;
+    uint64_t end;
+    double score;
+    uint32_t id;
+    uint32_t source;
+    uint32_t type;
+    char strand;
+    int8_t phase;
+    uint64_t attributes; // Index in attributes_.
+    uint32_t nbAttributes;
+
+    Record_() :
+      seqId(0), start(0), end(0), score(0), id(0), source(0), type(0),
+      strand('.'), phase(-1), attributes(0), nbAttributes(0) {}
+  };
+
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> stringIndex_;
+  std::vector<Record_> records_;
+  std::vector<uint32_t> attributes_;
+
+public:
+  FeatureDatabaseWriter() :
+    strings_(), stringIndex_(), records_(), attributes_() {}
+
+  virtual ~FeatureDatabaseWriter() {}
+
+public:
+  /**
+   * @brief Add a feature to the database.
+   *
+   * The phase is taken from the GffFeatureReader::GFF_PHASE or GtfFeatureReader::GTF_PHASE attribute, if any.
+   *
+   * @param feature The feature to add.
+   */
+  void addFeature(const SequenceFeature& feature);
+
+  /**
+   * @brief Add all features from a reader, one at a time.
+   *
+   * @param reader The feature reader.
+   */
+  void addFeatures(FeatureReader& reader)
+  {
+    while (reader.hasMoreFeature())
+    {
+      addFeature(reader.nextFeature());
+    }
+  }
+
+  /**
+   * @brief Add all features in a set.
+   *
+   * @param features The features to add.
+   */
+  void addFeatures(const SequenceFeatureSet& features)
+  {
+    for (size_t i = 0; i < features.getNumberOfFeatures(); ++i)
+    {
+      addFeature(features[i]);
+    }
+  }
+
+  size_t getNumberOfFeatures() const { return records_.size(); }
+
+  /**
+   * @brief Sort the features and write the database.
+   *
+   * @param path The path of the output file.
+   */
+  void write(const std::string& path);
+
+private:
+  uint32_t intern_(const std::string& s);
+};
+
+/**
+ * @brief Read-only access to a binary feature database written by FeatureDatabaseWriter.
+ *
+ * The file is memory-mapped when the platform allows it, and read in memory otherwise.
+ * Opening a database only reads the list of sequences and types: features are decoded on demand,
+ * so that range collections can be built per sequence when needed, for instance with FeatureFilterMafIterator
+ * and FeatureExtractorMafIterator.
+ *
+ * Features are numbered from 0, sorted by sequence id, then start and end positions.
+ */
+class FeatureDatabase
+{
+public:
+  static constexpr int8_t NO_PHASE = -1;
+
+private:
+  const char* data_;
+  size_t size_;
+  bool isMapped_;
+  std::string buffer_; // Used when the file is not mapped.
+  uint64_t nbFeatures_;
+  uint32_t nbStrings_;
+  const char* stringOffsets_;
+  const char* stringData_;
+  const char* records_;
+  const char* attributes_;
+  const char* typeEntries_;
+  std::vector<std::string> sequences_;
+  std::vector<uint64_t> sequenceStarts_; // One more than the number of sequences.
+  std::vector<uint64_t> maxLengths_;
+  std::map<std::string, size_t> sequenceIndex_;
+  std::map<std::string, size_t> types_;
+  std::vector<uint32_t> typeStringIds_;
+  std::vector<uint64_t> typeStarts_;
+  std::vector<uint64_t> typeCounts_;
+
+public:
+  /**
+   * @param path The path of the database file.
+   */
+  FeatureDatabase(const std::string& path);
+
+  virtual ~FeatureDatabase();
+
+private:
+  FeatureDatabase(const FeatureDatabase&) = delete;
+  FeatureDatabase& operator=(const FeatureDatabase&) = delete;
+
+public:
+  size_t getNumberOfFeatures() const { return static_cast<size_t>(nbFeatures_); }
+
+  /**
+   * @return The ids of all sequences with at least one feature, sorted.
+   */
+  const std::vector<std::string>& getSequences() const { return sequences_; }
+
+  bool hasSequence(const std::string& seqId) const { return sequenceIndex_.find(seqId) != sequenceIndex_.end(); }
+
+  /**
+   * @return The indices [first, last[ of the features of a sequence, with first == last if there is none.
+   */
+  std::pair<size_t, size_t> getFeatureIndices(const std::string& seqId) const;
+
+  /**
+   * @return The types of all features, sorted.
+   */
+  std::vector<std::string> getTypes() const;
+
+  /**
+   * @name Access to individual features, without creating a SequenceFeature object.
+   *
+   * @{
+   */
+  size_t getStart(size_t i) const;
+  size_t getEnd(size_t i) const;
+  char getStrand(size_t i) const;
+  double getScore(size_t i) const;
+
+  /**
+   * @return The phase of the feature, or NO_PHASE.
+   */
+  int getPhase(size_t i) const;
+
+  std::string getType(size_t i) const;
+  std::string getSource(size_t i) const;
+  std::string getId(size_t i) const;
+  const std::string& getSequenceId(size_t i) const;
+  /** @} */
+
+  /**
+   * @return The feature with the given index, with all its attributes.
+   */
+  BasicSequenceFeature getFeature(size_t i) const;
+
+  /**
+   * @brief Get the indices of the features of a sequence.
+   *
+   * @param seqId The sequence id.
+   * @param indices The vector where to add the indices, in increasing order.
+   * @param types If not empty, only features of these types are selected.
+   */
+  void getFeatureIndicesForSequence(const std::string& seqId, std::vector<size_t>& indices, const std::vector<std::string>& types = std::vector<std::string>()) const;
+
+  /**
+   * @brief Get the indices of the features of a sequence overlapping a given interval.
+   *
+   * @param seqId The sequence id.
+   * @param begin, end The interval, 0-based, end excluded.
+   * @param indices The vector where to add the indices, in increasing order.
+   */
+  void getOverlappingFeatureIndices(const std::string& seqId, size_t begin, size_t end, std::vector<size_t>& indices) const;
+
+  /**
+   * @brief Add the coordinates of the features of a sequence to a range collection, as SeqRange objects.
+   *
+   * @param seqId The sequence id.
+   * @param coords The range collection where to add the coordinates.
+   * @param types If not empty, only features of these types are added.
+   */
+  void fillRangeCollectionForSequence(const std::string& seqId, RangeCollection<size_t>& coords, const std::vector<std::string>& types = std::vector<std::string>()) const;
+
+  /**
+   * @name Retrieval of features as SequenceFeature objects, as with FeatureReader.
+   *
+   * @{
+   */
+  void getAllFeatures(SequenceFeatureSet& features) const;
+  void getFeaturesOfType(const std::string& type, SequenceFeatureSet& features) const;
+  void getFeaturesOfSequence(const std::string& seqId, SequenceFeatureSet& features) const;
+  /** @} */
+
+private:
+  void readHeader_(const std::string& path);
+
+  std::string getString_(uint64_t i) const;
+
+  const char* record_(size_t i) const;
+
+  /**
+   * @return The string indices of the given types. Types absent from the database are ignored.
+   */
+  std::vector<uint32_t> getTypeStringIds_(const std::vector<std::string>& types) const;
+
+  bool hasType_(size_t i, const std::vector<uint32_t>& types) const;
+};
+} // end of namespace bpp
+
+#endif // _FEATUREDATABASE_H_
@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _FEATUREWRITER_H_
+#define _FEATUREWRITER_H_
+
+#include "SequenceFeature.h"
+
+// From bpp-core:
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cmath>
+#include <map>
+
+namespace bpp
+{
+/**
+ * @brief Interface for feature writers.
+ */
+class FeatureWriter
+{
+public:
+  FeatureWriter() {}
+  virtual ~FeatureWriter() {}
+
+public:
+  /**
+   * @brief Write one feature.
+   *
+   * @param feature The feature to write.
+   */
+  virtual void writeFeature(const SequenceFeature& feature) = 0;
+
+  /**
+   * @brief Write all features in a set.
+   *
+   * @param features The features to write.
+   */
+  virtual void writeFeatures(const SequenceFeatureSet& features)
+  {
+    for (size_t i = 0; i < features.getNumberOfFeatures(); ++i)
+    {
+      writeFeature(features[i]);
+    }
+  }
+
+  /**
+   * @brief Write all pending data to the underlying stream.
+   */
+  virtual void flush() = 0;
+};
+
+/**
+ * @brief Partial implementation of FeatureWriter, formatting lines in a buffer.
+ *
+ * Lines are formatted directly in a reusable character buffer, without intermediate strings,
+ * and the buffer is written to the output stream when it exceeds a given size, and when the writer is destroyed.
+ * Integers are formatted with a dedicated fast path, and real numbers as with the default stream formatting.
+ */
+class AbstractFeatureWriter :
+  public virtual FeatureWriter
+{
+private:
+  std::ostream& output_;
+  size_t bufferSize_;
+
+protected:
+  std::string buffer_;
+
+public:
+  /**
+   * @param output The output stream.
+   * @param bufferSize The number of characters to accumulate before writing to the stream.
+   */
+  AbstractFeatureWriter(std::ostream& output, size_t bufferSize = 1048576) :
+    output_(output), bufferSize_(bufferSize), buffer_()
+  {
+    buffer_.reserve(bufferSize + 1024);
+  }
+
+  virtual ~AbstractFeatureWriter()
+  {
+    try
+    {
+      flush();
+    }
+    catch (...)
+    {}
+  }
+
+private:
+  AbstractFeatureWriter(const AbstractFeatureWriter&) = delete;
+  AbstractFeatureWriter& operator=(const AbstractFeatureWriter&) = delete;
+
+public:
+  void flush()
+  {
+    if (buffer_.size() > 0)
+    {
+      output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      buffer_.clear();
+      if (!output_)
+        throw Exception("AbstractFeatureWriter::flush. Error while writing features.");
+    }
+  }
+
+protected:
+  /**
+   * @brief Terminate the current line, and write the buffer if it is full.
+   */
+  void endLine_()
+  {
+    buffer_.push_back('\n');
+    if (buffer_.size() >= bufferSize_)
+      flush();
+  }
+
+  void appendUnsigned_(size_t x)
+  {
+    char tmp[24];
+    size_t n = 0;
+    do
+    {
+      tmp[n++] = static_cast<char>('0' + x % 10);
+      x /= 10;
+    }
+    while (x > 0);
+    while (n > 0)
+    {
+      buffer_.push_back(tmp[--n]);
+    }
+  }
+
+  void appendDouble_(double x)
+  {
+    if (std::isnan(x))
+      buffer_.push_back('.');
+    else if (x == std::floor(x) && std::fabs(x) < 1e15)
+    {
+      if (x < 0)
+        buffer_.push_back('-');
+      appendUnsigned_(static_cast<size_t>(std::fabs(x)));
+    }
+    else
+    {
+      char tmp[32];
+      int n = snprintf(tmp, sizeof(tmp), "%g", x);
+      buffer_.append(tmp, static_cast<size_t>(n));
+    }
+  }
+
+  void appendStrand_(const SequenceFeature& feature)
+  {
+    buffer_.push_back(feature.isStranded() ? (feature.isNegativeStrand() ? '-' : '+') : '.');
+  }
+
+  /**
+   * @brief Get the attributes of a feature, sorted by name.
+   *
+   * The attributes of a BasicSequenceFeature are returned without copy,
+   * other features are copied in the temporary map.
+   *
+   * @param feature The feature.
+   * @param tmp A temporary map, only used if the attributes cannot be accessed directly.
+   * @return A reference to the map of attributes.
+   */
+  static const std::map<std::string, std::string>& getAttributes_(const SequenceFeature& feature, std::map<std::string, std::string>& tmp)
+  {
+    const BasicSequenceFeature* bf = dynamic_cast<const BasicSequenceFeature*>(&feature);
+    if (bf)
+      return bf->getAttributes();
+    tmp.clear();
+    for (const auto& name : feature.getAttributeList())
+    {
+      tmp[name] = feature.getAttribute(name);
+    }
+    return tmp;
+  }
+};
+} // end of namespace bpp
+
+#endif // _FEATUREWRITER_H_
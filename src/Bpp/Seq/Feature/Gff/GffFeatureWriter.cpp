@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "GffFeatureWriter.h"
+#include "GffFeatureReader.h"
+
+using namespace bpp;
+using namespace std;
+
+void GffFeatureWriter::appendColumns_(
+    const string& seqId,
+    const string& source,
+    const string& type,
+    size_t start,
+    size_t end,
+    double score,
+    char strand)
+{
+  buffer_.append(seqId);
+  buffer_.push_back('\t');
+  buffer_.append(source);
+  buffer_.push_back('\t');
+  buffer_.append(type);
+  buffer_.push_back('\t');
+  appendUnsigned_(start + 1);
+  buffer_.push_back('\t');
+  appendUnsigned_(end);
+  buffer_.push_back('\t');
+  appendDouble_(score);
+  buffer_.push_back('\t');
+  buffer_.push_back(strand);
+  buffer_.push_back('\t');
+}
+
+void GffFeatureWriter::writeFeature(const SequenceFeature& feature)
+{
+  appendColumns_(feature.getSequenceId(), feature.getSource(), feature.getType(),
+      feature.getStart(), feature.getEnd(), feature.getScore(),
+      feature.isStranded() ? (feature.isNegativeStrand() ? '-' : '+') : '.');
+  const map<string, string>& attributes = getAttributes_(feature, tmpAttributes_);
+  auto phase = attributes.find(GffFeatureReader::GFF_PHASE);
+  if (phase == attributes.end() || phase->second.empty())
+    buffer_.push_back('.');
+  else
+    buffer_.append(phase->second);
+  buffer_.push_back('\t');
+  bool first = true;
+  if (!feature.getId().empty())
+  {
+    buffer_.append("ID=");
+    buffer_.append(feature.getId());
+    first = false;
+  }
+  for (const auto& attribute : attributes)
+  {
+    if (attribute.first == GffFeatureReader::GFF_PHASE)
+      continue;
+    if (!first)
+      buffer_.push_back(';');
+    buffer_.append(attribute.first);
+    buffer_.push_back('=');
+    buffer_.append(attribute.second);
+    first = false;
+  }
+  endLine_();
+}
+
+void GffFeatureWriter::writeFeature(
+    const string& seqId,
+    const string& source,
+    const string& type,
+    size_t start,
+    size_t end,
+    double score,
+    char strand,
+    const string& id)
+{
+  appendColumns_(seqId, source, type, start, end, score, strand);
+  buffer_.append(".\t");
+  if (!id.empty())
+  {
+    buffer_.append("ID=");
+    buffer_.append(id);
+  }
+  endLine_();
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _GFFFEATUREWRITER_H_
+#define _GFFFEATUREWRITER_H_
+
+#include "../FeatureWriter.h"
+
+// From the STL:
+#include <string>
+#include <map>
+
+namespace bpp
+{
+/**
+ * @brief A buffered writer for features in the GFF3 format.
+ *
+ * Features are written as with GffFeatureReader::toString, but lines are formatted in a reusable buffer
+ * and written by large chunks, which is much faster when writing many features.
+ * The phase is taken from the GffFeatureReader::GFF_PHASE attribute, which is not repeated in the attribute column.
+ * Missing scores (NaN) are written as '.'.
+ */
+class GffFeatureWriter :
+  public AbstractFeatureWriter
+{
+private:
+  std::map<std::string, std::string> tmpAttributes_;
+
+public:
+  /**
+   * @param output The output stream.
+   * @param bufferSize The number of characters to accumulate before writing to the stream.
+   */
+  GffFeatureWriter(std::ostream& output, size_t bufferSize = 1048576) :
+    AbstractFeatureWriter(output, bufferSize), tmpAttributes_() {}
+
+  virtual ~GffFeatureWriter() {}
+
+public:
+  void writeFeature(const SequenceFeature& feature);
+
+  /**
+   * @brief Write a feature from its raw fields, without creating a SequenceFeature object.
+   *
+   * @param seqId The sequence id.
+   * @param source The source of the feature.
+   * @param type The type of the feature.
+   * @param start The start position, 0-based.
+   * @param end The end position, 0-based, excluded.
+   * @param score The score of the feature, NaN if none.
+   * @param strand The strand, '+', '-' or '.'.
+   * @param id The id of the feature, ignored if empty.
+   */
+  void writeFeature(
+      const std::string& seqId,
+      const std::string& source,
+      const std::string& type,
+      size_t start,
+      size_t end,
+      double score,
+      char strand,
+      const std::string& id);
+
+private:
+  void appendColumns_(
+      const std::string& seqId,
+      const std::string& source,
+      const std::string& type,
+      size_t start,
+      size_t end,
+      double score,
+      char strand);
+};
+} // end of namespace bpp
+
+#endif // _GFFFEATUREWRITER_H_
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "GtfFeatureWriter.h"
+#include "GtfFeatureReader.h"
+
+using namespace bpp;
+using namespace std;
+
+void GtfFeatureWriter::appendAttribute_(const string& key, const string& value)
+{
+  buffer_.append(key);
+  buffer_.append(" \"");
+  buffer_.append(value);
+  buffer_.append("\"; ");
+}
+
+void GtfFeatureWriter::writeFeature(const SequenceFeature& feature)
+{
+  buffer_.append(feature.getSequenceId());
+  buffer_.push_back('\t');
+  buffer_.append(feature.getSource());
+  buffer_.push_back('\t');
+  buffer_.append(feature.getType());
+  buffer_.push_back('\t');
+  appendUnsigned_(feature.getStart() + 1);
+  buffer_.push_back('\t');
+  appendUnsigned_(feature.getEnd());
+  buffer_.push_back('\t');
+  appendDouble_(feature.getScore());
+  buffer_.push_back('\t');
+  appendStrand_(feature);
+  buffer_.push_back('\t');
+  const map<string, string>& attributes = getAttributes_(feature, tmpAttributes_);
+  auto phase = attributes.find(GtfFeatureReader::GTF_PHASE);
+  if (phase == attributes.end() || phase->second.empty())
+    buffer_.push_back('.');
+  else
+    buffer_.append(phase->second);
+  buffer_.push_back('\t');
+  size_t length = buffer_.size();
+  auto geneId = attributes.find(GtfFeatureReader::GTF_GENE_ID);
+  if (geneId != attributes.end())
+    appendAttribute_(geneId->first, geneId->second);
+  auto transcriptId = attributes.find(GtfFeatureReader::GTF_TRANSCRIPT_ID);
+  if (transcriptId != attributes.end())
+    appendAttribute_(transcriptId->first, transcriptId->second);
+  for (const auto& attribute : attributes)
+  {
+    if (attribute.first == GtfFeatureReader::GTF_PHASE
+        || attribute.first == GtfFeatureReader::GTF_GENE_ID
+        || attribute.first == GtfFeatureReader::GTF_TRANSCRIPT_ID)
+      continue;
+    appendAttribute_(attribute.first, attribute.second);
+  }
+  // Remove trailing space:
+  if (buffer_.size() > length)
+    buffer_.pop_back();
+  endLine_();
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _GTFFEATUREWRITER_H_
+#define _GTFFEATUREWRITER_H_
+
+#include "../FeatureWriter.h"
+
+// From the STL:
+#include <string>
+#include <map>
+
+namespace bpp
+{
+/**
+ * @brief A buffered writer for features in the GTF format.
+ *
+ * Lines are formatted in a reusable buffer and written by large chunks.
+ * The phase is taken from the GtfFeatureReader::GTF_PHASE attribute.
+ * All other attributes are written as 'key "value";', starting with
+ * GtfFeatureReader::GTF_GENE_ID and GtfFeatureReader::GTF_TRANSCRIPT_ID when present, as required by the format.
+ * Missing scores (NaN) are written as '.'.
+ */
+class GtfFeatureWriter :
+  public AbstractFeatureWriter
+{
+private:
+  std::map<std::string, std::string> tmpAttributes_;
+
+public:
+  /**
+   * @param output The output stream.
+   * @param bufferSize The number of characters to accumulate before writing to the stream.
+   */
+  GtfFeatureWriter(std::ostream& output, size_t bufferSize = 1048576) :
+    AbstractFeatureWriter(output, bufferSize), tmpAttributes_() {}
+
+  virtual ~GtfFeatureWriter() {}
+
+public:
+  void writeFeature(const SequenceFeature& feature);
+
+private:
+  void appendAttribute_(const std::string& key, const std::string& value);
+};
+} // end of namespace bpp
+
+#endif // _GTFFEATUREWRITER_H_
@@ -334,6 +334,11 @@ public:
     attributes_[attribute] = value;
   }
 
+  /**
+   * @return All attributes, sorted by name, without copy.
+   */
+  const std::map<std::string, std::string>& getAttributes() const { return attributes_; }
+
   std::set< std::string > getAttributeList() const
   {
     std::set< std::string > d;
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _BINARYIOTOOLS_H_
+#define _BINARYIOTOOLS_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace bpp
+{
+/**
+ * @brief Encoding and decoding of numbers in binary files.
+ *
+ * Numbers are written in little-endian order whatever the host, so that files can be shared between platforms.
+ * Encoding functions append bytes to a string used as a buffer.
+ */
+class BinaryIoTools
+{
+public:
+  static void putInteger(std::string& bytes, uint64_t x, size_t nbBytes)
+  {
+    for (size_t k = 0; k < nbBytes; ++k)
+    {
+      bytes.push_back(static_cast<char>((x >> (8 * k)) & 0xFF));
+    }
+  }
+
+  static void putFloat(std::string& bytes, float x)
+  {
+    uint32_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    putInteger(bytes, u, 4);
+  }
+
+  static void putDouble(std::string& bytes, double x)
+  {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    putInteger(bytes, u, 8);
+  }
+
+  /**
+   * @brief Write an integer with a variable number of bytes (LEB128), 7 bits per byte.
+   */
+  static void putVarint(std::string& bytes, uint64_t x)
+  {
+    while (x >= 0x80)
+    {
+      bytes.push_back(static_cast<char>((x & 0x7F) | 0x80));
+      x >>= 7;
+    }
+    bytes.push_back(static_cast<char>(x));
+  }
+
+  static uint64_t getInteger(const char* bytes, size_t nbBytes)
+  {
+    uint64_t x = 0;
+    for (size_t k = 0; k < nbBytes; ++k)
+    {
+      x |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[k])) << (8 * k);
+    }
+    return x;
+  }
+
+  static uint32_t getUInt32(const char* bytes)
+  {
+    return static_cast<uint32_t>(getInteger(bytes, 4));
+  }
+
+  static float getFloat(const char* bytes)
+  {
+    uint32_t u = getUInt32(bytes);
+    float x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+  }
+
+  static double getDouble(const char* bytes)
+  {
+    uint64_t u = getInteger(bytes, 8);
+    double x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+  }
+
+  /**
+   * @brief Read an integer written with putVarint.
+   *
+   * @param bytes The buffer, moved after the integer.
+   * @param end The end of the buffer.
+   */
+  static uint64_t getVarint(const char*& bytes, const char* end)
+  {
+    uint64_t x = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      if (bytes >= end)
+        throw Exception("BinaryIoTools::getVarint. Truncated buffer.");
+      unsigned char b = static_cast<unsigned char>(*bytes++);
+      x |= static_cast<uint64_t>(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        return x;
+    }
+    throw Exception("BinaryIoTools::getVarint. Invalid encoding.");
+  }
+
+  /**
+   * @brief Map signed integers to unsigned ones, so that small absolute values give small codes.
+   */
+  static uint64_t zigzagEncode(int64_t x)
+  {
+    return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+  }
+
+  static int64_t zigzagDecode(uint64_t x)
+  {
+    return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+  }
+};
+} // end of namespace bpp.
+
+#endif // _BINARYIOTOOLS_H_
@@ -3,9 +3,12 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "AbstractIterationListener.h"
+#include "../BinaryIoTools.h"
 
 // From the STL:
 #include <vector>
+#include <limits>
+#include <cmath>
 
 using namespace std;
 using namespace bpp;
@@ -42,3 +45,257 @@ void CsvStatisticsOutputIterationListener::iterationMoves(const MafBlock& curren
   }
   output_->endLine();
 }
+
+/******************************************************************************/
+
+double BinaryStatisticsOutputIterationListener::toDouble(const BppNumberI* value)
+{
+  if (!value)
+    return numeric_limits<double>::quiet_NaN();
+  if (auto d = dynamic_cast<const BppDouble*>(value))
+    return d->getValue();
+  if (auto i = dynamic_cast<const BppInteger*>(value))
+    return static_cast<double>(i->getValue());
+  if (auto u = dynamic_cast<const BppUnsignedInteger*>(value))
+    return static_cast<double>(u->getValue());
+  return numeric_limits<double>::quiet_NaN();
+}
+
+void BinaryStatisticsOutputIterationListener::write_(const string& bytes)
+{
+  output_->write(bytes.data(), static_cast<streamsize>(bytes.size()));
+  offset_ += bytes.size();
+}
+
+void BinaryStatisticsOutputIterationListener::iterationStarts()
+{
+  valueColumns_.assign(statsIterator_->getResultsColumnNames().size(), vector<double>());
+  for (auto& column : valueColumns_)
+  {
+    column.reserve(rowsPerGroup_);
+  }
+  chrColumn_.reserve(rowsPerGroup_);
+  startColumn_.reserve(rowsPerGroup_);
+  stopColumn_.reserve(rowsPerGroup_);
+  string header = "BPPSTATS";
+  BinaryIoTools::putInteger(header, 1, 4);
+  BinaryIoTools::putInteger(header, 0, 4); // Padding, for the alignment of chunks.
+  write_(header);
+}
+
+void BinaryStatisticsOutputIterationListener::iterationMoves(const MafBlock& currentBlock)
+{
+  uint32_t chrId = numeric_limits<uint32_t>::max();
+  uint64_t start = numeric_limits<uint64_t>::max();
+  uint64_t stop = numeric_limits<uint64_t>::max();
+  if (currentBlock.hasSequenceForSpecies(refSpecies_))
+  {
+    const auto& refSeq = currentBlock.sequenceForSpecies(refSpecies_);
+    if (refSeq.hasCoordinates())
+    {
+      auto it = chromosomeIds_.find(refSeq.getChromosome());
+      if (it == chromosomeIds_.end())
+      {
+        it = chromosomeIds_.emplace(refSeq.getChromosome(), static_cast<uint32_t>(chromosomes_.size())).first;
+        chromosomes_.push_back(refSeq.getChromosome());
+      }
+      chrId = it->second;
+      start = refSeq.start();
+      stop = refSeq.stop();
+    }
+  }
+  chrColumn_.push_back(chrId);
+  startColumn_.push_back(start);
+  stopColumn_.push_back(stop);
+  auto& values = statsIterator_->getResults();
+  for (size_t i = 0; i < valueColumns_.size(); ++i)
+  {
+    valueColumns_[i].push_back(i < values.size() ? toDouble(values[i].get()) : numeric_limits<double>::quiet_NaN());
+  }
+  if (chrColumn_.size() >= rowsPerGroup_)
+    writeRowGroup_();
+}
+
+void BinaryStatisticsOutputIterationListener::writeChunk_(const string& bytes, uint8_t encoding, RowGroup_& group)
+{
+  ColumnChunk_ chunk;
+  chunk.offset = offset_;
+  chunk.size = bytes.size();
+  chunk.encoding = encoding;
+  group.chunks.push_back(chunk);
+  write_(bytes);
+  // Align the next chunk on 8 bytes:
+  if (offset_ % 8 != 0)
+    write_(string(8 - offset_ % 8, '\0'));
+}
+
+void BinaryStatisticsOutputIterationListener::writeRowGroup_()
+{
+  size_t n = chrColumn_.size();
+  if (n == 0)
+    return;
+  RowGroup_ group;
+  group.nbRows = n;
+  string bytes;
+
+  // Integer columns:
+  auto writeIntegers = [&](const uint64_t* values, size_t nbBytes) {
+        bytes.clear();
+        if (compress_)
+        {
+          uint64_t previous = 0;
+          for (size_t i = 0; i < n; ++i)
+          {
+            // Differences are computed modulo 2^64, so that missing values are handled as any other:
+            BinaryIoTools::putVarint(bytes, BinaryIoTools::zigzagEncode(static_cast<int64_t>(values[i] - previous)));
+            previous = values[i];
+          }
+          writeChunk_(bytes, ENCODING_DELTA_VARINT, group);
+        }
+        else
+        {
+          bytes.reserve(n * nbBytes);
+          for (size_t i = 0; i < n; ++i)
+          {
+            BinaryIoTools::putInteger(bytes, values[i], nbBytes);
+          }
+          writeChunk_(bytes, ENCODING_PLAIN, group);
+        }
+      };
+  vector<uint64_t> chrIds(chrColumn_.begin(), chrColumn_.end());
+  writeIntegers(&chrIds[0], 4);
+  writeIntegers(&startColumn_[0], 8);
+  writeIntegers(&stopColumn_[0], 8);
+
+  // Statistics:
+  for (auto& column : valueColumns_)
+  {
+    bytes.clear();
+    bytes.reserve(n * 8);
+    for (double x : column)
+    {
+      BinaryIoTools::putDouble(bytes, x);
+    }
+    writeChunk_(bytes, ENCODING_PLAIN, group);
+    column.clear();
+  }
+  rowGroups_.push_back(group);
+  chrColumn_.clear();
+  startColumn_.clear();
+  stopColumn_.clear();
+}
+
+void BinaryStatisticsOutputIterationListener::iterationStops()
+{
+  writeRowGroup_();
+
+  // Footer:
+  uint64_t footerOffset = offset_;
+  string bytes;
+  const vector<string>& names = statsIterator_->getResultsColumnNames();
+  auto putString = [&bytes](const string& str) {
+        BinaryIoTools::putInteger(bytes, str.size(), 4);
+        bytes += str;
+      };
+  BinaryIoTools::putInteger(bytes, names.size() + 3, 4);
+  putString("Chr");
+  bytes.push_back(static_cast<char>(TYPE_DICTIONARY));
+  putString("Start");
+  bytes.push_back(static_cast<char>(TYPE_UINT64));
+  putString("Stop");
+  bytes.push_back(static_cast<char>(TYPE_UINT64));
+  for (const auto& name : names)
+  {
+    putString(name);
+    bytes.push_back(static_cast<char>(TYPE_DOUBLE));
+  }
+  BinaryIoTools::putInteger(bytes, chromosomes_.size(), 4);
+  for (const auto& chr : chromosomes_)
+  {
+    putString(chr);
+  }
+  BinaryIoTools::putInteger(bytes, rowGroups_.size(), 8);
+  for (const auto& group : rowGroups_)
+  {
+    BinaryIoTools::putInteger(bytes, group.nbRows, 8);
+    for (const auto& chunk : group.chunks)
+    {
+      BinaryIoTools::putInteger(bytes, chunk.offset, 8);
+      BinaryIoTools::putInteger(bytes, chunk.size, 8);
+      bytes.push_back(static_cast<char>(chunk.encoding));
+    }
+  }
+  BinaryIoTools::putInteger(bytes, footerOffset, 8);
+  bytes += "BPPSTEND";
+  write_(bytes);
+  output_->flush();
+  rowGroups_.clear();
+}
+
+/******************************************************************************/
+
+void BootstrapStatisticsOutputIterationListener::iterationStarts()
+{
+  bootstrap_.reset(new PoissonBootstrap(nbReplicates_, statsIterator_->getResultsColumnNames().size(), seed_));
+  values_.resize(bootstrap_->getNumberOfStatistics());
+}
+
+void BootstrapStatisticsOutputIterationListener::iterationMoves(const MafBlock& currentBlock)
+{
+  auto& values = statsIterator_->getResults();
+  for (size_t i = 0; i < values_.size(); ++i)
+  {
+    values_[i] = i < values.size() ? BinaryStatisticsOutputIterationListener::toDouble(values[i].get()) : numeric_limits<double>::quiet_NaN();
+  }
+  bootstrap_->add(values_);
+}
+
+void BootstrapStatisticsOutputIterationListener::iterationStops()
+{
+  if (!bootstrap_)
+    return;
+  const vector<string>& names = statsIterator_->getResultsColumnNames();
+  *output_ << "Statistic" << sep_ << "NbBlocks" << sep_ << "Sum" << sep_ << "SumLower" << sep_ << "SumUpper";
+  *output_ << sep_ << "Mean" << sep_ << "MeanLower" << sep_ << "MeanUpper";
+  output_->endLine();
+  vector<double> replicates;
+  double lower, upper;
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    double mean = bootstrap_->getObservedMean(i);
+    *output_ << names[i] << sep_ << bootstrap_->getObservedCount(i) << sep_ << bootstrap_->getObservedSum(i);
+    bootstrap_->getReplicateSums(i, replicates);
+    PoissonBootstrap::getPercentileInterval(replicates, level_, lower, upper);
+    *output_ << sep_ << lower << sep_ << upper;
+    bootstrap_->getReplicateMeans(i, replicates);
+    PoissonBootstrap::getPercentileInterval(replicates, level_, lower, upper);
+    *output_ << sep_ << (std::isnan(mean) ? "NA" : TextTools::toString(mean));
+    *output_ << sep_ << (std::isnan(lower) ? "NA" : TextTools::toString(lower));
+    *output_ << sep_ << (std::isnan(upper) ? "NA" : TextTools::toString(upper));
+    output_->endLine();
+  }
+
+  if (replicatesOutput_)
+  {
+    *replicatesOutput_ << "Replicate";
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      *replicatesOutput_ << sep_ << names[i];
+    }
+    replicatesOutput_->endLine();
+    vector< vector<double> > sums(names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      bootstrap_->getReplicateSums(i, sums[i]);
+    }
+    for (size_t r = 0; r < nbReplicates_; ++r)
+    {
+      *replicatesOutput_ << (r + 1);
+      for (size_t i = 0; i < names.size(); ++i)
+      {
+        *replicatesOutput_ << sep_ << sums[i][r];
+      }
+      replicatesOutput_->endLine();
+    }
+  }
+}
@@ -7,6 +7,12 @@
 
 #include "MafIterator.h"
 #include "SequenceStatisticsMafIterator.h"
+#include "PoissonBootstrap.h"
+
+// From the STL:
+#include <iostream>
+#include <map>
+#include <cstdint>
 
 namespace bpp
 {
@@ -76,6 +82,199 @@ public:
   virtual void iterationMoves(const MafBlock& currentBlock);
   virtual void iterationStops() {}
 };
+
+/**
+ * @brief Iteration listener that works with a SequenceStatisticsMafIterator,
+ * enabling output of results in a binary, column-oriented file.
+ *
+ * The file contains the same columns as the CSV output: the chromosome, start and stop of the reference sequence,
+ * then one column per statistic. Rows are stored in row groups, and each row group contains one chunk per column.
+ * Chromosomes are stored as 32 bits identifiers in a dictionary, coordinates as 64 bits integers, and statistics as doubles.
+ * Missing values are stored as the largest integer value for identifiers and coordinates, and as NaN for statistics.
+ * If compression is enabled, chromosome and coordinate chunks are delta-encoded with variable-length integers,
+ * which typically reduces them to one or two bytes per row. Statistics are always stored as plain doubles.
+ *
+ * The file starts with the 8 characters "BPPSTATS" and the format version, and ends with a footer holding the schema,
+ * the chromosome dictionary and the location of each chunk, followed by the offset of the footer and the 8 characters "BPPSTEND".
+ * All numbers are little-endian, and chunks are aligned on 8 bytes. See StatisticsTableReader.
+ *
+ * Only the current row group is kept in memory. The footer is written when the iteration stops.
+ */
+class BinaryStatisticsOutputIterationListener :
+  public AbstractStatisticsOutputIterationListener
+{
+public:
+  static constexpr uint8_t ENCODING_PLAIN = 0;
+  static constexpr uint8_t ENCODING_DELTA_VARINT = 1;
+
+  static constexpr uint8_t TYPE_DICTIONARY = 0;
+  static constexpr uint8_t TYPE_UINT64 = 1;
+  static constexpr uint8_t TYPE_DOUBLE = 2;
+
+private:
+  struct ColumnChunk_
+  {
+    uint64_t offset;
+    uint64_t size;
+    uint8_t encoding;
+  };
+
+  struct RowGroup_
+  {
+    uint64_t nbRows;
+    std::vector<ColumnChunk_> chunks;
+
+    RowGroup_() : nbRows(0), chunks() {}
+  };
+
+private:
+  std::shared_ptr<std::ostream> output_;
+  std::string refSpecies_;
+  size_t rowsPerGroup_;
+  bool compress_;
+  std::vector<std::string> chromosomes_;
+  std::map<std::string, uint32_t> chromosomeIds_;
+  std::vector<uint32_t> chrColumn_;
+  std::vector<uint64_t> startColumn_;
+  std::vector<uint64_t> stopColumn_;
+  std::vector< std::vector<double> > valueColumns_;
+  std::vector<RowGroup_> rowGroups_;
+  uint64_t offset_;
+
+public:
+  /**
+   * @param iterator The statistics iterator.
+   * @param refSpecies The species to use for coordinates.
+   * @param output The output stream, which should be opened in binary mode.
+   * @param rowsPerGroup The number of rows in each row group.
+   * @param compress Tell if chromosome and coordinate columns should be delta-encoded.
+   */
+  BinaryStatisticsOutputIterationListener(
+      std::shared_ptr<SequenceStatisticsMafIterator> iterator,
+      const std::string& refSpecies,
+      std::shared_ptr<std::ostream> output,
+      size_t rowsPerGroup = 65536,
+      bool compress = true) :
+    AbstractStatisticsOutputIterationListener(iterator),
+    output_(output),
+    refSpecies_(refSpecies),
+    rowsPerGroup_(rowsPerGroup > 0 ? rowsPerGroup : 1),
+    compress_(compress),
+    chromosomes_(),
+    chromosomeIds_(),
+    chrColumn_(),
+    startColumn_(),
+    stopColumn_(),
+    valueColumns_(),
+    rowGroups_(),
+    offset_(0)
+  {}
+
+private:
+  BinaryStatisticsOutputIterationListener(const BinaryStatisticsOutputIterationListener& listener) = delete;
+  BinaryStatisticsOutputIterationListener& operator=(const BinaryStatisticsOutputIterationListener& listener) = delete;
+
+public:
+  virtual ~BinaryStatisticsOutputIterationListener() {}
+
+public:
+  virtual void iterationStarts();
+  virtual void iterationMoves(const MafBlock& currentBlock);
+  virtual void iterationStops();
+
+  /**
+   * @return The value of a statistic as a double, or NaN if it is missing or not a number.
+   */
+  static double toDouble(const BppNumberI* value);
+
+private:
+  void writeRowGroup_();
+
+  void writeChunk_(const std::string& bytes, uint8_t encoding, RowGroup_& group);
+
+  void write_(const std::string& bytes);
+};
+/**
+ * @brief Iteration listener that works with a SequenceStatisticsMafIterator,
+ * enabling bootstrap confidence intervals on genome-wide sums and means of the statistics.
+ *
+ * Each block is a resampling unit: to bootstrap over genomic windows, use a WindowSplitMafIterator upstream.
+ * All replicates are computed in a single pass, using a PoissonBootstrap object.
+ * Sums are meaningful for additive statistics (counts of sites, patterns or frequency spectrum bins),
+ * means for statistics which are averaged over blocks.
+ *
+ * When the iteration stops, a table is written with one row per statistic and the following columns:
+ * Statistic, NbBlocks (the number of blocks with a value), Sum, SumLower, SumUpper, Mean, MeanLower, MeanUpper.
+ * Optionally, the replicate distributions of the sums are written in a second table,
+ * with one row per replicate and one column per statistic.
+ */
+class BootstrapStatisticsOutputIterationListener :
+  public AbstractStatisticsOutputIterationListener
+{
+private:
+  std::shared_ptr<OutputStream> output_;
+  std::shared_ptr<OutputStream> replicatesOutput_;
+  size_t nbReplicates_;
+  double level_;
+  uint64_t seed_;
+  std::string sep_;
+  std::unique_ptr<PoissonBootstrap> bootstrap_;
+  std::vector<double> values_;
+
+public:
+  /**
+   * @param iterator The statistics iterator.
+   * @param output The output stream for the confidence intervals.
+   * @param nbReplicates The number of bootstrap replicates.
+   * @param level The confidence level of the percentile intervals.
+   * @param seed The seed of the random number generator.
+   * @param replicatesOutput The output stream for the replicate distributions (none if nullptr).
+   * @param sep The column separator.
+   */
+  BootstrapStatisticsOutputIterationListener(
+      std::shared_ptr<SequenceStatisticsMafIterator> iterator,
+      std::shared_ptr<OutputStream> output,
+      size_t nbReplicates = 1000,
+      double level = 0.95,
+      uint64_t seed = 0,
+      std::shared_ptr<OutputStream> replicatesOutput = nullptr,
+      const std::string& sep = "\t") :
+    AbstractStatisticsOutputIterationListener(iterator),
+    output_(output),
+    replicatesOutput_(replicatesOutput),
+    nbReplicates_(nbReplicates),
+    level_(level),
+    seed_(seed),
+    sep_(sep),
+    bootstrap_(),
+    values_()
+  {
+    if (level <= 0. || level >= 1.)
+      throw Exception("BootstrapStatisticsOutputIterationListener. The confidence level should be strictly between 0 and 1.");
+  }
+
+private:
+  BootstrapStatisticsOutputIterationListener(const BootstrapStatisticsOutputIterationListener& listener) = delete;
+  BootstrapStatisticsOutputIterationListener& operator=(const BootstrapStatisticsOutputIterationListener& listener) = delete;
+
+public:
+  virtual ~BootstrapStatisticsOutputIterationListener() {}
+
+public:
+  virtual void iterationStarts();
+  virtual void iterationMoves(const MafBlock& currentBlock);
+  virtual void iterationStops();
+
+  /**
+   * @return The bootstrap accumulator, available once the iteration has started.
+   */
+  const PoissonBootstrap& getBootstrap() const
+  {
+    if (!bootstrap_)
+      throw Exception("BootstrapStatisticsOutputIterationListener::getBootstrap. Iteration has not started.");
+    return *bootstrap_;
+  }
+};
 } // end of namespace bpp.
 
 #endif // _ABSTRACTITERATIONLISTENER_H_
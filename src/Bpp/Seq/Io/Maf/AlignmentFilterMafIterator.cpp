@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "AlignmentFilterMafIterator.h"
+#include "GappedRow.h"
 
 using namespace bpp;
 
@@ -31,20 +32,17 @@ unique_ptr<MafBlock> AlignmentFilterMafIterator::analyseCurrentBlock_()
       if (nc < windowSize_)
         throw Exception("AlignmentFilterMafIterator::analyseCurrentBlock_. Block is smaller than window size: " + TextTools::toString(nc));
 
-      vector< vector<int>> aln;
+      vector<GappedRow> aln;
       if (missingAsGap_)
       {
         nr = species_.size();
-        aln.resize(nr);
+        aln.reserve(nr);
         for (size_t i = 0; i < nr; ++i)
         {
           if (block->hasSequenceForSpecies(species_[i]))
-            aln[i] = block->sequenceForSpecies(species_[i]).getContent();
+            aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
           else
-          {
-            aln[i].resize(nc);
-            fill(aln[i].begin(), aln[i].end(), gap);
-          }
+            aln.push_back(GappedRow(nc)); // Virtual all-gap row, nothing is allocated.
         }
       }
       else
@@ -54,7 +52,7 @@ unique_ptr<MafBlock> AlignmentFilterMafIterator::analyseCurrentBlock_()
         {
           if (block->hasSequenceForSpecies(species_[i]))
           {
-            aln.push_back(block->sequenceForSpecies(species_[i]).getContent());
+            aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
           }
           else
           {
@@ -317,20 +315,17 @@ unique_ptr<MafBlock> AlignmentFilter2MafIterator::analyseCurrentBlock_()
       if (nc < windowSize_)
         throw Exception("AlignmentFilter2MafIterator::analyseCurrentBlock_. Block is smaller than window size: " + TextTools::toString(nc));
 
-      vector< vector<int>> aln;
+      vector<GappedRow> aln;
       if (missingAsGap_)
       {
         nr = species_.size();
-        aln.resize(nr);
+        aln.reserve(nr);
         for (size_t i = 0; i < nr; ++i)
         {
           if (block->hasSequenceForSpecies(species_[i]))
-            aln[i] = block->sequenceForSpecies(species_[i]).getContent();
+            aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
           else
-          {
-            aln[i].resize(nc);
-            fill(aln[i].begin(), aln[i].end(), gap);
-          }
+            aln.push_back(GappedRow(nc)); // Virtual all-gap row, nothing is allocated.
         }
       }
       else
@@ -340,7 +335,7 @@ unique_ptr<MafBlock> AlignmentFilter2MafIterator::analyseCurrentBlock_()
         {
           if (block->hasSequenceForSpecies(species_[i]))
           {
-            aln.push_back(block->sequenceForSpecies(species_[i]).getContent());
+            aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
           }
           else
           {
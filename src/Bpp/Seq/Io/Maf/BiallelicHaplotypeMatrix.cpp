@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "BiallelicHaplotypeMatrix.h"
+#include "DnaTraits.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <cmath>
+
+using namespace std;
+
+void BiallelicHaplotypeMatrix::build(const vector<const MafSequence*>& haplotypes, const MafSequence* reference)
+{
+  nbHaplotypes_ = haplotypes.size();
+  nbWords_ = BitTools::getNumberOfWords(nbHaplotypes_);
+  positions_.clear();
+  alleles_.clear();
+  masks_.clear();
+  if (nbHaplotypes_ < 2)
+    return;
+
+  size_t nbColumns = haplotypes[0]->size();
+  size_t refPos = (reference && reference->hasCoordinates()) ? reference->start() : 0;
+  vector<uint64_t> a(nbWords_);
+  vector<uint64_t> m(nbWords_);
+  AlphabetTraitsTools::dispatch(*haplotypes[0]->getAlphabet(), [&](const auto& traits) {
+        for (size_t i = 0; i < nbColumns; ++i)
+        {
+          size_t pos = i;
+          if (reference)
+          {
+            if (traits.isGap((*reference)[i]))
+              continue;
+            pos = refPos++;
+          }
+          fill(a.begin(), a.end(), 0);
+          fill(m.begin(), m.end(), 0);
+          int allele0 = -1;
+          int allele1 = -1;
+          bool isBiallelic = true;
+          for (size_t h = 0; isBiallelic && h < nbHaplotypes_; ++h)
+          {
+            int x = (*haplotypes[h])[i];
+            if (!traits.isResolved(x))
+              continue;
+            BitTools::setBit(&m[0], h);
+            if (allele0 == -1 || x == allele0)
+            {
+              allele0 = x;
+            }
+            else if (allele1 == -1 || x == allele1)
+            {
+              allele1 = x;
+              BitTools::setBit(&a[0], h);
+            }
+            else
+            {
+              isBiallelic = false; // Third allele found.
+            }
+          }
+          if (isBiallelic && allele1 != -1)
+          {
+            positions_.push_back(pos);
+            alleles_.insert(alleles_.end(), a.begin(), a.end());
+            masks_.insert(masks_.end(), m.begin(), m.end());
+          }
+        }
+      });
+}
+
+bool BiallelicHaplotypeMatrix::computeLinkageDisequilibrium(size_t i, size_t j, PairwiseLinkageDisequilibrium& ld) const
+{
+  const uint64_t* ai = &alleles_[i * nbWords_];
+  const uint64_t* aj = &alleles_[j * nbWords_];
+  const uint64_t* mi = &masks_[i * nbWords_];
+  const uint64_t* mj = &masks_[j * nbWords_];
+  unsigned int n = 0, nA = 0, nB = 0, nAB = 0;
+  for (size_t w = 0; w < nbWords_; ++w)
+  {
+    uint64_t m = mi[w] & mj[w];
+    uint64_t x = ai[w] & m;
+    uint64_t y = aj[w] & m;
+    n   += BitTools::popCount(m);
+    nA  += BitTools::popCount(x);
+    nB  += BitTools::popCount(y);
+    nAB += BitTools::popCount(x & y);
+  }
+  // Both sites have to be variable in the shared haplotypes:
+  if (nA == 0 || nA == n || nB == 0 || nB == n)
+    return false;
+  double dn = static_cast<double>(n);
+  double pA = static_cast<double>(nA) / dn;
+  double pB = static_cast<double>(nB) / dn;
+  double pAB = static_cast<double>(nAB) / dn;
+  double d = pAB - pA * pB;
+  double dMax = (d < 0) ?
+                min(pA * pB, (1. - pA) * (1. - pB)) :
+                min(pA * (1. - pB), (1. - pA) * pB);
+  ld.n = n;
+  ld.d = d;
+  ld.r2 = d * d / (pA * (1. - pA) * pB * (1. - pB));
+  ld.dPrime = dMax > 0 ? abs(d) / dMax : 0.;
+  return true;
+}
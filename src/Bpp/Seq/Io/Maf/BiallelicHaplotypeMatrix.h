@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _BIALLELICHAPLOTYPEMATRIX_H_
+#define _BIALLELICHAPLOTYPEMATRIX_H_
+
+#include "MafSequence.h"
+#include "BitTools.h"
+
+// From the STL:
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief Linkage disequilibrium measures for a pair of sites.
+ */
+struct PairwiseLinkageDisequilibrium
+{
+  /**
+   * @brief Number of haplotypes with data at both sites.
+   */
+  unsigned int n;
+  double d;
+  double r2;
+  double dPrime;
+
+  PairwiseLinkageDisequilibrium() : n(0), d(0), r2(0), dPrime(0) {}
+};
+
+/**
+ * @brief Bit-packed storage of the biallelic sites of an alignment block.
+ *
+ * Each biallelic site is stored as two bit vectors with one bit per haplotype (sequence):
+ * the first one tells which haplotypes carry the second allele, and the second one
+ * tells which haplotypes have data (no gap, no unresolved character).
+ * Pairwise linkage disequilibrium is then computed with word-level logical operations and population counts.
+ *
+ * The first allele met in a column (in sequence order) is coded 0, the second 1.
+ * Columns with more than two alleles or only one allele are discarded.
+ *
+ * @author Julien Dutheil
+ */
+class BiallelicHaplotypeMatrix
+{
+private:
+  size_t nbHaplotypes_;
+  size_t nbWords_;
+  std::vector<size_t> positions_;
+  std::vector<uint64_t> alleles_;
+  std::vector<uint64_t> masks_;
+
+public:
+  BiallelicHaplotypeMatrix() :
+    nbHaplotypes_(0),
+    nbWords_(0),
+    positions_(),
+    alleles_(),
+    masks_()
+  {}
+
+  virtual ~BiallelicHaplotypeMatrix() {}
+
+public:
+  /**
+   * @brief Extract all biallelic sites from a set of aligned sequences.
+   *
+   * Any previous content is discarded.
+   *
+   * @param haplotypes The aligned sequences to use, all of the same length.
+   * @param reference [optional] A reference sequence used to compute site positions.
+   * If provided, columns where the reference has a gap are ignored, and positions are given
+   * in the reference coordinates. Otherwise, positions are column indices.
+   */
+  void build(const std::vector<const MafSequence*>& haplotypes, const MafSequence* reference = nullptr);
+
+  size_t getNumberOfHaplotypes() const { return nbHaplotypes_; }
+
+  size_t getNumberOfSites() const { return positions_.size(); }
+
+  size_t getPosition(size_t i) const { return positions_[i]; }
+
+  /**
+   * @brief Compute linkage disequilibrium between two sites.
+   *
+   * Only haplotypes with data at both sites are considered.
+   *
+   * @param i The index of the first site.
+   * @param j The index of the second site.
+   * @param ld The structure where to store the results.
+   * @return False if LD could not be computed, for instance if one of the sites is not variable
+   * in the set of haplotypes with data at both sites.
+   */
+  bool computeLinkageDisequilibrium(size_t i, size_t j, PairwiseLinkageDisequilibrium& ld) const;
+
+  /**
+   * @brief Compute linkage disequilibrium for all pairs of sites within a maximum distance.
+   *
+   * Sites are processed by tiles, so that the bit vectors of both tiles remain in cache.
+   * Tiles are independent of each other. For each pair with a defined LD, the
+   * functor f(i, j, ld) is called, with i < j.
+   *
+   * @param maxDistance The maximum distance between two sites.
+   * @param f The functor to call on each pair.
+   * @param tileSize The number of sites per tile.
+   */
+  template<class Functor>
+  void computeAllPairs(size_t maxDistance, Functor& f, size_t tileSize = 64) const
+  {
+    size_t n = getNumberOfSites();
+    PairwiseLinkageDisequilibrium ld;
+    for (size_t ti = 0; ti < n; ti += tileSize)
+    {
+      size_t tiEnd = std::min(ti + tileSize, n);
+      // Last site within reach of the last site of the tile:
+      size_t jEnd = tiEnd;
+      while (jEnd < n && positions_[jEnd] - positions_[tiEnd - 1] <= maxDistance)
+      {
+        ++jEnd;
+      }
+      for (size_t tj = ti; tj < jEnd; tj += tileSize)
+      {
+        size_t tjEnd = std::min(tj + tileSize, jEnd);
+        for (size_t i = ti; i < tiEnd; ++i)
+        {
+          for (size_t j = std::max(i + 1, tj); j < tjEnd; ++j)
+          {
+            if (positions_[j] - positions_[i] > maxDistance)
+              break;
+            if (computeLinkageDisequilibrium(i, j, ld))
+              f(i, j, ld);
+          }
+        }
+      }
+    }
+  }
+};
+} // end of namespace bpp.
+
+#endif // _BIALLELICHAPLOTYPEMATRIX_H_
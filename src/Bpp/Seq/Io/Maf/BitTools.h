@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _BITTOOLS_H_
+#define _BITTOOLS_H_
+
+// From the STL:
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace bpp
+{
+/**
+ * @brief Low-level utilitary functions on 64 bits words, used by bit-packed data structures.
+ *
+ * Compiler intrinsics are used when available, with a portable fallback otherwise.
+ *
+ * @author Julien Dutheil
+ */
+class BitTools
+{
+public:
+  /**
+   * @return The number of words needed to store n bits.
+   * @param n The number of bits.
+   */
+  static size_t getNumberOfWords(size_t n) { return (n + 63) / 64; }
+
+  /**
+   * @return The number of bits set in a word.
+   * @param x The input word.
+   */
+  static unsigned int popCount(uint64_t x)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+  }
+
+  /**
+   * @return The index of the lowest bit set in a word.
+   * @param x The input word, which must not be null.
+   */
+  static unsigned int countTrailingZeros(uint64_t x)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctzll(x));
+#else
+    unsigned int n = 0;
+    while (!(x & 1ULL))
+    {
+      x >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  /**
+   * @brief Set a bit in a bit vector.
+   *
+   * @param words The bit vector.
+   * @param i The index of the bit to set.
+   */
+  static void setBit(uint64_t* words, size_t i)
+  {
+    words[i >> 6] |= (1ULL << (i & 63));
+  }
+
+  /**
+   * @return True if a bit is set in a bit vector.
+   * @param words The bit vector.
+   * @param i The index of the bit to test.
+   */
+  static bool testBit(const uint64_t* words, size_t i)
+  {
+    return (words[i >> 6] >> (i & 63)) & 1ULL;
+  }
+
+  /**
+   * @return The number of bits set in a range of a bit vector.
+   * @param words The bit vector.
+   * @param begin The first bit of the range.
+   * @param end The bit after the last bit of the range.
+   */
+  static size_t countBits(const uint64_t* words, size_t begin, size_t end)
+  {
+    size_t n = 0;
+    for (size_t i = begin; i < end; )
+    {
+      size_t w = i >> 6;
+      size_t b = i & 63;
+      size_t len = std::min(static_cast<size_t>(64) - b, end - i);
+      uint64_t mask = (len == 64 ? ~0ULL : ((1ULL << len) - 1)) << b;
+      n += popCount(words[w] & mask);
+      i += len;
+    }
+    return n;
+  }
+
+  /**
+   * @return The index of the first bit set at or after a given position, or the size of the bit vector if there is none.
+   * @param words The bit vector.
+   * @param nbBits The size of the bit vector.
+   * @param from The position where to start the search.
+   */
+  static size_t findNextSetBit(const uint64_t* words, size_t nbBits, size_t from)
+  {
+    if (from >= nbBits)
+      return nbBits;
+    size_t w = from >> 6;
+    uint64_t x = words[w] & (~0ULL << (from & 63));
+    size_t nbWords = getNumberOfWords(nbBits);
+    while (x == 0)
+    {
+      if (++w >= nbWords)
+        return nbBits;
+      x = words[w];
+    }
+    return std::min((w << 6) + countTrailingZeros(x), nbBits);
+  }
+
+  /**
+   * @return The index of the first bit not set at or after a given position, or the size of the bit vector if there is none.
+   * @param words The bit vector.
+   * @param nbBits The size of the bit vector.
+   * @param from The position where to start the search.
+   */
+  static size_t findNextClearBit(const uint64_t* words, size_t nbBits, size_t from)
+  {
+    if (from >= nbBits)
+      return nbBits;
+    size_t w = from >> 6;
+    uint64_t x = ~words[w] & (~0ULL << (from & 63));
+    size_t nbWords = getNumberOfWords(nbBits);
+    while (x == 0)
+    {
+      if (++w >= nbWords)
+        return nbBits;
+      x = ~words[w];
+    }
+    return std::min((w << 6) + countTrailingZeros(x), nbBits);
+  }
+};
+} // end of namespace bpp.
+
+#endif // _BITTOOLS_H_
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "CatalogMafIterator.h"
+
+using namespace bpp;
+
+using namespace std;
+
+unique_ptr<MafBlock> CatalogMafIterator::analyseCurrentBlock_()
+{
+  while (true)
+  {
+    if (parser_)
+    {
+      auto block = parser_->nextBlock();
+      if (block)
+        return block;
+      parser_.reset();
+    }
+    if (currentEntry_ >= selection_.size())
+      return nullptr;
+
+    // Read the next run of consecutive selected blocks at once, within the read size limit:
+    const MafCatalog::Entry& first = catalog_->getEntry(selection_[currentEntry_]);
+    uint64_t end = first.offset + first.byteLength;
+    size_t next = currentEntry_ + 1;
+    while (next < selection_.size() && selection_[next] == selection_[next - 1] + 1)
+    {
+      const MafCatalog::Entry& entry = catalog_->getEntry(selection_[next]);
+      if (entry.offset + entry.byteLength - first.offset > maxReadSize_)
+        break;
+      end = entry.offset + entry.byteLength;
+      next++;
+    }
+    currentEntry_ = next;
+
+    string buffer(static_cast<size_t>(end - first.offset), '\0');
+    input_->clear();
+    input_->seekg(origin_ + static_cast<streamoff>(first.offset));
+    input_->read(&buffer[0], static_cast<streamsize>(buffer.size()));
+    if (static_cast<size_t>(input_->gcount()) != buffer.size())
+      throw IOException("CatalogMafIterator::nextBlock. Unexpected end of file, the catalog does not match the input.");
+    if (buffer[0] != 'a')
+      throw IOException("CatalogMafIterator::nextBlock. No block found at offset " + TextTools::toString(first.offset) + ", the catalog does not match the input.");
+    parser_.reset(new MafParser(make_shared<istringstream>(buffer), parseMask_, checkSize_, dotOption_));
+  }
+}
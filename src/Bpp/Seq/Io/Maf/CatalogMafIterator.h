@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _CATALOGMAFITERATOR_H_
+#define _CATALOGMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+#include "MafCatalog.h"
+#include "MafParser.h"
+
+// From the STL:
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace bpp
+{
+/**
+ * @brief A MafIterator returning only the blocks of a MAF file selected by a catalog query.
+ *
+ * The query is evaluated on the catalog, and only the selected blocks are read and parsed.
+ * Consecutive selected blocks are read together, up to a maximum number of bytes per read,
+ * and other blocks are skipped by seeking in the input, which must then be a seekable stream,
+ * positioned as it was when the catalog was built. A block larger than the maximum read size is read on its own.
+ *
+ * The result is the same as parsing the whole file and applying the equivalent filters
+ * (SequenceFilterMafIterator, ChromosomeMafIterator, BlockLengthMafIterator, BlockSizeMafIterator),
+ * except that sequences are not removed: a block is either returned entirely or skipped.
+ */
+class CatalogMafIterator :
+  public AbstractMafIterator
+{
+public:
+  static constexpr size_t DEFAULT_MAX_READ_SIZE = 4194304;
+
+private:
+  std::shared_ptr<std::istream> input_;
+  std::shared_ptr<const MafCatalog> catalog_;
+  std::vector<size_t> selection_;
+  size_t currentEntry_;
+  std::streamoff origin_;
+  bool parseMask_;
+  bool checkSize_;
+  short dotOption_;
+  size_t maxReadSize_;
+  std::unique_ptr<MafParser> parser_;
+
+public:
+  /**
+   * @brief Build a new CatalogMafIterator object.
+   *
+   * @param input The MAF stream the catalog was built from.
+   * @param catalog The catalog of the input.
+   * @param query The selection criteria.
+   * @param parseMask, checkSize, dotOption Options passed to the underlying MafParser.
+   * @param maxReadSize The maximum number of bytes read at once when consecutive blocks are selected.
+   */
+  CatalogMafIterator(
+      std::shared_ptr<std::istream> input,
+      std::shared_ptr<const MafCatalog> catalog,
+      const MafCatalogQuery& query,
+      bool parseMask = false,
+      bool checkSize = true,
+      short dotOption = MafParser::DOT_ERROR,
+      size_t maxReadSize = DEFAULT_MAX_READ_SIZE) :
+    input_(input),
+    catalog_(catalog),
+    selection_(catalog->select(query)),
+    currentEntry_(0),
+    origin_(input->tellg()),
+    parseMask_(parseMask),
+    checkSize_(checkSize),
+    dotOption_(dotOption),
+    maxReadSize_(maxReadSize),
+    parser_()
+  {
+    if (origin_ < 0)
+      throw Exception("CatalogMafIterator. The input stream must be seekable.");
+  }
+
+private:
+  CatalogMafIterator(const CatalogMafIterator&) = delete;
+  CatalogMafIterator& operator=(const CatalogMafIterator&) = delete;
+
+public:
+  /**
+   * @return The number of blocks selected by the query.
+   */
+  size_t getNumberOfSelectedBlocks() const { return selection_.size(); }
+
+private:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_();
+};
+} // end of namespace bpp.
+
+#endif // _CATALOGMAFITERATOR_H_
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ChainOutputMafIterator.h"
+#include "BitTools.h"
+#include "DnaTraits.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+void ChainOutputMafIterator::addBlock_(const MafBlock& block)
+{
+  if (!block.hasSequenceForSpecies(refSpecies_) || !block.hasSequenceForSpecies(querySpecies_))
+    return;
+  const MafSequence& tSeq = block.sequenceForSpecies(refSpecies_);
+  const MafSequence& qSeq = block.sequenceForSpecies(querySpecies_);
+  if (!tSeq.hasCoordinates() || !qSeq.hasCoordinates())
+    throw Exception("ChainOutputMafIterator::addBlock_. Sequences must have coordinates: " + block.getDescription() + ".");
+  size_t n = block.getNumberOfSites();
+
+  // Gap and aligned positions as bit vectors:
+  size_t nbWords = BitTools::getNumberOfWords(n);
+  tGaps_.assign(nbWords, 0);
+  qGaps_.assign(nbWords, 0);
+  aligned_.assign(nbWords, 0);
+  const vector<int>& t = tSeq.getContent();
+  const vector<int>& q = qSeq.getContent();
+  for (size_t j = 0; j < n; ++j)
+  {
+    bool gt = DnaTraits::isGap(t[j]);
+    bool gq = DnaTraits::isGap(q[j]);
+    if (gt)
+      BitTools::setBit(&tGaps_[0], j);
+    if (gq)
+      BitTools::setBit(&qGaps_[0], j);
+    if (!gt && !gq)
+      BitTools::setBit(&aligned_[0], j);
+  }
+
+  // Ungapped segments are runs of aligned positions:
+  size_t a = n > 0 ? BitTools::findNextSetBit(&aligned_[0], n, 0) : n;
+  if (a >= n)
+    return; // Nothing aligned in this block.
+  size_t leadT = a - BitTools::countBits(&tGaps_[0], 0, a);
+  size_t leadQ = a - BitTools::countBits(&qGaps_[0], 0, a);
+  size_t b = a;
+  blockSegments_.clear();
+  while (a < n)
+  {
+    b = BitTools::findNextClearBit(&aligned_[0], n, a);
+    Segment_ segment(b - a);
+    size_t next = BitTools::findNextSetBit(&aligned_[0], n, b);
+    if (next < n)
+    {
+      segment.dt = (next - b) - BitTools::countBits(&tGaps_[0], b, next);
+      segment.dq = (next - b) - BitTools::countBits(&qGaps_[0], b, next);
+    }
+    blockSegments_.push_back(segment);
+    a = next;
+  }
+  size_t trailT = (n - b) - BitTools::countBits(&tGaps_[0], b, n);
+  size_t trailQ = (n - b) - BitTools::countBits(&qGaps_[0], b, n);
+
+  // Put the target on the positive strand if needed.
+  // When the segments are reversed, each gap follows the segment which preceded it:
+  bool reversed = (tSeq.getStrand() == '-');
+  if (reversed)
+  {
+    size_t m = blockSegments_.size();
+    reverse(blockSegments_.begin(), blockSegments_.end());
+    for (size_t i = 0; i + 1 < m; ++i)
+    {
+      blockSegments_[i].dt = blockSegments_[i + 1].dt;
+      blockSegments_[i].dq = blockSegments_[i + 1].dq;
+    }
+    blockSegments_[m - 1].dt = 0;
+    blockSegments_[m - 1].dq = 0;
+  }
+  char qStrand = qSeq.getStrand();
+  if (reversed)
+    qStrand = (qStrand == '+' ? '-' : '+');
+  size_t tStart = reversed ? tSeq.getSrcSize() - tSeq.stop() + trailT : tSeq.start() + leadT;
+  size_t qStart = reversed ? qSeq.getSrcSize() - qSeq.stop() + trailQ : qSeq.start() + leadQ;
+  size_t tLength = 0, qLength = 0, nbAligned = 0;
+  for (const auto& segment : blockSegments_)
+  {
+    tLength += segment.size + segment.dt;
+    qLength += segment.size + segment.dq;
+    nbAligned += segment.size;
+  }
+
+  // Stitch the block to the active chain if possible:
+  bool stitch = !segments_.empty() &&
+                tName_ == tSeq.getChromosome() &&
+                qName_ == qSeq.getChromosome() &&
+                qStrand_ == qStrand &&
+                tStart >= tEnd_ && qStart >= qEnd_ &&
+                tStart - tEnd_ <= maxDist_ && qStart - qEnd_ <= maxDist_;
+  if (stitch)
+  {
+    segments_.back().dt = tStart - tEnd_;
+    segments_.back().dq = qStart - qEnd_;
+    segments_.insert(segments_.end(), blockSegments_.begin(), blockSegments_.end());
+    score_ += nbAligned;
+  }
+  else
+  {
+    writeChain_(*output_);
+    segments_ = blockSegments_;
+    tName_ = tSeq.getChromosome();
+    qName_ = qSeq.getChromosome();
+    tSize_ = tSeq.getSrcSize();
+    qSize_ = qSeq.getSrcSize();
+    qStrand_ = qStrand;
+    tStart_ = tStart;
+    qStart_ = qStart;
+    score_ = nbAligned;
+  }
+  tEnd_ = tStart + tLength;
+  qEnd_ = qStart + qLength;
+}
+
+void ChainOutputMafIterator::writeChain_(ostream& out)
+{
+  if (segments_.empty())
+    return;
+  out << "chain " << score_ << " "
+      << tName_ << " " << tSize_ << " + " << tStart_ << " " << tEnd_ << " "
+      << qName_ << " " << qSize_ << " " << qStrand_ << " " << qStart_ << " " << qEnd_ << " "
+      << ++chainId_ << "\n";
+  for (size_t i = 0; i + 1 < segments_.size(); ++i)
+  {
+    out << segments_[i].size << "\t" << segments_[i].dt << "\t" << segments_[i].dq << "\n";
+  }
+  out << segments_.back().size << "\n\n";
+  segments_.clear();
+}
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _CHAINOUTPUTMAFITERATOR_H_
+#define _CHAINOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief This iterator converts the pairwise alignment of a reference (target) and a query species into the UCSC chain format.
+ *
+ * Within each block, runs of columns where both sequences have a base become ungapped chain segments,
+ * and the columns in between give the gaps on the target (dt) and query (dq) sequences.
+ * Consecutive blocks on the same chromosomes and strands are stitched into a single chain,
+ * as long as they are collinear and the distance between them does not exceed a given value on both sequences,
+ * in a similar way as BlockMergerMafIterator merges blocks.
+ * Target coordinates are always given on the positive strand: blocks where the reference sequence is on the negative strand
+ * are reverse-complemented on the fly, which changes the strand of the query.
+ *
+ * The score of each chain is the number of aligned bases.
+ * Only the chain being built is kept in memory, and it is written as soon as a block cannot be stitched to it,
+ * or at the end of the input.
+ * Blocks without the reference or the query species are forwarded without output. In case a species is duplicated
+ * in a block, the first sequence is used.
+ */
+class ChainOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+private:
+  struct Segment_
+  {
+    size_t size;
+    size_t dt;
+    size_t dq;
+
+    Segment_(size_t s = 0) : size(s), dt(0), dq(0) {}
+  };
+
+private:
+  std::shared_ptr<std::ostream> output_;
+  std::string refSpecies_;
+  std::string querySpecies_;
+  unsigned int maxDist_;
+
+  // The active chain:
+  std::vector<Segment_> segments_;
+  std::string tName_, qName_;
+  size_t tSize_, qSize_;
+  char qStrand_;
+  size_t tStart_, tEnd_, qStart_, qEnd_;
+  size_t score_;
+  size_t chainId_;
+
+  // Buffers:
+  std::vector<Segment_> blockSegments_;
+  std::vector<uint64_t> tGaps_;
+  std::vector<uint64_t> qGaps_;
+  std::vector<uint64_t> aligned_;
+
+public:
+  /**
+   * @brief Build a new ChainOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param out The output stream where to write the chains.
+   * @param reference The reference (target) species.
+   * @param query The query species.
+   * @param maxDist The maximum distance between two consecutive blocks for them to be stitched in the same chain.
+   */
+  ChainOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      const std::string& reference,
+      const std::string& query,
+      unsigned int maxDist = 0) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    refSpecies_(reference),
+    querySpecies_(query),
+    maxDist_(maxDist),
+    segments_(),
+    tName_(), qName_(),
+    tSize_(0), qSize_(0),
+    qStrand_('+'),
+    tStart_(0), tEnd_(0), qStart_(0), qEnd_(0),
+    score_(0),
+    chainId_(0),
+    blockSegments_(),
+    tGaps_(),
+    qGaps_(),
+    aligned_()
+  {}
+
+private:
+  ChainOutputMafIterator(const ChainOutputMafIterator& iterator) :
+    AbstractFilterMafIterator(0),
+    output_(iterator.output_),
+    refSpecies_(iterator.refSpecies_),
+    querySpecies_(iterator.querySpecies_),
+    maxDist_(iterator.maxDist_),
+    segments_(),
+    tName_(), qName_(),
+    tSize_(0), qSize_(0),
+    qStrand_('+'),
+    tStart_(0), tEnd_(0), qStart_(0), qEnd_(0),
+    score_(0),
+    chainId_(0),
+    blockSegments_(),
+    tGaps_(),
+    qGaps_(),
+    aligned_()
+  {}
+
+  ChainOutputMafIterator& operator=(const ChainOutputMafIterator& iterator)
+  {
+    output_       = iterator.output_;
+    refSpecies_   = iterator.refSpecies_;
+    querySpecies_ = iterator.querySpecies_;
+    maxDist_      = iterator.maxDist_;
+    return *this;
+  }
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (output_)
+    {
+      if (currentBlock_)
+        addBlock_(*currentBlock_);
+      else
+        writeChain_(*output_);
+    }
+    return std::move(currentBlock_);
+  }
+
+private:
+  void addBlock_(const MafBlock& block);
+
+  /**
+   * @brief Write the active chain, if any, and reset it.
+   */
+  void writeChain_(std::ostream& out);
+};
+} // end of namespace bpp.
+
+#endif // _CHAINOUTPUTMAFITERATOR_H_
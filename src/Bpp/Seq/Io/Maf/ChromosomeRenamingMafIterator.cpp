@@ -23,8 +23,7 @@ unique_ptr<MafBlock> ChromosomeRenamingMafIterator::analyseCurrentBlock_()
       auto tln = chrTranslation_.find(chr);
       if (tln != chrTranslation_.end())
       {
-        // We force conversion to avoid unecessary recopy
-        const_cast<MafSequence&>(currentBlock_->sequence(i)).setChromosome(tln->second);
+        currentBlock_->mutableSequence(i).setChromosome(tln->second);
         if (logstream_)
         {
           (*logstream_ << "CHROMOSOME RENAMING: renamed " << chr << " to " << tln->second << ".").endLine();
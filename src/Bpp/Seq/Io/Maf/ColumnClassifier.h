@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _COLUMNCLASSIFIER_H_
+#define _COLUMNCLASSIFIER_H_
+
+#include "MafSequence.h"
+#include "BitTools.h"
+
+// From the STL:
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief Summary of the content of an alignment column, for a set of DNA sequences.
+ */
+struct ColumnClass
+{
+  /**
+   * @brief At least one sequence has a gap.
+   */
+  unsigned int hasGap : 1;
+  /**
+   * @brief At least one sequence has an unresolved character.
+   */
+  unsigned int hasUnresolved : 1;
+  /**
+   * @brief The column is parsimony informative, that is, at least two states
+   * (gaps and unresolved characters included) are present in at least two sequences each,
+   * as in SiteTools::isParsimonyInformativeSite.
+   */
+  unsigned int isParsimonyInformative : 1;
+  /**
+   * @brief Presence of the four nucleotides, A being bit 0 and T bit 3.
+   */
+  unsigned int alleles : 4;
+  /**
+   * @brief Counts of the most frequent and second most frequent nucleotides.
+   */
+  unsigned int majorCount;
+  unsigned int minorCount;
+
+  ColumnClass() :
+    hasGap(0), hasUnresolved(0), isParsimonyInformative(0), alleles(0), majorCount(0), minorCount(0) {}
+
+  bool isComplete() const { return !hasGap && !hasUnresolved; }
+
+  unsigned int getNumberOfAlleles() const { return BitTools::popCount(alleles); }
+
+  /**
+   * @return The only nucleotide present in the column, or -1 if the column is not constant.
+   */
+  int getFixedState() const
+  {
+    return getNumberOfAlleles() == 1 ? static_cast<int>(BitTools::countTrailingZeros(alleles)) : -1;
+  }
+};
+
+/**
+ * @brief Classify alignment columns in a single pass over the sequences.
+ *
+ * This replaces successive calls to SiteTools::hasGap, SiteTools::isComplete, SiteTools::getCounts
+ * and SiteTools::isParsimonyInformativeSite, and does not require copying sequences to a site container.
+ * Sequences are expected to be DNA, as created by MafParser.
+ *
+ * @author Julien Dutheil
+ */
+class ColumnClassifier
+{
+public:
+  /**
+   * @brief Classify one column.
+   *
+   * @param sequences The aligned sequences.
+   * @param i The index of the column.
+   * @return The column summary.
+   */
+  static ColumnClass classify(const std::vector<const MafSequence*>& sequences, size_t i)
+  {
+    // Counts are indexed by state + 1, gaps being 0:
+    unsigned int counts[17] = {0};
+    for (const MafSequence* seq : sequences)
+    {
+      int x = (*seq)[i];
+      counts[x < 15 ? x + 1 : 16]++;
+    }
+    ColumnClass c;
+    c.hasGap = counts[0] > 0;
+    unsigned int nbPars = 0;
+    for (size_t s = 0; s < 17; ++s)
+    {
+      if (counts[s] > 1)
+        nbPars++;
+      if (s > 4 && counts[s] > 0)
+        c.hasUnresolved = 1;
+    }
+    unsigned int alleles = 0;
+    for (unsigned int s = 0; s < 4; ++s)
+    {
+      unsigned int n = counts[s + 1];
+      if (n == 0)
+        continue;
+      alleles |= 1u << s;
+      if (n > c.majorCount)
+      {
+        c.minorCount = c.majorCount;
+        c.majorCount = n;
+      }
+      else if (n > c.minorCount)
+      {
+        c.minorCount = n;
+      }
+    }
+    c.alleles = alleles & 15u;
+    c.isParsimonyInformative = nbPars > 1;
+    return c;
+  }
+
+  /**
+   * @brief Classify all columns of a set of sequences.
+   *
+   * @param sequences The aligned sequences.
+   * @param nbColumns The number of columns.
+   * @param classes The vector where to store the results, which will be resized if needed.
+   */
+  static void classify(const std::vector<const MafSequence*>& sequences, size_t nbColumns, std::vector<ColumnClass>& classes)
+  {
+    classes.resize(nbColumns);
+    for (size_t i = 0; i < nbColumns; ++i)
+    {
+      classes[i] = classify(sequences, i);
+    }
+  }
+};
+} // end of namespace bpp.
+
+#endif // _COLUMNCLASSIFIER_H_
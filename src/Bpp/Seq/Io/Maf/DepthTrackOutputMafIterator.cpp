@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "DepthTrackOutputMafIterator.h"
+#include "DnaTraits.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+void DepthTrackOutputMafIterator::addBlock_(const MafBlock& block)
+{
+  isFlushed_ = false;
+  if (!block.hasSequenceForSpecies(refSpecies_))
+    return;
+  const MafSequence& refSeq = block.sequenceForSpecies(refSpecies_);
+  if (!refSeq.hasCoordinates())
+    throw Exception("DepthTrackOutputMafIterator::addBlock_. Reference sequence has no coordinates: " + refSeq.getDescription() + ".");
+  const string& chr = refSeq.getChromosome();
+  size_t srcSize = refSeq.getSrcSize();
+  if (refSeq.stop() > srcSize)
+    throw Exception("DepthTrackOutputMafIterator::addBlock_. Reference sequence goes beyond the chromosome size: " + refSeq.getDescription() + ".");
+
+  if (sortedInput_ && chr != currentChr_)
+  {
+    if (currentChr_ != "")
+      flushChromosome_(currentChr_);
+    if (flushedChromosomes_.count(chr))
+      throw Exception("DepthTrackOutputMafIterator::addBlock_. Input is not sorted by chromosome: " + chr + " was met again after being written.");
+  }
+  currentChr_ = chr;
+
+  auto it = tracks_.find(chr);
+  if (it == tracks_.end())
+  {
+    it = tracks_.emplace(chr, vector<uint16_t>(srcSize + 1, 0)).first;
+    chromosomes_.push_back(chr);
+  }
+  else if (it->second.size() != srcSize + 1)
+  {
+    throw Exception("DepthTrackOutputMafIterator::addBlock_. Inconsistent sizes for chromosome " + chr + ".");
+  }
+  vector<uint16_t>& diff = it->second;
+
+  // Species to count, without duplicates:
+  vector<string> species = species_.empty() ? block.getSpeciesList() : species_;
+  sort(species.begin(), species.end());
+  species.erase(unique(species.begin(), species.end()), species.end());
+
+  const vector<int>& ref = refSeq.getContent();
+  size_t nbColumns = ref.size();
+  bool negative = (refSeq.getStrand() == '-');
+  size_t start = refSeq.start();
+  // Add the events for one run [a, b[ in the coordinates of the reference strand.
+  // Arithmetic on uint16_t is modular, so that decrements can temporarily wrap around.
+  auto addRun = [&](size_t a, size_t b) {
+        size_t x = negative ? srcSize - b : a;
+        size_t y = negative ? srcSize - a : b;
+        diff[x] = static_cast<uint16_t>(diff[x] + 1u);
+        diff[y] = static_cast<uint16_t>(diff[y] - 1u);
+      };
+
+  for (const auto& sp : species)
+  {
+    vector<const MafSequence*> rows = block.getSequencesForSpecies(sp);
+    if (rows.empty())
+      continue;
+    size_t pos = start;
+    size_t runStart = 0;
+    bool inRun = false;
+    for (size_t j = 0; j < nbColumns; ++j)
+    {
+      if (DnaTraits::isGap(ref[j]))
+        continue;
+      bool aligned = false;
+      for (size_t k = 0; !aligned && k < rows.size(); ++k)
+      {
+        aligned = !DnaTraits::isGap(rows[k]->getContent()[j]);
+      }
+      if (aligned && !inRun)
+      {
+        runStart = pos;
+        inRun = true;
+      }
+      else if (!aligned && inRun)
+      {
+        addRun(runStart, pos);
+        inRun = false;
+      }
+      ++pos;
+    }
+    if (inRun)
+      addRun(runStart, pos);
+  }
+}
+
+void DepthTrackOutputMafIterator::flushChromosome_(const string& chr)
+{
+  auto it = tracks_.find(chr);
+  if (it == tracks_.end())
+    return;
+  vector<uint16_t>& depth = it->second;
+  // Prefix sums, in place:
+  uint16_t current = 0;
+  for (auto& d : depth)
+  {
+    current = static_cast<uint16_t>(current + d);
+    d = current;
+  }
+  // The last element only holds the closing events:
+  depth.pop_back();
+  if (output_)
+  {
+    if (format_ == FORMAT_BINARY)
+      writeBinary_(*output_, chr, depth);
+    else
+      writeBedGraph_(*output_, chr, depth);
+  }
+  if (logstream_)
+  {
+    (*logstream_ << "DEPTH TRACK: chromosome " << chr << " written (" << depth.size() << " positions).").endLine();
+  }
+  tracks_.erase(it);
+  flushedChromosomes_.insert(chr);
+}
+
+void DepthTrackOutputMafIterator::flush()
+{
+  if (isFlushed_)
+    return;
+  for (const auto& chr : chromosomes_)
+  {
+    flushChromosome_(chr);
+  }
+  chromosomes_.clear();
+  if (output_)
+    output_->flush();
+  isFlushed_ = true;
+}
+
+void DepthTrackOutputMafIterator::writeBedGraph_(ostream& out, const string& chr, const vector<uint16_t>& depth)
+{
+  size_t n = depth.size();
+  size_t i = 0;
+  while (i < n)
+  {
+    uint16_t d = depth[i];
+    size_t j = i + 1;
+    while (j < n && depth[j] == d)
+    {
+      ++j;
+    }
+    if (d > 0)
+      out << chr << "\t" << i << "\t" << j << "\t" << d << "\n";
+    i = j;
+  }
+}
+
+void DepthTrackOutputMafIterator::writeBinary_(ostream& out, const string& chr, const vector<uint16_t>& depth)
+{
+  auto writeInteger = [&out](uint64_t x, size_t nbBytes) {
+        char bytes[8];
+        for (size_t k = 0; k < nbBytes; ++k)
+        {
+          bytes[k] = static_cast<char>((x >> (8 * k)) & 0xFF);
+        }
+        out.write(bytes, static_cast<streamsize>(nbBytes));
+      };
+  writeInteger(chr.size(), 4);
+  out.write(chr.data(), static_cast<streamsize>(chr.size()));
+  writeInteger(depth.size(), 8);
+  // Values are converted to little-endian by chunks, to limit the number of calls to write:
+  vector<char> buffer(2 * min(depth.size(), static_cast<size_t>(65536)));
+  for (size_t i = 0; i < depth.size(); i += buffer.size() / 2)
+  {
+    size_t len = min(buffer.size() / 2, depth.size() - i);
+    for (size_t k = 0; k < len; ++k)
+    {
+      buffer[2 * k] = static_cast<char>(depth[i + k] & 0xFF);
+      buffer[2 * k + 1] = static_cast<char>(depth[i + k] >> 8);
+    }
+    out.write(buffer.data(), static_cast<streamsize>(2 * len));
+  }
+}
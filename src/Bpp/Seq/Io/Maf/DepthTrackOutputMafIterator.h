@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _DEPTHTRACKOUTPUTMAFITERATOR_H_
+#define _DEPTHTRACKOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief This iterator computes the alignment depth along the reference genome, that is,
+ * the number of species aligned at each position of the reference sequence.
+ *
+ * A species is aligned at a position if at least one of its sequences has a non-gap character
+ * in the column of the reference base. The reference species itself is counted.
+ * Coordinates are given on the positive strand of the reference sequence.
+ * Blocks without the reference species are forwarded without being counted.
+ *
+ * For each block, the depth is recorded as +1/-1 events at the bounds of each aligned run
+ * of each species, in a difference array spanning the reference chromosome.
+ * Arrays store 16 bits unsigned integers, so that the memory used is two bytes per base
+ * of the reference chromosomes. Because unsigned arithmetic is modular, intermediate negative
+ * values are harmless, and the prefix sums are exact as long as the depth does not exceed 65535.
+ * The depth of each chromosome is computed and written once all blocks have been read.
+ * If the input is sorted by reference chromosome, each chromosome can be written
+ * and its memory released as soon as the next chromosome starts.
+ *
+ * Two output formats are supported:
+ * - FORMAT_BEDGRAPH: one line per run of identical non-zero depth, with 0-based, half-open coordinates,
+ * - FORMAT_BINARY: the file starts with the 8 characters "BPPDEPTH", followed, for each chromosome,
+ *   by the length of its name as a 32 bits integer, the name, the length of the chromosome as a 64 bits integer,
+ *   and the depth of each position as 16 bits integers. All integers are unsigned and little-endian.
+ */
+class DepthTrackOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+public:
+  static constexpr short FORMAT_BEDGRAPH = 0;
+  static constexpr short FORMAT_BINARY = 1;
+
+private:
+  std::shared_ptr<std::ostream> output_;
+  std::string refSpecies_;
+  std::vector<std::string> species_;
+  short format_;
+  bool sortedInput_;
+  std::map<std::string, std::vector<uint16_t>> tracks_;
+  std::vector<std::string> chromosomes_;
+  std::set<std::string> flushedChromosomes_;
+  std::string currentChr_;
+  bool isFlushed_;
+
+public:
+  /**
+   * @brief Build a new DepthTrackOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param out The output stream where to write the track.
+   * @param reference The species to use as a reference for coordinates.
+   * @param species The species to count. If empty, all species in each block are counted.
+   * @param format The output format, one of FORMAT_BEDGRAPH or FORMAT_BINARY.
+   * @param sortedInput Tell if blocks are sorted by reference chromosome.
+   * In this case, each chromosome is written as soon as a block on another chromosome is met.
+   * An exception is thrown if a chromosome is met again after being written.
+   */
+  DepthTrackOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      const std::string& reference,
+      const std::vector<std::string>& species = std::vector<std::string>(),
+      short format = FORMAT_BEDGRAPH,
+      bool sortedInput = false) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    refSpecies_(reference),
+    species_(species),
+    format_(format),
+    sortedInput_(sortedInput),
+    tracks_(),
+    chromosomes_(),
+    flushedChromosomes_(),
+    currentChr_(""),
+    isFlushed_(false)
+  {
+    if (format_ != FORMAT_BEDGRAPH && format_ != FORMAT_BINARY)
+      throw Exception("DepthTrackOutputMafIterator. Unknown output format: " + TextTools::toString(format_) + ".");
+    if (output_ && format_ == FORMAT_BINARY)
+      output_->write("BPPDEPTH", 8);
+  }
+
+private:
+  DepthTrackOutputMafIterator(const DepthTrackOutputMafIterator& iterator) :
+    AbstractFilterMafIterator(0),
+    output_(iterator.output_),
+    refSpecies_(iterator.refSpecies_),
+    species_(iterator.species_),
+    format_(iterator.format_),
+    sortedInput_(iterator.sortedInput_),
+    tracks_(),
+    chromosomes_(),
+    flushedChromosomes_(),
+    currentChr_(""),
+    isFlushed_(false)
+  {}
+
+  DepthTrackOutputMafIterator& operator=(const DepthTrackOutputMafIterator& iterator)
+  {
+    output_      = iterator.output_;
+    refSpecies_  = iterator.refSpecies_;
+    species_     = iterator.species_;
+    format_      = iterator.format_;
+    sortedInput_ = iterator.sortedInput_;
+    return *this;
+  }
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (currentBlock_)
+      addBlock_(*currentBlock_);
+    else
+      flush();
+    return std::move(currentBlock_);
+  }
+
+  /**
+   * @brief Write the depth of all chromosomes not written yet, and release the memory.
+   *
+   * This is called automatically when the end of the input is reached.
+   */
+  void flush();
+
+private:
+  void addBlock_(const MafBlock& block);
+
+  void flushChromosome_(const std::string& chr);
+
+  void writeBedGraph_(std::ostream& out, const std::string& chr, const std::vector<uint16_t>& depth);
+
+  void writeBinary_(std::ostream& out, const std::string& chr, const std::vector<uint16_t>& depth);
+};
+} // end of namespace bpp.
+
+#endif // _DEPTHTRACKOUTPUTMAFITERATOR_H_
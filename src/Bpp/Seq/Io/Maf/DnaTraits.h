@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _DNATRAITS_H_
+#define _DNATRAITS_H_
+
+// From bpp-seq:
+#include <Bpp/Seq/Alphabet/Alphabet.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+
+namespace bpp
+{
+/**
+ * @brief Compile-time description of the DNA alphabet, as used for all MAF sequences.
+ *
+ * All functions are static and constexpr, and give the same results as the corresponding
+ * methods of the DNA alphabet class (AlphabetTools::DNA_ALPHABET), without any virtual call.
+ * States are coded as in the DNA class: A, C, G, T = 0, 1, 2, 3, then the ambiguity codes
+ * M, R, W, S, Y, K, V, H, D, B, N = 4 to 14, the gap being -1.
+ *
+ * Functions can also be called via an instance, which allows to write kernels templated
+ * on the traits type, with GenericAlphabetTraits as a fallback for other alphabets
+ * (see AlphabetTraitsTools::dispatch).
+ */
+struct DnaTraits
+{
+  static constexpr int GAP = -1;
+  static constexpr int A = 0;
+  static constexpr int C = 1;
+  static constexpr int G = 2;
+  static constexpr int T = 3;
+  static constexpr int N = 14;
+  static constexpr int NUMBER_OF_RESOLVED_STATES = 4;
+  static constexpr int NUMBER_OF_STATES = 15;
+
+  static constexpr bool isGap(int state) { return state == GAP; }
+
+  static constexpr bool isUnresolved(int state) { return state > T; }
+
+  /**
+   * @return True if the state is one of A, C, G or T. This is computed without branching.
+   */
+  static constexpr bool isResolved(int state) { return (state & ~3) == 0; }
+
+  static constexpr int getGapCharacterCode() { return GAP; }
+
+  static constexpr char intToChar(int state)
+  {
+    return state == GAP ? '-' : "ACGTMRWSYKVHDBN"[state];
+  }
+
+  static constexpr int charToInt(char c)
+  {
+    return c == 'A' || c == 'a' ? A :
+           c == 'C' || c == 'c' ? C :
+           c == 'G' || c == 'g' ? G :
+           c == 'T' || c == 't' ? T :
+           c == 'M' || c == 'm' ? 4 :
+           c == 'R' || c == 'r' ? 5 :
+           c == 'W' || c == 'w' ? 6 :
+           c == 'S' || c == 's' ? 7 :
+           c == 'Y' || c == 'y' ? 8 :
+           c == 'K' || c == 'k' ? 9 :
+           c == 'V' || c == 'v' ? 10 :
+           c == 'H' || c == 'h' ? 11 :
+           c == 'D' || c == 'd' ? 12 :
+           c == 'B' || c == 'b' ? 13 :
+           c == '-' || c == '.' ? GAP : N;
+  }
+
+  /**
+   * @return The complementary state. Gaps, N, S and W are their own complement.
+   */
+  static constexpr int complement(int state)
+  {
+    return state == GAP ? GAP :
+           state <= T ? T - state :
+           state == N ? N :
+           // M <-> K, R <-> Y, W, S, V <-> B, H <-> D:
+           "\11\10\6\7\5\4\15\14\13\12"[state - 4];
+  }
+};
+
+/**
+ * @brief Run-time equivalent of DnaTraits, forwarding to any alphabet.
+ */
+class GenericAlphabetTraits
+{
+private:
+  const Alphabet* alphabet_;
+
+public:
+  GenericAlphabetTraits(const Alphabet& alphabet) : alphabet_(&alphabet) {}
+
+public:
+  bool isGap(int state) const { return alphabet_->isGap(state); }
+
+  bool isUnresolved(int state) const { return alphabet_->isUnresolved(state); }
+
+  bool isResolved(int state) const { return !alphabet_->isGap(state) && !alphabet_->isUnresolved(state); }
+
+  int getGapCharacterCode() const { return alphabet_->getGapCharacterCode(); }
+
+  char intToChar(int state) const { return alphabet_->intToChar(state)[0]; }
+};
+
+class AlphabetTraitsTools
+{
+public:
+  /**
+   * @brief Call a kernel with the most specialized traits available for an alphabet.
+   *
+   * The kernel is typically a generic lambda taking the traits as argument, for instance:
+   * @code
+   * size_t n = AlphabetTraitsTools::dispatch(alphabet, [&](const auto& traits) {
+   *   size_t count = 0;
+   *   for (int x : content) if (traits.isResolved(x)) ++count;
+   *   return count;
+   * });
+   * @endcode
+   * The kernel is then instantiated once for DnaTraits and once for GenericAlphabetTraits.
+   *
+   * @param alphabet The alphabet of the data.
+   * @param kernel The kernel to call.
+   * @return The value returned by the kernel.
+   */
+  template<class Kernel>
+  static auto dispatch(const Alphabet& alphabet, Kernel&& kernel) -> decltype(kernel(DnaTraits()))
+  {
+    if (AlphabetTools::isDNAAlphabet(&alphabet))
+      return kernel(DnaTraits());
+    else
+      return kernel(GenericAlphabetTraits(alphabet));
+  }
+};
+} // end of namespace bpp.
+
+#endif // _DNATRAITS_H_
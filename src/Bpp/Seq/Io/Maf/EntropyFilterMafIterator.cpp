@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "EntropyFilterMafIterator.h"
+#include "GappedRow.h"
 
 using namespace bpp;
 
@@ -32,30 +33,27 @@ unique_ptr<MafBlock> EntropyFilterMafIterator::analyseCurrentBlock_()
       if (nc < windowSize_)
         throw Exception("EntropyFilterMafIterator::analyseCurrentBlock_. Block is smaller than window size: " + TextTools::toString(nc));
 
-      vector< vector<int>> aln;
+      vector<GappedRow> aln;
       if (missingAsGap_ && !ignoreGaps_)
       {
         nr = species_.size();
-        aln.resize(nr);
+        aln.reserve(nr);
         for (size_t i = 0; i < nr; ++i)
         {
           if (block->hasSequenceForSpecies(species_[i]))
-            aln[i] = block->sequenceForSpecies(species_[i]).getContent();
+            aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
           else
-          {
-            aln[i].resize(nc);
-            fill(aln[i].begin(), aln[i].end(), gap);
-          }
+            aln.push_back(GappedRow(nc)); // Virtual all-gap row, nothing is allocated.
         }
       }
       else
       {
         vector<string> speciesSet = VectorTools::vectorIntersection(species_, block->getSpeciesList());
         nr = speciesSet.size();
-        aln.resize(nr);
+        aln.reserve(nr);
         for (size_t i = 0; i < nr; ++i)
         {
-          aln[i] = block->sequenceForSpecies(species_[i]).getContent();
+          aln.push_back(GappedRow(block->sequenceForSpecies(species_[i]).getContent()));
         }
       }
       // First we create a mask:
@@ -4,6 +4,9 @@
 
 #include "FeatureExtractorMafIterator.h"
 
+// From bpp-core:
+#include <Bpp/Numeric/Number.h>
+
 // From bpp-seq:
 #include <Bpp/Seq/SequenceWalker.h>
 
@@ -15,6 +18,24 @@ using namespace bpp;
 
 using namespace std;
 
+void FeatureExtractorMafIterator::loadRanges_(const string& chr)
+{
+  if (!database_ || ranges_.find(chr) != ranges_.end() || !database_->hasSequence(chr))
+    return;
+  vector<size_t> indices;
+  database_->getFeatureIndicesForSequence(chr, indices, types_);
+  RangeSet<size_t>& ranges = ranges_[chr];
+  for (auto i : indices)
+  {
+    size_t start = database_->getStart(i);
+    size_t end = database_->getEnd(i);
+    ranges.addRange(SeqRange(start, end, database_->getStrand(i)));
+    int phase = database_->getPhase(i);
+    if (phase != FeatureDatabase::NO_PHASE)
+      phases_[chr][make_pair(start, end)] = phase;
+  }
+}
+
 unique_ptr<MafBlock> FeatureExtractorMafIterator::analyseCurrentBlock_()
 {
   while (blockBuffer_.size() == 0)
@@ -36,6 +57,7 @@ START:
     const auto& refSeq = block->sequenceForSpecies(refSpecies_);
     // first check if there is one (for now we assume that features refer to the chromosome or contig name, with implicit species):
 
+    loadRanges_(refSeq.getChromosome());
     auto mr = ranges_.find(refSeq.getChromosome());
     if (mr == ranges_.end())
     {
@@ -78,6 +100,7 @@ START:
       (*logstream_ << "FEATURE EXTRACTOR: extracting " << ranges.getSet().size() << " features from block " << block->getDescription() << ".").endLine();
     }
 
+    auto phases = phases_.find(refSeq.getChromosome());
     size_t i = 0;
     for (const auto& it : ranges.getSet())
     {
@@ -105,6 +128,21 @@ START:
         (*logstream_ << subseq->getName()).endLine();
         newBlock->addSequence(subseq);
       }
+      if (phases != phases_.end())
+      {
+        // The phase is only meaningful if the block is in the orientation of the feature:
+        bool isNegative = dynamic_cast<const SeqRange*>(it)->isNegativeStrand();
+        if (!ignoreStrand_ || isNegative == (refSeq.getStrand() == '-'))
+        {
+          // Get the original feature coordinates:
+          pair<size_t, size_t> coords(it->begin(), it->end());
+          if (refSeq.getStrand() == '-')
+            coords = make_pair(refSeq.getSrcSize() - it->end(), refSeq.getSrcSize() - it->begin());
+          auto ph = phases->second.find(coords);
+          if (ph != phases->second.end())
+            newBlock->setProperty(GffFeatureReader::GFF_PHASE, make_unique<BppInteger>(ph->second));
+        }
+      }
       blockBuffer_.push_back(std::move(newBlock));
     }
 
@@ -6,6 +6,9 @@
 #define _FEATUREEXTRACTORMAFITERATOR_H_
 
 #include "AbstractMafIterator.h"
+#include "../../Feature/Gff/GffFeatureReader.h"
+#include "../../Feature/Gtf/GtfFeatureReader.h"
+#include "../../Feature/FeatureDatabase.h"
 
 // From the STL:
 #include <iostream>
@@ -21,6 +24,15 @@ namespace bpp
  * Note that this iterator is not the opposite of FeatureFilterMafIterator,
  * as overlapping features will all be extracted. This iterator may therefore results
  * in duplication of original data.
+ *
+ * When a feature carries a phase attribute (GffFeatureReader::GFF_PHASE or GtfFeatureReader::GTF_PHASE)
+ * and is extracted in full and in its own orientation,
+ * the phase is attached to the resulting block as a property with the same name (stored as a BppInteger),
+ * so that downstream analyses can recover the reading frame.
+ *
+ * Features can also be read from a FeatureDatabase, in which case the ranges and phases of each chromosome
+ * are only built when a block of this chromosome is first encountered. Phases are then taken from the database,
+ * which records both GFF and GTF phases.
  */
 class FeatureExtractorMafIterator :
   public AbstractFilterMafIterator
@@ -31,6 +43,9 @@ private:
   bool ignoreStrand_;
   std::deque<std::unique_ptr<MafBlock>> blockBuffer_;
   std::map<std::string, RangeSet<size_t>> ranges_;
+  std::map<std::string, std::map<std::pair<size_t, size_t>, int>> phases_;
+  std::shared_ptr<const FeatureDatabase> database_;
+  std::vector<std::string> types_;
 
 public:
   /**
@@ -53,7 +68,10 @@ public:
     completeOnly_(complete),
     ignoreStrand_(ignoreStrand),
     blockBuffer_(),
-    ranges_()
+    ranges_(),
+    phases_(),
+    database_(),
+    types_()
   {
     // Build ranges:
     std::set<std::string> seqIds = features.getSequences();
@@ -61,10 +79,56 @@ public:
     {
       features.fillRangeCollectionForSequence(it, ranges_[it]);
     }
+    // Record phases, if any:
+    for (size_t i = 0; i < features.getNumberOfFeatures(); ++i)
+    {
+      const SequenceFeature& feature = features[i];
+      std::string phase = feature.getAttribute(GffFeatureReader::GFF_PHASE);
+      if (phase == "")
+        phase = feature.getAttribute(GtfFeatureReader::GTF_PHASE);
+      if (phase != "" && phase != ".")
+        phases_[feature.getSequenceId()][std::make_pair(feature.getStart(), feature.getEnd())] = TextTools::to<int>(phase);
+    }
+  }
+
+  /**
+   * @brief Build a new FeatureExtractor iterator reading features from a database.
+   *
+   * @param iterator The input iterator
+   * @param refSpecies The reference species for feature coordinates
+   * @param database The database of features to extract
+   * @param complete Tell if features should be extracted only if they can be extracted in full
+   * @param ignoreStrand If true, features will be extracted 'as is', without being reversed in case they are on the negative strand.
+   * @param types If not empty, only features of these types are extracted.
+   */
+  FeatureExtractorMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      const std::string& refSpecies,
+      std::shared_ptr<const FeatureDatabase> database,
+      bool complete = false,
+      bool ignoreStrand = false,
+      const std::vector<std::string>& types = std::vector<std::string>()) :
+    AbstractFilterMafIterator(iterator),
+    refSpecies_(refSpecies),
+    completeOnly_(complete),
+    ignoreStrand_(ignoreStrand),
+    blockBuffer_(),
+    ranges_(),
+    phases_(),
+    database_(database),
+    types_(types)
+  {
+    if (!database_)
+      throw Exception("FeatureExtractorMafIterator. No feature database.");
   }
 
 private:
   std::unique_ptr<MafBlock> analyseCurrentBlock_();
+
+  /**
+   * @brief Build the ranges and phases of a chromosome from the database, if any and if not done yet.
+   */
+  void loadRanges_(const std::string& chr);
 };
 } // end of namespace bpp.
 
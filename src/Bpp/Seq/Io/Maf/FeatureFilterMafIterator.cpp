@@ -3,12 +3,14 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "FeatureFilterMafIterator.h"
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
 
 using namespace bpp;
 
 // From the STL:
 #include <string>
 #include <numeric>
+#include <algorithm>
 
 using namespace std;
 
@@ -36,6 +38,7 @@ unique_ptr<MafBlock> FeatureFilterMafIterator::analyseCurrentBlock_()
       // Get the feature ranges for this block:
       const auto& refSeq = block->sequenceForSpecies(refSpecies_);
       // first check if there is one (for now we assume that features refer to the chromosome or contig name, with implicit species):
+      loadRanges_(refSeq.getChromosome());
       auto mr = ranges_.find(refSeq.getChromosome());
       if (mr == ranges_.end())
       {
@@ -117,6 +120,31 @@ unique_ptr<MafBlock> FeatureFilterMafIterator::analyseCurrentBlock_()
         throw Exception("FeatureFilterMafIterator::nextBlock(). An error occurred here, " + TextTools::toString(refBounds.size()) + " coordinates are left, in sequence " + refSeq.getDescription() + "... this is most likely a bug, please report!");
       }
 
+      if (mode_ == MODE_MASK)
+      {
+        if (keepTrashedBlocks_)
+        {
+          for (size_t i = 0; i < pos.size(); i += 2)
+          {
+            auto outBlock = make_unique<MafBlock>();
+            outBlock->setScore(block->getScore());
+            outBlock->setPass(block->getPass());
+            for (size_t j = 0; j < block->getNumberOfSequences(); ++j)
+            {
+              auto outseq = block->sequence(j).subSequence(pos[i], pos[i + 1] - pos[i]);
+              outBlock->addSequence(outseq);
+            }
+            trashBuffer_.push_back(std::move(outBlock));
+          }
+        }
+        if (logstream_)
+        {
+          (*logstream_ << "FEATURE FILTER: masking " << (pos.size() / 2) << " regions in block " << block->getDescription() << ".").endLine();
+        }
+        maskBlock_(*block, pos);
+        return block;
+      }
+
       // Next step is simply to split the block according to the translated coordinates:
       if (pos.size() == 2 && pos.front() == 0 && pos.back() == block->getNumberOfSites())
       {
@@ -203,3 +231,48 @@ unique_ptr<MafBlock> FeatureFilterMafIterator::analyseCurrentBlock_()
   blockBuffer_.pop_front();
   return nxtBlock;
 }
+
+void FeatureFilterMafIterator::maskBlock_(MafBlock& block, const vector<size_t>& pos) const
+{
+  vector<bool> columns;
+  if (annotateMask_)
+  {
+    columns.resize(block.getNumberOfSites(), false);
+    for (size_t i = 0; i < pos.size(); i += 2)
+    {
+      fill(columns.begin() + static_cast<ptrdiff_t>(pos[i]), columns.begin() + static_cast<ptrdiff_t>(pos[i + 1]), true);
+    }
+  }
+  for (size_t j = 0; j < block.getNumberOfSequences(); ++j)
+  {
+    MafSequence& seq = block.mutableSequence(j);
+    int gap = seq.getAlphabet()->getGapCharacterCode();
+    int unknown = seq.getAlphabet()->getUnknownCharacterCode();
+    vector<int> content = seq.getContent();
+    for (size_t i = 0; i < pos.size(); i += 2)
+    {
+      auto first = content.begin() + static_cast<ptrdiff_t>(pos[i]);
+      auto last = content.begin() + static_cast<ptrdiff_t>(pos[i + 1]);
+      replace_if(first, last, [gap](int x) { return x != gap; }, unknown);
+    }
+
+    // Changing the content resets the annotations, so we save the existing mask first:
+    bool hasMask = seq.hasAnnotation(SequenceMask::MASK);
+    vector<bool> oldMask;
+    if (hasMask)
+      oldMask = dynamic_cast<const SequenceMask&>(seq.annotation(SequenceMask::MASK)).getMask();
+    seq.setContent(content);
+    if (hasMask)
+    {
+      SequenceMask& mask = dynamic_cast<SequenceMask&>(seq.annotation(SequenceMask::MASK));
+      for (size_t k = 0; k < oldMask.size(); ++k)
+      {
+        mask.setMask(k, oldMask[k] || (annotateMask_ && columns[k]));
+      }
+    }
+    else if (annotateMask_)
+    {
+      seq.addAnnotation(make_shared<SequenceMask>(columns));
+    }
+  }
+}
@@ -6,6 +6,7 @@
 #define _FEATUREFILTERMAFITERATOR_H_
 
 #include "AbstractMafIterator.h"
+#include "../../Feature/FeatureDatabase.h"
 
 // From the STL:
 #include <iostream>
@@ -19,31 +20,68 @@ namespace bpp
  * @brief Remove from alignment all positions that fall within any feature from a list given as a SequenceFeatureSet object.
  *
  * Removed regions are outputed as a trash iterator.
+ *
+ * Two modes are available:
+ * - MODE_SPLIT (default): each block is split around the features, which are removed from the alignment.
+ * - MODE_MASK: the block is kept intact, and all columns within a feature are masked in all sequences,
+ *   by replacing residues with the unknown character. Gaps are left unchanged, so that the number of residues,
+ *   and hence the coordinates of each sequence, are not modified.
+ *   This is much faster than splitting when features are numerous and short (for instance repeats),
+ *   as no sub-block is created. Masked columns can optionally be recorded as a SequenceMask annotation on each sequence,
+ *   combined with any existing mask, so that they can be written as lower case characters.
+ * In both modes, the removed or masked regions are outputed as a trash iterator, with their original content, if requested.
+ *
+ * Features can also be read from a FeatureDatabase, in which case the ranges of each chromosome
+ * are only built when a block of this chromosome is first encountered.
  */
 class FeatureFilterMafIterator :
   public AbstractFilterMafIterator,
   public MafTrashIteratorInterface
 {
+public:
+  static constexpr short MODE_SPLIT = 0;
+  static constexpr short MODE_MASK = 1;
+
 private:
   std::string refSpecies_;
   std::deque<std::unique_ptr<MafBlock>> blockBuffer_;
   std::deque<std::unique_ptr<MafBlock>> trashBuffer_;
   bool keepTrashedBlocks_;
   std::map<std::string, MultiRange<size_t>> ranges_;
+  short mode_;
+  bool annotateMask_;
+  std::shared_ptr<const FeatureDatabase> database_;
+  std::vector<std::string> types_;
 
 public:
+  /**
+   * @param iterator The input iterator.
+   * @param refSpecies The species the features refer to.
+   * @param features The features to remove or mask.
+   * @param keepTrashedBlocks Tell if removed regions should be kept in the trash buffer.
+   * @param mode One of MODE_SPLIT or MODE_MASK.
+   * @param annotateMask In masking mode, tell if masked columns should be recorded as a SequenceMask annotation.
+   */
   FeatureFilterMafIterator(
       std::shared_ptr<MafIteratorInterface> iterator,
       const std::string& refSpecies,
       const SequenceFeatureSet& features,
-      bool keepTrashedBlocks) :
+      bool keepTrashedBlocks,
+      short mode = MODE_SPLIT,
+      bool annotateMask = false) :
     AbstractFilterMafIterator(iterator),
     refSpecies_(refSpecies),
     blockBuffer_(),
     trashBuffer_(),
     keepTrashedBlocks_(keepTrashedBlocks),
-    ranges_()
+    ranges_(),
+    mode_(mode),
+    annotateMask_(annotateMask),
+    database_(),
+    types_()
   {
+    if (mode_ != MODE_SPLIT && mode_ != MODE_MASK)
+      throw Exception("FeatureFilterMafIterator. Unknown mode: " + TextTools::toString(mode_) + ".");
     // Build ranges:
     std::set<std::string> seqIds = features.getSequences();
     for (auto& it : seqIds)
@@ -54,6 +92,40 @@ public:
     }
   }
 
+  /**
+   * @param iterator The input iterator.
+   * @param refSpecies The species the features refer to.
+   * @param database The database of features to remove or mask.
+   * @param keepTrashedBlocks Tell if removed regions should be kept in the trash buffer.
+   * @param mode One of MODE_SPLIT or MODE_MASK.
+   * @param annotateMask In masking mode, tell if masked columns should be recorded as a SequenceMask annotation.
+   * @param types If not empty, only features of these types are used.
+   */
+  FeatureFilterMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      const std::string& refSpecies,
+      std::shared_ptr<const FeatureDatabase> database,
+      bool keepTrashedBlocks,
+      short mode = MODE_SPLIT,
+      bool annotateMask = false,
+      const std::vector<std::string>& types = std::vector<std::string>()) :
+    AbstractFilterMafIterator(iterator),
+    refSpecies_(refSpecies),
+    blockBuffer_(),
+    trashBuffer_(),
+    keepTrashedBlocks_(keepTrashedBlocks),
+    ranges_(),
+    mode_(mode),
+    annotateMask_(annotateMask),
+    database_(database),
+    types_(types)
+  {
+    if (mode_ != MODE_SPLIT && mode_ != MODE_MASK)
+      throw Exception("FeatureFilterMafIterator. Unknown mode: " + TextTools::toString(mode_) + ".");
+    if (!database_)
+      throw Exception("FeatureFilterMafIterator. No feature database.");
+  }
+
 public:
   std::unique_ptr<MafBlock> nextRemovedBlock()
   {
@@ -65,6 +137,23 @@ public:
 
 private:
   std::unique_ptr<MafBlock> analyseCurrentBlock_();
+
+  /**
+   * @brief Mask the given alignment columns in all sequences of a block.
+   *
+   * @param block The block to mask.
+   * @param pos The bounds of the regions to mask, as pairs of alignment positions [start, end[.
+   */
+  void maskBlock_(MafBlock& block, const std::vector<size_t>& pos) const;
+
+  /**
+   * @brief Build the ranges of a chromosome from the database, if any and if not done yet.
+   */
+  void loadRanges_(const std::string& chr)
+  {
+    if (database_ && ranges_.find(chr) == ranges_.end() && database_->hasSequence(chr))
+      database_->fillRangeCollectionForSequence(chr, ranges_[chr], types_);
+  }
 };
 } // end of namespace bpp.
 
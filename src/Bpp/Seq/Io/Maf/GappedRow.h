@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _GAPPEDROW_H_
+#define _GAPPEDROW_H_
+
+#include "DnaTraits.h"
+
+// From the STL:
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Read-only view of an alignment row padded with gaps.
+ *
+ * The row is made of a run of leading gaps, the content of an existing sequence, and a run of trailing gaps.
+ * Gap runs are only stored as lengths, and the content is not copied.
+ * A row without content is a virtual all-gap row. It is used by AlignmentFilterMafIterator,
+ * AlignmentFilter2MafIterator and EntropyFilterMafIterator for species absent from a block,
+ * which then need no gap-filled copy.
+ *
+ * The referenced content must remain valid as long as the view is used.
+ */
+class GappedRow
+{
+private:
+  const std::vector<int>* content_;
+  size_t leading_;
+  size_t trailing_;
+
+public:
+  /**
+   * @brief Build a virtual all-gap row.
+   *
+   * @param length The length of the row.
+   */
+  explicit GappedRow(size_t length = 0) :
+    content_(nullptr),
+    leading_(length),
+    trailing_(0)
+  {}
+
+  /**
+   * @brief Build a view of a sequence, with optional gap padding.
+   *
+   * @param content The content of the sequence.
+   * @param leading The number of gaps before the sequence.
+   * @param trailing The number of gaps after the sequence.
+   */
+  GappedRow(const std::vector<int>& content, size_t leading = 0, size_t trailing = 0) :
+    content_(&content),
+    leading_(leading),
+    trailing_(trailing)
+  {}
+
+public:
+  size_t size() const
+  {
+    return leading_ + (content_ ? content_->size() : 0) + trailing_;
+  }
+
+  int operator[](size_t i) const
+  {
+    if (!content_ || i < leading_)
+      return DnaTraits::GAP;
+    i -= leading_;
+    return i < content_->size() ? (*content_)[i] : DnaTraits::GAP;
+  }
+
+  bool isAllGaps() const { return !content_ || content_->empty(); }
+
+  size_t getNumberOfLeadingGaps() const { return leading_; }
+
+  size_t getNumberOfTrailingGaps() const { return trailing_; }
+};
+} // end of namespace bpp.
+
+#endif // _GAPPEDROW_H_
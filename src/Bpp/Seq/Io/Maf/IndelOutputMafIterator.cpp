@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "IndelOutputMafIterator.h"
+#include "DnaTraits.h"
+#include "StrandNormalizeMafIterator.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <ctime>
+
+using namespace std;
+
+void IndelOutputMafIterator::writeHeader_(ostream& out) const
+{
+  if (format_ == FORMAT_TABLE)
+  {
+    out << "Chr\tStart\tEnd\tType\tLength\tAllele\tPolarization\tCarriers" << endl;
+    return;
+  }
+  time_t t = time(0); // get current time
+  char date[16];
+  strftime(date, sizeof(date), "%Y%m%d", localtime(&t));
+  out << "##fileformat=VCFv4.2" << endl;
+  out << "##fileDate=" << date << endl;
+  out << "##source=Bio++" << endl;
+  out << "##INFO=<ID=TYPE,Number=1,Type=String,Description=\"Type of event relative to the reference (DEL or INS)\">" << endl;
+  out << "##INFO=<ID=LEN,Number=1,Type=Integer,Description=\"Number of deleted or inserted bases\">" << endl;
+  out << "##INFO=<ID=POL,Number=1,Type=String,Description=\"Polarization with the outgroup (derived, ancestral or .)\">" << endl;
+  out << "##INFO=<ID=AC,Number=A,Type=Integer,Description=\"Number of species carrying the event\">" << endl;
+  out << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">" << endl;
+  out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT";
+  for (const auto& sp : species_)
+  {
+    out << "\t" << sp;
+  }
+  out << endl;
+}
+
+size_t IndelOutputMafIterator::countGapsNotIn_(size_t row, size_t other, size_t begin, size_t end) const
+{
+  const uint64_t* x = getGaps_(row);
+  const uint64_t* y = getGaps_(other);
+  size_t n = 0;
+  for (size_t i = begin; i < end; )
+  {
+    size_t w = i >> 6;
+    size_t b = i & 63;
+    size_t len = min(static_cast<size_t>(64) - b, end - i);
+    uint64_t mask = (len == 64 ? ~0ULL : ((1ULL << len) - 1)) << b;
+    n += BitTools::popCount(x[w] & ~y[w] & mask);
+    i += len;
+  }
+  return n;
+}
+
+string IndelOutputMafIterator::getPolarization_(const Event_& event, bool hasOutgroup) const
+{
+  if (!hasOutgroup)
+    return ".";
+  size_t carrier = 2 + event.firstCarrier;
+  size_t nbOutgroupGaps;
+  size_t nbBases;
+  if (event.insertion)
+  {
+    // Bases of the carrier, where the reference has gaps:
+    nbBases = (event.end - event.begin) - BitTools::countBits(getGaps_(carrier), event.begin, event.end);
+    nbOutgroupGaps = countGapsNotIn_(1, carrier, event.begin, event.end);
+    if (nbOutgroupGaps == nbBases)
+      return "derived";
+  }
+  else
+  {
+    // Bases of the reference, where the carrier has gaps:
+    nbBases = (event.end - event.begin) - BitTools::countBits(getGaps_(0), event.begin, event.end);
+    nbOutgroupGaps = countGapsNotIn_(1, 0, event.begin, event.end);
+    if (nbOutgroupGaps == 0)
+      return "derived";
+  }
+  if (event.insertion ? nbOutgroupGaps == 0 : nbOutgroupGaps == nbBases)
+    return "ancestral";
+  return ".";
+}
+
+string IndelOutputMafIterator::getGenotype_(const Event_& event, size_t k, const vector<const MafSequence*>& sequences) const
+{
+  if (event.carriers[k])
+    return "1";
+  if (!sequences[2 + k])
+    return ".";
+  // The species does not carry the event, we check that it has the reference allele:
+  if (event.insertion)
+  {
+    if (BitTools::countBits(getGaps_(2 + k), event.begin, event.end) == event.end - event.begin)
+      return "0";
+  }
+  else
+  {
+    if (countGapsNotIn_(2 + k, 0, event.begin, event.end) == 0)
+      return "0";
+  }
+  return ".";
+}
+
+void IndelOutputMafIterator::writeBlock_(ostream& out, const MafBlock& block)
+{
+  if (!block.hasSequenceForSpecies(refSpecies_))
+    return;
+  const MafSequence& refSeq = block.sequenceForSpecies(refSpecies_);
+  if (refSeq.getStrand() == '-')
+  {
+    // Events are called on a reverse-complemented copy, the block itself is forwarded unchanged:
+    auto rcBlock = StrandNormalizeMafIterator::reverseComplement(block, buffer_);
+    writeBlock_(out, *rcBlock);
+    return;
+  }
+  const string& chr = refSeq.getChromosome();
+  size_t start = refSeq.start();
+  if (block.getNumberOfSites() == 0)
+    return;
+
+  // Build the gap bit vectors:
+  size_t nbRows = species_.size() + 2;
+  nbColumns_ = block.getNumberOfSites();
+  nbWords_ = BitTools::getNumberOfWords(nbColumns_);
+  gaps_.assign(nbRows * nbWords_, 0);
+  vector<const MafSequence*> sequences(nbRows, nullptr);
+  sequences[0] = &refSeq;
+  if (outgroup_ != "" && block.hasSequenceForSpecies(outgroup_))
+    sequences[1] = &block.sequenceForSpecies(outgroup_);
+  for (size_t k = 0; k < species_.size(); ++k)
+  {
+    if (block.hasSequenceForSpecies(species_[k]))
+      sequences[2 + k] = &block.sequenceForSpecies(species_[k]);
+  }
+  for (size_t r = 0; r < nbRows; ++r)
+  {
+    if (!sequences[r])
+      continue;
+    const vector<int>& content = sequences[r]->getContent();
+    uint64_t* words = &gaps_[r * nbWords_];
+    for (size_t j = 0; j < nbColumns_; ++j)
+    {
+      if (DnaTraits::isGap(content[j]))
+        BitTools::setBit(words, j);
+    }
+  }
+  const uint64_t* refGaps = getGaps_(0);
+  refGapPrefix_.resize(nbWords_ + 1);
+  refGapPrefix_[0] = 0;
+  for (size_t w = 0; w < nbWords_; ++w)
+  {
+    refGapPrefix_[w + 1] = refGapPrefix_[w] + BitTools::popCount(refGaps[w]);
+  }
+
+  // Call events, merging identical ones:
+  events_.clear();
+  map<tuple<bool, size_t, string>, size_t> index;
+  const vector<int>& refContent = refSeq.getContent();
+  auto record = [&](bool insertion, size_t begin, size_t end, const string& allele, size_t k) {
+        size_t refStart = start + getNumberOfReferenceBases_(begin);
+        auto key = make_tuple(insertion, refStart, allele);
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+          Event_ event;
+          event.insertion = insertion;
+          event.refStart = refStart;
+          event.allele = allele;
+          event.begin = begin;
+          event.end = end;
+          event.firstCarrier = k;
+          event.carriers.assign(species_.size(), false);
+          it = index.emplace(key, events_.size()).first;
+          events_.push_back(event);
+        }
+        events_[it->second].carriers[k] = true;
+      };
+  string allele;
+  for (size_t k = 0; k < species_.size(); ++k)
+  {
+    if (!sequences[2 + k])
+      continue;
+    const uint64_t* gaps = getGaps_(2 + k);
+    const vector<int>& content = sequences[2 + k]->getContent();
+
+    // Deletions: gap runs in the species, covering reference bases.
+    size_t a = BitTools::findNextSetBit(gaps, nbColumns_, 0);
+    while (a < nbColumns_)
+    {
+      size_t b = BitTools::findNextClearBit(gaps, nbColumns_, a);
+      allele.clear();
+      for (size_t c = BitTools::findNextClearBit(refGaps, b, a); c < b; c = BitTools::findNextClearBit(refGaps, b, c + 1))
+      {
+        allele += DnaTraits::intToChar(refContent[c]);
+      }
+      if (!allele.empty())
+        record(false, a, b, allele, k);
+      a = BitTools::findNextSetBit(gaps, nbColumns_, b);
+    }
+
+    // Insertions: gap runs in the reference, covering bases of the species.
+    a = BitTools::findNextSetBit(refGaps, nbColumns_, 0);
+    while (a < nbColumns_)
+    {
+      size_t b = BitTools::findNextClearBit(refGaps, nbColumns_, a);
+      allele.clear();
+      for (size_t c = BitTools::findNextClearBit(gaps, b, a); c < b; c = BitTools::findNextClearBit(gaps, b, c + 1))
+      {
+        allele += DnaTraits::intToChar(content[c]);
+      }
+      if (!allele.empty())
+        record(true, a, b, allele, k);
+      a = BitTools::findNextSetBit(refGaps, nbColumns_, b);
+    }
+  }
+  stable_sort(events_.begin(), events_.end(), [](const Event_& e1, const Event_& e2) {
+        return e1.refStart < e2.refStart;
+      });
+
+  // Output:
+  bool hasOutgroup = (sequences[1] != nullptr);
+  for (const auto& event : events_)
+  {
+    size_t ac = static_cast<size_t>(count(event.carriers.begin(), event.carriers.end(), true));
+    string polarization = getPolarization_(event, hasOutgroup);
+    string type = event.insertion ? "INS" : "DEL";
+    if (format_ == FORMAT_TABLE)
+    {
+      out << chr << "\t" << event.refStart << "\t" << (event.insertion ? event.refStart : event.refStart + event.allele.size());
+      out << "\t" << type << "\t" << event.allele.size() << "\t" << event.allele << "\t" << polarization << "\t";
+      bool first = true;
+      for (size_t k = 0; k < species_.size(); ++k)
+      {
+        if (event.carriers[k])
+        {
+          out << (first ? "" : ",") << species_[k];
+          first = false;
+        }
+      }
+      out << endl;
+      continue;
+    }
+
+    // VCF: find an anchor base, before the event if possible, after it otherwise.
+    size_t pos;
+    string refAllele, altAllele;
+    if (event.refStart > start)
+    {
+      size_t c = event.begin - 1;
+      while (DnaTraits::isGap(refContent[c]))
+      {
+        --c;
+      }
+      string anchor(1, DnaTraits::intToChar(refContent[c]));
+      pos = event.refStart; // 1-based position of the anchor.
+      refAllele = event.insertion ? anchor : anchor + event.allele;
+      altAllele = event.insertion ? anchor + event.allele : anchor;
+    }
+    else
+    {
+      size_t c = BitTools::findNextClearBit(refGaps, nbColumns_, event.end);
+      if (c >= nbColumns_)
+        continue; // No reference base to anchor the event.
+      string anchor(1, DnaTraits::intToChar(refContent[c]));
+      pos = event.refStart + 1;
+      refAllele = event.insertion ? anchor : event.allele + anchor;
+      altAllele = event.insertion ? event.allele + anchor : anchor;
+    }
+    out << chr << "\t" << pos << "\t.\t" << refAllele << "\t" << altAllele << "\t.\tPASS";
+    out << "\tTYPE=" << type << ";LEN=" << event.allele.size() << ";POL=" << polarization << ";AC=" << ac;
+    out << "\tGT";
+    for (size_t k = 0; k < species_.size(); ++k)
+    {
+      out << "\t" << getGenotype_(event, k, sequences);
+    }
+    out << endl;
+  }
+}
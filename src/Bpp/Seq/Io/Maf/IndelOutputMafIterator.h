@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _INDELOUTPUTMAFITERATOR_H_
+#define _INDELOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+#include "BitTools.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief This iterator calls insertions and deletions relative to a reference sequence,
+ * and outputs them in the Variant Call Format (VCF) or as a BED-like table.
+ *
+ * For each selected species, a deletion is a run of gaps in the species sequence covering at least one base of the reference,
+ * and an insertion is a run of gaps in the reference sequence covering at least one base of the species.
+ * Identical events in several species (same reference coordinates and same deleted or inserted bases) are merged into a single record.
+ *
+ * If an outgroup is given, events are polarized:
+ * - "derived" if the outgroup agrees with the reference (the event occurred in the lineage of the species carrying it),
+ * - "ancestral" if the outgroup agrees with the carrying species (the opposite event occurred in the lineage of the reference,
+ *   that is, a deletion relative to the reference is an insertion in the reference lineage, and conversely),
+ * - "." if the outgroup is missing from the block or only partially agrees with either.
+ *
+ * Gap runs are found by scanning bit vectors of gap positions word by word, and the number of bases in each run
+ * is obtained by counting bits, so that the cost of a block is mostly proportional to the number of gap runs.
+ * Memory usage is proportional to the size of the block.
+ *
+ * Events are reported on the positive strand of the reference: blocks where the reference sequence is on the negative strand
+ * are reverse-complemented before calling events (see StrandNormalizeMafIterator), but are forwarded unchanged.
+ * Blocks without the reference species are forwarded without output.
+ * In VCF output, events are anchored on the preceding reference base,
+ * or on the following one at the start of a block, as recommended by the VCF specification.
+ * Events covering the whole reference sequence of a block cannot be anchored and are only written in table output.
+ */
+class IndelOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+public:
+  static constexpr short FORMAT_VCF = 0;
+  static constexpr short FORMAT_TABLE = 1;
+
+private:
+  struct Event_
+  {
+    bool insertion;
+    size_t refStart;    // 0-based, on the reference sequence.
+    std::string allele; // Deleted reference bases or inserted bases.
+    size_t begin;       // First column of the event in the block, for the first carrier.
+    size_t end;         // Column after the event in the block, for the first carrier.
+    size_t firstCarrier;
+    std::vector<bool> carriers;
+
+    Event_() : insertion(false), refStart(0), allele(), begin(0), end(0), firstCarrier(0), carriers() {}
+  };
+
+private:
+  std::shared_ptr<std::ostream> output_;
+  std::string refSpecies_;
+  std::vector<std::string> species_;
+  std::string outgroup_;
+  short format_;
+  size_t nbColumns_;
+  size_t nbWords_;
+  std::vector<uint64_t> gaps_; // One bit vector per row: reference, outgroup, then selected species.
+  std::vector<size_t> refGapPrefix_;
+  std::vector<Event_> events_;
+  std::vector<int> buffer_; // Used to reverse-complement blocks.
+
+public:
+  /**
+   * @brief Build a new IndelOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param out The output stream.
+   * @param reference The species to use as a reference.
+   * @param species A list of species in which events are called. In case one species is duplicated in a block,
+   * the first sequence will be used. In VCF output, there is one genotype column per species.
+   * @param outgroup The species to use for polarization, or an empty string for unpolarized events.
+   * @param format The output format, one of FORMAT_VCF or FORMAT_TABLE.
+   */
+  IndelOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      const std::string& reference,
+      const std::vector<std::string>& species,
+      const std::string& outgroup = "",
+      short format = FORMAT_VCF) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    refSpecies_(reference),
+    species_(species),
+    outgroup_(outgroup),
+    format_(format),
+    nbColumns_(0),
+    nbWords_(0),
+    gaps_(),
+    refGapPrefix_(),
+    events_(),
+    buffer_()
+  {
+    if (species_.empty())
+      throw Exception("IndelOutputMafIterator. At least one species should be provided.");
+    if (format_ != FORMAT_VCF && format_ != FORMAT_TABLE)
+      throw Exception("IndelOutputMafIterator. Unknown output format: " + TextTools::toString(format_) + ".");
+    if (output_)
+      writeHeader_(*output_);
+  }
+
+private:
+  IndelOutputMafIterator(const IndelOutputMafIterator& iterator) :
+    AbstractFilterMafIterator(0),
+    output_(iterator.output_),
+    refSpecies_(iterator.refSpecies_),
+    species_(iterator.species_),
+    outgroup_(iterator.outgroup_),
+    format_(iterator.format_),
+    nbColumns_(0),
+    nbWords_(0),
+    gaps_(),
+    refGapPrefix_(),
+    events_(),
+    buffer_()
+  {}
+
+  IndelOutputMafIterator& operator=(const IndelOutputMafIterator& iterator)
+  {
+    output_     = iterator.output_;
+    refSpecies_ = iterator.refSpecies_;
+    species_    = iterator.species_;
+    outgroup_   = iterator.outgroup_;
+    format_     = iterator.format_;
+    return *this;
+  }
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (output_ && currentBlock_)
+      writeBlock_(*output_, *currentBlock_);
+    return std::move(currentBlock_);
+  }
+
+private:
+  void writeHeader_(std::ostream& out) const;
+
+  void writeBlock_(std::ostream& out, const MafBlock& block);
+
+  const uint64_t* getGaps_(size_t row) const { return &gaps_[row * nbWords_]; }
+
+  /**
+   * @return The number of reference bases before a column.
+   */
+  size_t getNumberOfReferenceBases_(size_t column) const
+  {
+    return column - (refGapPrefix_[column >> 6] + BitTools::countBits(getGaps_(0), column & ~static_cast<size_t>(63), column));
+  }
+
+  /**
+   * @return The number of positions in [begin, end[ which are gaps in a row, and not in another one.
+   */
+  size_t countGapsNotIn_(size_t row, size_t other, size_t begin, size_t end) const;
+
+  std::string getPolarization_(const Event_& event, bool hasOutgroup) const;
+
+  std::string getGenotype_(const Event_& event, size_t k, const std::vector<const MafSequence*>& sequences) const;
+};
+} // end of namespace bpp.
+
+#endif // _INDELOUTPUTMAFITERATOR_H_
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "LinkageDisequilibriumOutputMafIterator.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+void LinkageDisequilibriumOutputMafIterator::writeBlock_(std::ostream& out, const MafBlock& block)
+{
+  if (!block.hasSequenceForSpecies(refSpecies_))
+    return;
+  const MafSequence& refSeq = block.sequenceForSpecies(refSpecies_);
+  if (!refSeq.hasCoordinates())
+    return;
+
+  vector<const MafSequence*> selection;
+  for (const auto& sp : species_)
+  {
+    vector<const MafSequence*> tmp = block.getSequencesForSpecies(sp);
+    selection.insert(selection.end(), tmp.begin(), tmp.end());
+  }
+  haplotypes_.build(selection, &refSeq);
+
+  const string& chr = refSeq.getChromosome();
+  bool negative = (refSeq.getStrand() == '-');
+  size_t srcSize = refSeq.getSrcSize();
+  auto write = [&](size_t i, size_t j, const PairwiseLinkageDisequilibrium& ld)
+               {
+                 if (ld.r2 < minR2_)
+                   return;
+                 size_t pos1 = haplotypes_.getPosition(i);
+                 size_t pos2 = haplotypes_.getPosition(j);
+                 if (negative)
+                 {
+                   pos1 = srcSize - pos1 - 1;
+                   pos2 = srcSize - pos2 - 1;
+                   swap(pos1, pos2);
+                 }
+                 out << chr << "\t" << (pos1 + 1) << "\t" << (pos2 + 1) << "\t" << ld.n << "\t" << ld.d << "\t" << ld.r2 << "\t" << ld.dPrime << "\n";
+               };
+  haplotypes_.computeAllPairs(maxDistance_, write);
+}
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _LINKAGEDISEQUILIBRIUMOUTPUTMAFITERATOR_H_
+#define _LINKAGEDISEQUILIBRIUMOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+#include "BiallelicHaplotypeMatrix.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <deque>
+
+namespace bpp
+{
+/**
+ * @brief This iterator computes pairwise linkage disequilibrium between biallelic sites within each block,
+ * and outputs it as a sparse matrix.
+ *
+ * Each line of the output contains the chromosome, the positions of the two sites (1-based, on the positive strand of the reference sequence),
+ * the number of haplotypes with data at both sites, D, r² and D'.
+ * Only pairs of sites closer than a given distance, and with a r² at least equal to a given threshold, are written.
+ * Blocks without the reference species are forwarded without output.
+ */
+class LinkageDisequilibriumOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+private:
+  std::shared_ptr<std::ostream> output_;
+  std::vector<std::string> species_;
+  std::string refSpecies_;
+  size_t maxDistance_;
+  double minR2_;
+  BiallelicHaplotypeMatrix haplotypes_;
+
+public:
+  /**
+   * @brief Build a new LinkageDisequilibriumOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param out The output stream where to write the sparse LD matrix.
+   * @param species A list of species to use as haplotypes.
+   * @param reference The species to use as a reference for coordinates.
+   * It does not have to be one of the selected species.
+   * @param maxDistance The maximum distance between two sites, on the reference sequence.
+   * @param minR2 The minimum r² value for a pair to be written.
+   */
+  LinkageDisequilibriumOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      const std::vector<std::string>& species,
+      const std::string& reference,
+      size_t maxDistance,
+      double minR2 = 0.) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    species_(species),
+    refSpecies_(reference),
+    maxDistance_(maxDistance),
+    minR2_(minR2),
+    haplotypes_()
+  {
+    if (output_)
+      *output_ << "Chr\tPos1\tPos2\tN\tD\tR2\tDprime" << std::endl;
+  }
+
+private:
+  LinkageDisequilibriumOutputMafIterator(const LinkageDisequilibriumOutputMafIterator& iterator) :
+    AbstractFilterMafIterator(0),
+    output_(iterator.output_),
+    species_(iterator.species_),
+    refSpecies_(iterator.refSpecies_),
+    maxDistance_(iterator.maxDistance_),
+    minR2_(iterator.minR2_),
+    haplotypes_()
+  {}
+
+  LinkageDisequilibriumOutputMafIterator& operator=(const LinkageDisequilibriumOutputMafIterator& iterator)
+  {
+    output_ = iterator.output_;
+    species_ = iterator.species_;
+    refSpecies_ = iterator.refSpecies_;
+    maxDistance_ = iterator.maxDistance_;
+    minR2_ = iterator.minR2_;
+    return *this;
+  }
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (output_ && currentBlock_)
+      writeBlock_(*output_, *currentBlock_);
+    return std::move(currentBlock_);
+  }
+
+private:
+  void writeBlock_(std::ostream& out, const MafBlock& block);
+};
+} // end of namespace bpp.
+
+#endif // _LINKAGEDISEQUILIBRIUMOUTPUTMAFITERATOR_H_
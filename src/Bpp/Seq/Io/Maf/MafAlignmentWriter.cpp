@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MafAlignmentWriter.h"
+#include "DnaTraits.h"
+
+// From bpp-seq:
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+void AbstractMafAlignmentWriter::formatName_(const MafSequence& seq, string& name) const
+{
+  name.clear();
+  if (nameTemplate_ == "" || !seq.hasCoordinates())
+  {
+    name = seq.getSpecies();
+    return;
+  }
+  for (size_t i = 0; i < nameTemplate_.size(); ++i)
+  {
+    char c = nameTemplate_[i];
+    if (c == '%' && i + 1 < nameTemplate_.size())
+    {
+      switch (nameTemplate_[i + 1])
+      {
+      case 's': name += seq.getSpecies(); ++i; continue;
+      case 'c': name += seq.getChromosome(); ++i; continue;
+      case 't': name += seq.getStrand(); ++i; continue;
+      case 'b': name += TextTools::toString(seq.start() + 1); ++i; continue;
+      case 'e': name += TextTools::toString(seq.stop() + 1); ++i; continue;
+      default: break;
+      }
+    }
+    name += c;
+  }
+}
+
+void AbstractMafAlignmentWriter::formatNames_(const MafBlock& block)
+{
+  size_t n = block.getNumberOfSequences();
+  if (names_.size() < n)
+    names_.resize(n);
+  maxNameLength_ = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    formatName_(block.sequence(i), names_[i]);
+    maxNameLength_ = max(maxNameLength_, names_[i].size());
+  }
+}
+
+void AbstractMafAlignmentWriter::formatRow_(const MafSequence& seq, string& row) const
+{
+  const vector<int>& content = seq.getContent();
+  row.resize(content.size());
+  for (size_t j = 0; j < content.size(); ++j)
+  {
+    row[j] = DnaTraits::intToChar(content[j]);
+  }
+  if (mask_ && seq.hasAnnotation(SequenceMask::MASK))
+  {
+    const vector<bool>& mask = dynamic_cast<const SequenceMask&>(seq.annotation(SequenceMask::MASK)).getMask();
+    for (size_t j = 0; j < min(mask.size(), row.size()); ++j)
+    {
+      if (mask[j])
+        row[j] = static_cast<char>(tolower(static_cast<int>(row[j])));
+    }
+  }
+}
+
+void AbstractMafAlignmentWriter::formatRows_(const MafBlock& block)
+{
+  size_t n = block.getNumberOfSequences();
+  if (rows_.size() < n)
+    rows_.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    formatRow_(block.sequence(i), rows_[i]);
+  }
+}
+
+void FastaMafAlignmentWriter::writeBlock(ostream& out, const MafBlock& block)
+{
+  formatNames_(block);
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    formatRow_(block.sequence(i), row_);
+    out << ">" << names_[i] << "\n";
+    size_t step = lineLength_ > 0 ? lineLength_ : max(row_.size(), static_cast<size_t>(1));
+    for (size_t j = 0; j < row_.size(); j += step)
+    {
+      writeChunk_(out, row_, j, step);
+      out << "\n";
+    }
+  }
+}
+
+void PhylipMafAlignmentWriter::writeBlock(ostream& out, const MafBlock& block)
+{
+  formatNames_(block);
+  out << block.getNumberOfSequences() << " " << block.getNumberOfSites() << "\n";
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    formatRow_(block.sequence(i), row_);
+    out << names_[i] << string(maxNameLength_ - names_[i].size() + 2, ' ') << row_ << "\n";
+  }
+}
+
+void ClustalMafAlignmentWriter::writeBlock(ostream& out, const MafBlock& block)
+{
+  formatNames_(block);
+  formatRows_(block);
+  size_t n = block.getNumberOfSequences();
+  size_t nbSites = block.getNumberOfSites();
+  size_t width = maxNameLength_ + 6;
+  size_t step = lineLength_ > 0 ? lineLength_ : max(nbSites, static_cast<size_t>(1));
+  string conservation;
+  out << "CLUSTAL W multiple sequence alignment\n\n";
+  for (size_t j = 0; j < nbSites; j += step)
+  {
+    size_t len = min(step, nbSites - j);
+    for (size_t i = 0; i < n; ++i)
+    {
+      out << names_[i] << string(width - names_[i].size(), ' ');
+      writeChunk_(out, rows_[i], j, len);
+      out << "\n";
+    }
+    conservation.assign(len, ' ');
+    for (size_t k = 0; k < len && n > 0; ++k)
+    {
+      int c = toupper(static_cast<int>(rows_[0][j + k]));
+      bool conserved = (c != '-');
+      for (size_t i = 1; conserved && i < n; ++i)
+      {
+        conserved = (toupper(static_cast<int>(rows_[i][j + k])) == c);
+      }
+      if (conserved)
+        conservation[k] = '*';
+    }
+    out << string(width, ' ') << conservation << "\n\n";
+  }
+}
+
+void NexusMafAlignmentWriter::quoteName_(string& name)
+{
+  bool needQuotes = false;
+  for (char c : name)
+  {
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '.')
+    {
+      needQuotes = true;
+      break;
+    }
+  }
+  if (needQuotes)
+  {
+    // Single quotes are escaped by doubling them:
+    TextTools::replaceAll(name, "'", "''");
+    name = "'" + name + "'";
+  }
+}
+
+void NexusMafAlignmentWriter::writeBlock(ostream& out, const MafBlock& block)
+{
+  formatNames_(block);
+  size_t n = block.getNumberOfSequences();
+  maxNameLength_ = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    quoteName_(names_[i]);
+    maxNameLength_ = max(maxNameLength_, names_[i].size());
+  }
+  out << "#NEXUS\n\nBEGIN DATA;\n";
+  out << "  DIMENSIONS NTAX=" << n << " NCHAR=" << block.getNumberOfSites() << ";\n";
+  out << "  FORMAT DATATYPE=DNA MISSING=? GAP=-;\n";
+  out << "  MATRIX\n";
+  for (size_t i = 0; i < n; ++i)
+  {
+    formatRow_(block.sequence(i), row_);
+    out << "    " << names_[i] << string(maxNameLength_ - names_[i].size() + 2, ' ') << row_ << "\n";
+  }
+  out << "  ;\nEND;\n";
+}
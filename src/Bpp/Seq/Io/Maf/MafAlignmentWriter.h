@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MAFALIGNMENTWRITER_H_
+#define _MAFALIGNMENTWRITER_H_
+
+#include "MafBlock.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace bpp
+{
+/**
+ * @brief Interface for writers formatting alignments directly from MafBlock rows.
+ *
+ * Contrarily to the OAlignment writers of bpp-seq, these writers do not need the block
+ * to be converted to an AlignedSequenceContainer first.
+ */
+class MafAlignmentWriterInterface
+{
+public:
+  MafAlignmentWriterInterface() {}
+  virtual ~MafAlignmentWriterInterface() {}
+
+public:
+  /**
+   * @brief Write a block as an alignment.
+   *
+   * @param out The output stream.
+   * @param block The block to write.
+   */
+  virtual void writeBlock(std::ostream& out, const MafBlock& block) = 0;
+
+  virtual std::string getFormatName() const = 0;
+};
+
+
+/**
+ * @brief Partial implementation of MafAlignmentWriterInterface.
+ *
+ * Sequence names are generated from a template, in which the following codes are replaced:
+ * - %s: species name,
+ * - %c: chromosome name,
+ * - %t: strand,
+ * - %b: start position (1-based),
+ * - %e: stop position (1-based).
+ * The template is used for sequences with coordinates. For sequences without coordinates,
+ * or if the template is empty, the species name is used.
+ *
+ * If masking is enabled, masked positions (see SequenceMask) are written in lowercase.
+ *
+ * Names and rows are formatted in buffers which are reused from one block to the next.
+ */
+class AbstractMafAlignmentWriter :
+  public virtual MafAlignmentWriterInterface
+{
+private:
+  std::string nameTemplate_;
+  bool mask_;
+
+protected:
+  size_t lineLength_;
+  std::vector<std::string> names_;
+  std::vector<std::string> rows_;
+  std::string row_;
+  size_t maxNameLength_;
+
+public:
+  /**
+   * @param nameTemplate The template for sequence names.
+   * @param lineLength The maximum number of characters per line, 0 for no limit.
+   */
+  AbstractMafAlignmentWriter(const std::string& nameTemplate, size_t lineLength) :
+    nameTemplate_(nameTemplate),
+    mask_(false),
+    lineLength_(lineLength),
+    names_(),
+    rows_(),
+    row_(),
+    maxNameLength_(0)
+  {}
+
+  virtual ~AbstractMafAlignmentWriter() {}
+
+public:
+  const std::string& getNameTemplate() const { return nameTemplate_; }
+
+  void setNameTemplate(const std::string& nameTemplate) { nameTemplate_ = nameTemplate; }
+
+  size_t getLineLength() const { return lineLength_; }
+
+  void setLineLength(size_t lineLength) { lineLength_ = lineLength; }
+
+  bool isMasked() const { return mask_; }
+
+  /**
+   * @param mask Tell if masked positions should be written in lowercase.
+   */
+  void setMask(bool mask) { mask_ = mask; }
+
+protected:
+  /**
+   * @brief Format the name of a sequence.
+   *
+   * @param seq The sequence.
+   * @param name The string where to write the name. Its content is replaced.
+   */
+  void formatName_(const MafSequence& seq, std::string& name) const;
+
+  /**
+   * @brief Format all names of a block in names_, and compute maxNameLength_.
+   *
+   * @param block The input block.
+   */
+  void formatNames_(const MafBlock& block);
+
+  /**
+   * @brief Format a row as a character string.
+   *
+   * @param seq The sequence to format.
+   * @param row The string where to write the row. Its content is replaced.
+   */
+  void formatRow_(const MafSequence& seq, std::string& row) const;
+
+  /**
+   * @brief Format all rows of a block as character strings in rows_.
+   *
+   * @param block The input block.
+   */
+  void formatRows_(const MafBlock& block);
+
+  /**
+   * @brief Write a part of a row.
+   *
+   * @param out The output stream.
+   * @param row The row to write.
+   * @param begin The first character to write.
+   * @param length The maximum number of characters to write.
+   */
+  static void writeChunk_(std::ostream& out, const std::string& row, size_t begin, size_t length)
+  {
+    if (begin < row.size())
+      out.write(row.data() + begin, static_cast<std::streamsize>(std::min(length, row.size() - begin)));
+  }
+};
+
+
+/**
+ * @brief Write blocks in FASTA format.
+ */
+class FastaMafAlignmentWriter :
+  public AbstractMafAlignmentWriter
+{
+public:
+  FastaMafAlignmentWriter(const std::string& nameTemplate = "", size_t lineLength = 100) :
+    AbstractMafAlignmentWriter(nameTemplate, lineLength)
+  {}
+
+public:
+  void writeBlock(std::ostream& out, const MafBlock& block) override;
+
+  std::string getFormatName() const override { return "FASTA"; }
+};
+
+
+/**
+ * @brief Write blocks in relaxed sequential PHYLIP format.
+ *
+ * Names are followed by two spaces and the sequence, on a single line.
+ * Names are not truncated, and should therefore not contain spaces.
+ */
+class PhylipMafAlignmentWriter :
+  public AbstractMafAlignmentWriter
+{
+public:
+  PhylipMafAlignmentWriter(const std::string& nameTemplate = "") :
+    AbstractMafAlignmentWriter(nameTemplate, 0)
+  {}
+
+public:
+  void writeBlock(std::ostream& out, const MafBlock& block) override;
+
+  std::string getFormatName() const override { return "PHYLIP"; }
+};
+
+
+/**
+ * @brief Write blocks in Clustal format.
+ *
+ * Rows are interleaved, and each chunk is followed by a conservation line,
+ * where '*' marks columns with the same nucleotide in all sequences.
+ */
+class ClustalMafAlignmentWriter :
+  public AbstractMafAlignmentWriter
+{
+public:
+  ClustalMafAlignmentWriter(const std::string& nameTemplate = "", size_t lineLength = 60) :
+    AbstractMafAlignmentWriter(nameTemplate, lineLength)
+  {}
+
+public:
+  void writeBlock(std::ostream& out, const MafBlock& block) override;
+
+  std::string getFormatName() const override { return "Clustal"; }
+};
+
+
+/**
+ * @brief Write blocks in NEXUS format, as a DATA block.
+ *
+ * Names with characters other than letters, digits, '_' and '.' are quoted.
+ */
+class NexusMafAlignmentWriter :
+  public AbstractMafAlignmentWriter
+{
+public:
+  NexusMafAlignmentWriter(const std::string& nameTemplate = "") :
+    AbstractMafAlignmentWriter(nameTemplate, 0)
+  {}
+
+public:
+  void writeBlock(std::ostream& out, const MafBlock& block) override;
+
+  std::string getFormatName() const override { return "NEXUS"; }
+
+private:
+  static void quoteName_(std::string& name);
+};
+} // end of namespace bpp.
+
+#endif // _MAFALIGNMENTWRITER_H_
@@ -7,65 +7,93 @@
 
 #include "MafSequence.h"
 #include <Bpp/Seq/Container/AlignedSequenceContainer.h>
+#include <Bpp/Seq/Container/VectorSiteContainer.h>
 #include <Bpp/Seq/Container/SequenceContainerTools.h>
 
 #include <Bpp/Clonable.h>
 
+// From the STL:
+#include <vector>
+#include <map>
+#include <memory>
+
 namespace bpp
 {
 /**
  * @brief A synteny block data structure, the basic unit of a MAF alignment file.
  *
- * This class basically contains a AlignedSequenceContainer made of MafSequence objects.
+ * This class contains a list of aligned MafSequence objects, called rows.
+ *
+ * Rows are immutable once added, and are shared between copies of a block: copying a block only copies
+ * one pointer per row, and moving a block moves the list of rows. A row is copied only when it is modified
+ * through mutableSequence() while it is shared with another block (copy-on-write), so that copies never affect each other.
+ * Properties are shared in the same way, and setting a property in a copy replaces the shared data in this copy only.
+ *
+ * Sites are built on demand from the rows, when site() is first called, and discarded when the block is modified.
  */
 class MafBlock :
-  protected TemplateAlignedSequenceContainer<MafSequence, Site>
+  public virtual Clonable
 {
 private:
   double score_;
   unsigned int pass_;
-  std::map<std::string, std::unique_ptr<Clonable>> properties_;
-  unsigned int idCounter_;
+  std::vector<std::shared_ptr<const MafSequence>> rows_;
+  std::map<std::string, std::shared_ptr<const Clonable>> properties_;
+  mutable std::unique_ptr<VectorSiteContainer> sites_;
 
 public:
   MafBlock() :
-    TemplateAlignedSequenceContainer(AlphabetTools::DNA_ALPHABET),
     score_(log(0)),
     pass_(0),
+    rows_(),
     properties_(),
-    idCounter_(0)
+    sites_()
   {}
 
   MafBlock(const MafBlock& block) :
-    TemplateAlignedSequenceContainer(block),
     score_(block.score_),
     pass_(block.pass_),
-    properties_(),
-    idCounter_(block.idCounter_)
+    rows_(block.rows_),
+    properties_(block.properties_),
+    sites_()
+  {}
+
+  MafBlock(MafBlock&& block) :
+    score_(block.score_),
+    pass_(block.pass_),
+    rows_(std::move(block.rows_)),
+    properties_(std::move(block.properties_)),
+    sites_(std::move(block.sites_))
   {
-    for (const auto& it : block.properties_)
-    {
-      properties_[it.first].reset(it.second->clone());
-    }
+    block.rows_.clear();
+    block.properties_.clear();
   }
 
   MafBlock& operator=(const MafBlock& block)
   {
-    TemplateAlignedSequenceContainer::operator=(block),
-    score_     = block.score_;
-    pass_      = block.pass_;
-    deleteProperties_();
-    for (const auto& it : block.properties_)
-    {
-      properties_[it.first].reset(it.second->clone());
-    }
-    idCounter_ = block.idCounter_;
+    score_      = block.score_;
+    pass_       = block.pass_;
+    rows_       = block.rows_;
+    properties_ = block.properties_;
+    sites_.reset();
+    return *this;
+  }
+
+  MafBlock& operator=(MafBlock&& block)
+  {
+    score_      = block.score_;
+    pass_       = block.pass_;
+    rows_       = std::move(block.rows_);
+    properties_ = std::move(block.properties_);
+    sites_      = std::move(block.sites_);
+    block.rows_.clear();
+    block.properties_.clear();
     return *this;
   }
 
   MafBlock* clone() const override { return new MafBlock(*this); }
 
-  virtual ~MafBlock() { deleteProperties_(); }
+  virtual ~MafBlock() {}
 
 public:
   void setScore(double score) { score_ = score; }
@@ -77,40 +105,144 @@ public:
   std::unique_ptr<AlignedSequenceContainer> getAlignment() const
   {
     auto aln = std::make_unique<AlignedSequenceContainer>(AlphabetTools::DNA_ALPHABET);
-    SequenceContainerTools::convertContainer<TemplateAlignedSequenceContainer<MafSequence, Site>, AlignedSequenceContainer, Sequence>(*this, *aln);
+    for (size_t i = 0; i < rows_.size(); ++i)
+    {
+      auto tmpSeq = std::make_unique<Sequence>(*rows_[i]);
+      aln->addSequence("maf_seq_" + TextTools::toString(i), tmpSeq);
+    }
     return aln;
   }
 
-  void addSequence(std::unique_ptr<MafSequence>& sequence) override
+  /**
+   * @brief Add a row to the block.
+   *
+   * @param sequence The sequence to add, which is taken over by the block.
+   * @throw Exception if the sequence does not have the length of the alignment.
+   */
+  void addSequence(std::unique_ptr<MafSequence>& sequence)
   {
-    std::string key = "maf_seq_" + TextTools::toString(idCounter_++);
-    TemplateAlignedSequenceContainer::addSequence(key, sequence);
+    if (!sequence)
+      throw Exception("MafBlock::addSequence. Pointer to sequence is nullptr.");
+    if (rows_.size() > 0 && sequence->size() != getNumberOfSites())
+      throw Exception("MafBlock::addSequence. Sequence " + sequence->getName() + " does not have the length of the alignment: " + TextTools::toString(sequence->size()) + ", should be " + TextTools::toString(getNumberOfSites()) + ".");
+    rows_.push_back(std::shared_ptr<const MafSequence>(std::move(sequence)));
+    sites_.reset();
   }
 
-  using TemplateAlignedSequenceContainer::getAlphabet;
+  std::shared_ptr<const Alphabet> getAlphabet() const { return AlphabetTools::DNA_ALPHABET; }
 
-  using TemplateAlignedSequenceContainer::alphabet;
+  const Alphabet& alphabet() const { return *AlphabetTools::DNA_ALPHABET; }
 
-  using TemplateAlignedSequenceContainer::getSequenceNames;
+  std::vector<std::string> getSequenceNames() const
+  {
+    std::vector<std::string> names(rows_.size());
+    for (size_t i = 0; i < rows_.size(); ++i)
+    {
+      names[i] = rows_[i]->getName();
+    }
+    return names;
+  }
 
-  using TemplateAlignedSequenceContainer::getNumberOfSequences;
+  size_t getNumberOfSequences() const { return rows_.size(); }
 
-  using TemplateAlignedSequenceContainer::getNumberOfSites;
+  size_t getNumberOfSites() const { return rows_.empty() ? 0 : rows_[0]->size(); }
 
-  using TemplateAlignedSequenceContainer::site;
+  /**
+   * @return A site of the alignment. The reference is valid until the block is modified.
+   * @param i The index of the site.
+   */
+  const Site& site(size_t i) const
+  {
+    if (i >= getNumberOfSites())
+      throw Exception("MafBlock::site. Index out of bounds: " + TextTools::toString(i) + ".");
+    if (!sites_)
+    {
+      sites_ = std::make_unique<VectorSiteContainer>(AlphabetTools::DNA_ALPHABET);
+      for (size_t k = 0; k < rows_.size(); ++k)
+      {
+        auto tmpSeq = std::make_unique<Sequence>(*rows_[k]);
+        sites_->addSequence("maf_seq_" + TextTools::toString(k), tmpSeq);
+      }
+    }
+    return sites_->site(i);
+  }
 
-  using TemplateAlignedSequenceContainer::deleteSite;
+  void deleteSite(size_t i)
+  {
+    deleteSites(i, 1);
+  }
 
-  using TemplateAlignedSequenceContainer::deleteSites;
+  void deleteSites(size_t i, size_t length)
+  {
+    if (i + length > getNumberOfSites())
+      throw Exception("MafBlock::deleteSites. Index out of bounds: " + TextTools::toString(i + length) + ".");
+    for (size_t k = 0; k < rows_.size(); ++k)
+    {
+      mutableSequence(k).deleteElements(i, length);
+    }
+  }
 
+  /**
+   * @return True if the block has a row with the given name.
+   * @param name The name of the sequence.
+   */
+  bool hasSequence(const std::string& name) const
+  {
+    for (const auto& row : rows_)
+    {
+      if (row->getName() == name)
+        return true;
+    }
+    return false;
+  }
 
-  using TemplateAlignedSequenceContainer::hasSequence;
+  const MafSequence& sequence(size_t i) const
+  {
+    if (i >= rows_.size())
+      throw Exception("MafBlock::sequence. Index out of bounds: " + TextTools::toString(i) + ".");
+    return *rows_[i];
+  }
 
-  using TemplateAlignedSequenceContainer::sequence;
+  /**
+   * @brief Get a modifiable reference to a row.
+   *
+   * The row is copied first if it is shared with other blocks, so that they are not affected.
+   * The sequence must keep the length of the alignment.
+   * The reference is valid until the block is modified again.
+   *
+   * @param i The index of the row.
+   * @return A reference to a row owned by this block only.
+   */
+  MafSequence& mutableSequence(size_t i)
+  {
+    if (i >= rows_.size())
+      throw Exception("MafBlock::mutableSequence. Index out of bounds: " + TextTools::toString(i) + ".");
+    if (rows_[i].use_count() > 1)
+      rows_[i] = std::make_shared<MafSequence>(*rows_[i]);
+    sites_.reset();
+    // The row is not shared, and was created non-const by addSequence or by the copy above:
+    return const_cast<MafSequence&>(*rows_[i]);
+  }
 
-  using TemplateAlignedSequenceContainer::removeSequence;
+  /**
+   * @return True if a row is shared with another block.
+   * @param i The index of the row.
+   */
+  bool isSequenceShared(size_t i) const { return rows_[i].use_count() > 1; }
 
-  using TemplateAlignedSequenceContainer::clear;
+  void removeSequence(size_t i)
+  {
+    if (i >= rows_.size())
+      throw Exception("MafBlock::removeSequence. Index out of bounds: " + TextTools::toString(i) + ".");
+    rows_.erase(rows_.begin() + static_cast<std::ptrdiff_t>(i));
+    sites_.reset();
+  }
+
+  void clear()
+  {
+    rows_.clear();
+    sites_.reset();
+  }
 
   bool hasSequenceForSpecies(const std::string& species) const
   {
@@ -163,10 +295,7 @@ public:
 
   void removeCoordinatesFromSequence(size_t i)
   {
-    // This is a bit of a trick, but avoid useless recopies.
-    // It is safe here because the AlignedSequenceContainer is fully encapsulated.
-    // It would not work if a VectorSiteContainer was used.
-    const_cast<MafSequence&>(sequence(i)).removeCoordinates();
+    mutableSequence(i).removeCoordinates();
   }
 
   std::string getDescription() const
@@ -219,6 +348,7 @@ public:
    * @brief Set the data associated to a query property.
    *
    * An existing data associated to this property will be deleted and replaced by the new one.
+   * Copies of this block sharing the previous data are not affected.
    * @param property The property to look for.
    * @param data The data to associate to this property.
    * @throw Exception if the pointer toward the input data is NULL.
@@ -227,18 +357,23 @@ public:
   {
     if (!data)
       throw Exception("MafBlock::setProperty. Pointer to data is nullptr.");
-    if (hasProperty(property))
-      deleteProperty(property);
-    properties_[property] = std::move(data);
+    properties_[property] = std::shared_ptr<const Clonable>(std::move(data));
   }
 
-private:
-  using TemplateAlignedSequenceContainer::addSequence;
-
-  void deleteProperties_()
+  /**
+   * @brief Share all properties of another block.
+   *
+   * Existing properties with the same names are replaced, other ones are kept.
+   * @param block The block to copy properties from.
+   */
+  void copyProperties(const MafBlock& block)
   {
-    properties_.clear();
+    for (const auto& it : block.properties_)
+    {
+      properties_[it.first] = it.second;
+    }
   }
+
 };
 } // end of namespace bpp.
 
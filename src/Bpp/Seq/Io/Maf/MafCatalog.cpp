@@ -0,0 +1,354 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MafCatalog.h"
+#include "MafSequence.h"
+#include "../BinaryIoTools.h"
+#include "BitTools.h"
+
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+const uint32_t FORMAT_VERSION = 1;
+const size_t ENTRY_SIZE = 57;
+
+/**
+ * @brief Split a line into whitespace-separated fields, without copying them.
+ *
+ * @return The number of fields found, at most maxFields.
+ */
+size_t splitFields(const string& line, vector< pair<size_t, size_t> >& fields, size_t maxFields)
+{
+  fields.clear();
+  size_t i = 0;
+  while (fields.size() < maxFields)
+  {
+    size_t b = line.find_first_not_of(" \t\r", i);
+    if (b == string::npos)
+      break;
+    size_t e = line.find_first_of(" \t\r", b);
+    if (e == string::npos)
+      e = line.size();
+    fields.push_back(make_pair(b, e - b));
+    i = e;
+  }
+  return fields.size();
+}
+
+uint64_t toUInt64(const string& line, const pair<size_t, size_t>& field)
+{
+  uint64_t x = 0;
+  for (size_t k = field.first; k < field.first + field.second; ++k)
+  {
+    char c = line[k];
+    if (c < '0' || c > '9')
+      throw IOException("MafCatalog::build. Invalid number in line: " + line);
+    x = x * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return x;
+}
+}
+
+void MafCatalog::build(istream& input)
+{
+  species_.clear();
+  speciesIds_.clear();
+  chromosomes_.clear();
+  chromosomeIds_.clear();
+  entries_.clear();
+  masks_.clear();
+  nbWords_ = 0;
+
+  // Species indices of each block, converted to masks when the number of species is known:
+  vector< vector<size_t> > blockSpecies;
+  string line;
+  vector< pair<size_t, size_t> > fields;
+  uint64_t offset = 0;
+  bool inBlock = false;
+  bool refFound = false;
+  while (getline(input, line, '\n'))
+  {
+    uint64_t lineLength = line.size() + (input.eof() ? 0 : 1);
+    if (TextTools::isEmpty(line))
+    {
+      if (inBlock)
+      {
+        entries_.back().byteLength = offset + lineLength - entries_.back().offset;
+        inBlock = false;
+      }
+    }
+    else if (line[0] == 'a')
+    {
+      if (inBlock)
+        entries_.back().byteLength = offset - entries_.back().offset;
+      Entry entry;
+      entry.offset = offset;
+      size_t pos = line.find("score=");
+      if (pos != string::npos)
+      {
+        size_t e = line.find_first_of(" \t\r", pos);
+        string score = line.substr(pos + 6, e == string::npos ? string::npos : e - pos - 6);
+        if (score != "NA")
+          entry.score = TextTools::toDouble(score);
+      }
+      entries_.push_back(entry);
+      blockSpecies.push_back(vector<size_t>());
+      inBlock = true;
+      refFound = false;
+    }
+    else if (line[0] == 's' && inBlock)
+    {
+      if (splitFields(line, fields, 7) < 7)
+        throw IOException("MafCatalog::build. Incomplete sequence line: " + line);
+      Entry& entry = entries_.back();
+      string species, chr;
+      MafSequence::splitNameIntoSpeciesAndChromosome(line.substr(fields[1].first, fields[1].second), species, chr);
+      auto it = speciesIds_.find(species);
+      size_t id;
+      if (it == speciesIds_.end())
+      {
+        id = species_.size();
+        speciesIds_[species] = id;
+        species_.push_back(species);
+      }
+      else
+      {
+        id = it->second;
+      }
+      blockSpecies.back().push_back(id);
+      if (entry.nbSequences == 0)
+        entry.nbSites = fields[6].second;
+      entry.nbSequences++;
+      if (!refFound && species == reference_)
+      {
+        refFound = true;
+        auto ct = chromosomeIds_.find(chr);
+        if (ct == chromosomeIds_.end())
+        {
+          entry.chromosome = static_cast<uint32_t>(chromosomes_.size());
+          chromosomeIds_[chr] = entry.chromosome;
+          chromosomes_.push_back(chr);
+        }
+        else
+        {
+          entry.chromosome = ct->second;
+        }
+        uint64_t start = toUInt64(line, fields[2]);
+        uint64_t size = toUInt64(line, fields[3]);
+        uint64_t srcSize = toUInt64(line, fields[5]);
+        entry.refStrand = line[fields[4].first];
+        if (entry.refStrand == '-')
+        {
+          entry.refStart = srcSize - start - size;
+          entry.refStop = srcSize - start;
+        }
+        else
+        {
+          entry.refStart = start;
+          entry.refStop = start + size;
+        }
+      }
+    }
+    offset += lineLength;
+  }
+  if (inBlock)
+    entries_.back().byteLength = offset - entries_.back().offset;
+
+  // Now build the masks:
+  nbWords_ = BitTools::getNumberOfWords(species_.size());
+  masks_.assign(entries_.size() * nbWords_, 0);
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    for (size_t id : blockSpecies[i])
+    {
+      BitTools::setBit(&masks_[i * nbWords_], id);
+    }
+  }
+}
+
+void MafCatalog::write(ostream& output) const
+{
+  string bytes = "BPPMAFCT";
+  BinaryIoTools::putInteger(bytes, FORMAT_VERSION, 4);
+  auto putString = [&bytes](const string& s) {
+        BinaryIoTools::putInteger(bytes, s.size(), 4);
+        bytes += s;
+      };
+  putString(reference_);
+  BinaryIoTools::putInteger(bytes, species_.size(), 4);
+  for (const auto& s : species_)
+  {
+    putString(s);
+  }
+  BinaryIoTools::putInteger(bytes, chromosomes_.size(), 4);
+  for (const auto& s : chromosomes_)
+  {
+    putString(s);
+  }
+  BinaryIoTools::putInteger(bytes, entries_.size(), 8);
+  output.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    const Entry& entry = entries_[i];
+    bytes.clear();
+    BinaryIoTools::putInteger(bytes, entry.offset, 8);
+    BinaryIoTools::putInteger(bytes, entry.byteLength, 8);
+    BinaryIoTools::putInteger(bytes, entry.nbSequences, 4);
+    BinaryIoTools::putInteger(bytes, entry.nbSites, 8);
+    BinaryIoTools::putDouble(bytes, entry.score);
+    BinaryIoTools::putInteger(bytes, entry.chromosome, 4);
+    BinaryIoTools::putInteger(bytes, entry.refStart, 8);
+    BinaryIoTools::putInteger(bytes, entry.refStop, 8);
+    bytes.push_back(entry.refStrand);
+    for (size_t k = 0; k < nbWords_; ++k)
+    {
+      BinaryIoTools::putInteger(bytes, masks_[i * nbWords_ + k], 8);
+    }
+    output.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+  }
+  if (!output)
+    throw Exception("MafCatalog::write. Error while writing catalog.");
+}
+
+void MafCatalog::read(istream& input)
+{
+  string bytes;
+  auto next = [&input, &bytes](size_t nbBytes) {
+        bytes.resize(nbBytes);
+        input.read(&bytes[0], static_cast<streamsize>(nbBytes));
+        if (static_cast<size_t>(input.gcount()) != nbBytes)
+          throw Exception("MafCatalog::read. Truncated catalog.");
+        return bytes.data();
+      };
+  auto nextString = [&next]() {
+        uint32_t len = BinaryIoTools::getUInt32(next(4));
+        return len > 0 ? string(next(len), len) : string();
+      };
+
+  if (string(next(8), 8) != "BPPMAFCT")
+    throw Exception("MafCatalog::read. Not a MAF catalog.");
+  if (BinaryIoTools::getUInt32(next(4)) != FORMAT_VERSION)
+    throw Exception("MafCatalog::read. Unsupported format version.");
+  reference_ = nextString();
+  species_.clear();
+  speciesIds_.clear();
+  uint32_t nbSpecies = BinaryIoTools::getUInt32(next(4));
+  for (uint32_t i = 0; i < nbSpecies; ++i)
+  {
+    species_.push_back(nextString());
+    speciesIds_[species_.back()] = i;
+  }
+  chromosomes_.clear();
+  chromosomeIds_.clear();
+  uint32_t nbChromosomes = BinaryIoTools::getUInt32(next(4));
+  for (uint32_t i = 0; i < nbChromosomes; ++i)
+  {
+    chromosomes_.push_back(nextString());
+    chromosomeIds_[chromosomes_.back()] = i;
+  }
+  uint64_t nbEntries = BinaryIoTools::getInteger(next(8), 8);
+  nbWords_ = BitTools::getNumberOfWords(species_.size());
+  entries_.clear();
+  masks_.clear();
+  entries_.reserve(static_cast<size_t>(nbEntries));
+  masks_.reserve(static_cast<size_t>(nbEntries) * nbWords_);
+  for (uint64_t i = 0; i < nbEntries; ++i)
+  {
+    const char* p = next(ENTRY_SIZE + 8 * nbWords_);
+    Entry entry;
+    entry.offset = BinaryIoTools::getInteger(p, 8);
+    entry.byteLength = BinaryIoTools::getInteger(p + 8, 8);
+    entry.nbSequences = BinaryIoTools::getUInt32(p + 16);
+    entry.nbSites = BinaryIoTools::getInteger(p + 20, 8);
+    entry.score = BinaryIoTools::getDouble(p + 28);
+    entry.chromosome = BinaryIoTools::getUInt32(p + 36);
+    entry.refStart = BinaryIoTools::getInteger(p + 40, 8);
+    entry.refStop = BinaryIoTools::getInteger(p + 48, 8);
+    entry.refStrand = p[56];
+    if (entry.chromosome != NO_CHROMOSOME && entry.chromosome >= chromosomes_.size())
+      throw Exception("MafCatalog::read. Corrupted catalog.");
+    entries_.push_back(entry);
+    for (size_t k = 0; k < nbWords_; ++k)
+    {
+      masks_.push_back(BinaryIoTools::getInteger(p + ENTRY_SIZE + 8 * k, 8));
+    }
+  }
+}
+
+bool MafCatalog::hasSpecies(size_t i, const string& species) const
+{
+  auto it = speciesIds_.find(species);
+  if (it == speciesIds_.end())
+    return false;
+  return BitTools::testBit(&masks_[i * nbWords_], it->second);
+}
+
+bool MafCatalog::makeMask_(const set<string>& species, vector<uint64_t>& mask) const
+{
+  mask.assign(nbWords_, 0);
+  bool allFound = true;
+  for (const auto& s : species)
+  {
+    auto it = speciesIds_.find(s);
+    if (it == speciesIds_.end())
+      allFound = false;
+    else
+      BitTools::setBit(mask.data(), it->second);
+  }
+  return allFound;
+}
+
+vector<size_t> MafCatalog::select(const MafCatalogQuery& query) const
+{
+  vector<size_t> selection;
+  vector<uint64_t> allMask, anyMask, excludedMask;
+  if (!makeMask_(query.allSpecies, allMask))
+    return selection; // At least one required species is never present.
+  makeMask_(query.anySpecies, anyMask);
+  if (query.anySpecies.size() > 0 && BitTools::countBits(anyMask.data(), 0, species_.size()) == 0)
+    return selection;
+  makeMask_(query.excludedSpecies, excludedMask);
+
+  vector<bool> chromosomes;
+  if (query.chromosomes.size() > 0)
+  {
+    chromosomes.resize(chromosomes_.size(), false);
+    for (const auto& chr : query.chromosomes)
+    {
+      auto it = chromosomeIds_.find(chr);
+      if (it != chromosomeIds_.end())
+        chromosomes[it->second] = true;
+    }
+  }
+
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    const Entry& entry = entries_[i];
+    if (entry.nbSites < query.minLength || entry.nbSequences < query.minSize || entry.score < query.minScore)
+      continue;
+    if (query.chromosomes.size() > 0 &&
+        (entry.chromosome == NO_CHROMOSOME || !chromosomes[entry.chromosome]))
+      continue;
+    const uint64_t* mask = masks_.data() + i * nbWords_;
+    bool ok = true;
+    bool any = query.anySpecies.empty();
+    for (size_t k = 0; ok && k < nbWords_; ++k)
+    {
+      ok = (mask[k] & allMask[k]) == allMask[k] && (mask[k] & excludedMask[k]) == 0;
+      any = any || (mask[k] & anyMask[k]) != 0;
+    }
+    if (ok && any)
+      selection.push_back(i);
+  }
+  return selection;
+}
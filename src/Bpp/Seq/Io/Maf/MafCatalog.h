@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MAFCATALOG_H_
+#define _MAFCATALOG_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <limits>
+
+namespace bpp
+{
+/**
+ * @brief Selection criteria on the blocks of a MafCatalog.
+ *
+ * All criteria must be fulfilled for a block to be selected. Empty criteria (the default) mean no selection.
+ */
+struct MafCatalogQuery
+{
+  /**
+   * @brief Species which must all be present in the block.
+   */
+  std::set<std::string> allSpecies;
+
+  /**
+   * @brief Species of which at least one must be present in the block.
+   */
+  std::set<std::string> anySpecies;
+
+  /**
+   * @brief Species which must not be present in the block.
+   */
+  std::set<std::string> excludedSpecies;
+
+  /**
+   * @brief Chromosomes of the reference species to keep.
+   * Blocks without the reference species are not selected if this set is not empty.
+   */
+  std::set<std::string> chromosomes;
+
+  /**
+   * @brief Minimum number of alignment columns.
+   */
+  size_t minLength;
+
+  /**
+   * @brief Minimum number of sequences.
+   */
+  size_t minSize;
+
+  /**
+   * @brief Minimum block score. Blocks without score are not selected if this value is finite.
+   */
+  double minScore;
+
+  MafCatalogQuery() :
+    allSpecies(),
+    anySpecies(),
+    excludedSpecies(),
+    chromosomes(),
+    minLength(0),
+    minSize(0),
+    minScore(-std::numeric_limits<double>::infinity())
+  {}
+};
+
+/**
+ * @brief Summary of the blocks of a MAF file, to be stored as a sidecar file.
+ *
+ * For each block, the catalog stores its position in the MAF file (offset and length in bytes),
+ * its number of sequences and columns, its score, the coordinates of the reference species if any,
+ * and a bit mask of the species present in the block. Species names are interned, the bit mask
+ * having one bit per species in the order of getSpeciesList().
+ *
+ * The catalog is built in one pass over the MAF file, which is scanned without decoding sequences.
+ * Queries are then evaluated on the catalog only, with bit operations on the species masks,
+ * so that only the selected blocks need to be parsed (see CatalogMafIterator).
+ *
+ * The binary file starts with the 8 characters "BPPMAFCT" and the format version.
+ * All numbers are little-endian.
+ */
+class MafCatalog
+{
+public:
+  static constexpr uint32_t NO_CHROMOSOME = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief Description of a block.
+   */
+  struct Entry
+  {
+    uint64_t offset; ///< Position of the 'a' line in the MAF file.
+    uint64_t byteLength; ///< Number of bytes of the paragraph, including the final empty line if any.
+    uint32_t nbSequences;
+    uint64_t nbSites;
+    double score; ///< -inf if not specified.
+    uint32_t chromosome; ///< Index of the reference chromosome, or NO_CHROMOSOME.
+    uint64_t refStart; ///< On the positive strand, 0-based.
+    uint64_t refStop; ///< On the positive strand, excluded.
+    char refStrand;
+
+    Entry() :
+      offset(0), byteLength(0), nbSequences(0), nbSites(0),
+      score(-std::numeric_limits<double>::infinity()),
+      chromosome(NO_CHROMOSOME), refStart(0), refStop(0), refStrand('?')
+    {}
+  };
+
+private:
+  std::string reference_;
+  std::vector<std::string> species_;
+  std::map<std::string, size_t> speciesIds_;
+  std::vector<std::string> chromosomes_;
+  std::map<std::string, uint32_t> chromosomeIds_;
+  std::vector<Entry> entries_;
+  size_t nbWords_;
+  std::vector<uint64_t> masks_; // nbWords_ words per entry.
+
+public:
+  /**
+   * @param reference The species for which coordinates are stored.
+   */
+  MafCatalog(const std::string& reference = "") :
+    reference_(reference),
+    species_(),
+    speciesIds_(),
+    chromosomes_(),
+    chromosomeIds_(),
+    entries_(),
+    nbWords_(0),
+    masks_()
+  {}
+
+  virtual ~MafCatalog() {}
+
+public:
+  /**
+   * @brief Build the catalog from a MAF file.
+   *
+   * Any previous content is discarded. The stream is read until its end.
+   * Offsets are relative to the current position of the stream.
+   *
+   * @param input The MAF stream to scan.
+   */
+  void build(std::istream& input);
+
+  /**
+   * @brief Write the catalog in binary format.
+   *
+   * @param output The output stream, which should be opened in binary mode.
+   */
+  void write(std::ostream& output) const;
+
+  /**
+   * @brief Read a catalog in binary format. Any previous content is discarded.
+   *
+   * @param input The input stream, which should be opened in binary mode.
+   */
+  void read(std::istream& input);
+
+  const std::string& getReferenceSpecies() const { return reference_; }
+
+  const std::vector<std::string>& getSpeciesList() const { return species_; }
+
+  const std::vector<std::string>& getChromosomeList() const { return chromosomes_; }
+
+  size_t getNumberOfBlocks() const { return entries_.size(); }
+
+  const Entry& getEntry(size_t i) const { return entries_[i]; }
+
+  /**
+   * @return True if a species is present in a block.
+   * @param i The index of the block.
+   * @param species The name of the species.
+   */
+  bool hasSpecies(size_t i, const std::string& species) const;
+
+  /**
+   * @return The indices of the blocks matching a query, in file order.
+   * @param query The selection criteria.
+   */
+  std::vector<size_t> select(const MafCatalogQuery& query) const;
+
+private:
+  /**
+   * @brief Build a species bit mask from a set of names.
+   *
+   * @return False if at least one species is not in the catalog.
+   */
+  bool makeMask_(const std::set<std::string>& species, std::vector<uint64_t>& mask) const;
+};
+} // end of namespace bpp.
+
+#endif // _MAFCATALOG_H_
@@ -14,12 +14,38 @@ using namespace std;
 using namespace bpp;
 
 std::unique_ptr<MafBlock> MafParser::analyseCurrentBlock_()
+{
+  unique_ptr<MafBlock> block;
+  bool discarded;
+  do
+  {
+    block = parseNextBlock_(discarded);
+  }
+  while (discarded);
+  return block;
+}
+
+void MafParser::skipParagraph_()
+{
+  string line;
+  while (!stream_->eof())
+  {
+    getline(*stream_, line, '\n');
+    if (TextTools::isEmpty(line))
+      break;
+  }
+}
+
+std::unique_ptr<MafBlock> MafParser::parseNextBlock_(bool& discarded)
 {
   unique_ptr<MafBlock> block = nullptr;
+  discarded = false;
 
   string line;
   bool test = true;
   unique_ptr<MafSequence> currentSequence;
+  bool skipRow = false;
+  bool refFound = false;
 
   while (test)
   {
@@ -68,6 +94,36 @@ std::unique_ptr<MafBlock> MafParser::analyseCurrentBlock_()
     }
     else if (line[0] == 's')
     {
+      skipRow = false;
+      if (pushdown_.minLength > 0)
+      {
+        // The alignment text is the last field:
+        size_t e = line.find_last_not_of(" \t\r");
+        size_t b = line.find_last_of(" \t", e);
+        if (e != string::npos && b != string::npos && e - b < pushdown_.minLength)
+        {
+          skipParagraph_();
+          discarded = true;
+          return nullptr;
+        }
+      }
+      if (pushdown_.species.size() > 0)
+      {
+        // Only look at the source field, the rest of the line is parsed only if the species is selected:
+        size_t b = line.find_first_not_of(" \t", 1);
+        size_t e = line.find_first_of(" \t.", b);
+        if (b != string::npos && e != string::npos && line[e] == '.' &&
+            pushdown_.species.find(line.substr(b, e - b)) == pushdown_.species.end())
+        {
+          if (currentSequence)
+          {
+            // Add previous sequence:
+            block->addSequence(currentSequence);
+          }
+          skipRow = true;
+          continue;
+        }
+      }
       StringTokenizer st(line);
       st.nextToken(); // The 's' tag
       if (!st.hasMoreToken())
@@ -128,9 +184,21 @@ std::unique_ptr<MafBlock> MafParser::analyseCurrentBlock_()
         }
         currentSequence->addAnnotation(make_shared<SequenceMask>(mask));
       }
+      if (pushdown_.chromosomes.size() > 0 && !refFound && currentSequence->getSpecies() == pushdown_.reference)
+      {
+        refFound = true;
+        if (pushdown_.chromosomes.find(currentSequence->getChromosome()) == pushdown_.chromosomes.end())
+        {
+          skipParagraph_();
+          discarded = true;
+          return nullptr;
+        }
+      }
     }
     else if (line[0] == 'q')
     {
+      if (skipRow)
+        continue;
       if (!currentSequence)
         throw Exception("MafAlignmentParser::nextBlock(). Quality scores found, but there is currently no sequence!");
       StringTokenizer st(line);
@@ -177,6 +245,18 @@ std::unique_ptr<MafBlock> MafParser::analyseCurrentBlock_()
     block->addSequence(currentSequence);
   }
 
+  // Check the criteria which can only be assessed on the full block:
+  if (block)
+  {
+    if ((pushdown_.species.size() > 0 && block->getNumberOfSequences() == 0) ||
+        (pushdown_.chromosomes.size() > 0 && !refFound) ||
+        block->getNumberOfSequences() < pushdown_.minSize)
+    {
+      discarded = true;
+      return nullptr;
+    }
+  }
+
   // Returning block:
   return block;
 }
@@ -10,9 +10,61 @@
 
 // From the STL:
 #include <iostream>
+#include <set>
+#include <string>
 
 namespace bpp
 {
+/**
+ * @brief Selection criteria applied by MafParser while reading.
+ *
+ * Parsing with a pushdown specification gives the same results as parsing without it and applying
+ * the equivalent chain of filters, in this order:
+ * - SequenceFilterMafIterator with the species allow-list (non-strict, sequences removed, duplicates kept),
+ * - ChromosomeMafIterator with the reference species and chromosome set,
+ * - BlockLengthMafIterator with the minimum block length,
+ * - BlockSizeMafIterator with the minimum block size.
+ * Sequences and blocks are however discarded before they are decoded, which saves most of the parsing time
+ * when only a small part of the input is selected.
+ * Empty criteria (the default) mean no selection.
+ */
+struct MafParserPushdown
+{
+  /**
+   * @brief Species to keep. Sequences from other species are skipped.
+   */
+  std::set<std::string> species;
+
+  /**
+   * @brief Reference species, used for chromosome selection.
+   */
+  std::string reference;
+
+  /**
+   * @brief Chromosomes of the reference species to keep.
+   * Blocks without the reference species are skipped if this set is not empty.
+   */
+  std::set<std::string> chromosomes;
+
+  /**
+   * @brief Minimum number of alignment columns.
+   */
+  size_t minLength;
+
+  /**
+   * @brief Minimum number of sequences, after species selection.
+   */
+  size_t minSize;
+
+  MafParserPushdown() :
+    species(),
+    reference(),
+    chromosomes(),
+    minLength(0),
+    minSize(0)
+  {}
+};
+
 /**
  * @brief MAF file parser.
  *
@@ -33,6 +85,7 @@ private:
   CaseMaskedAlphabet cmAlphabet_;
   bool firstBlock_;
   short dotOption_;
+  MafParserPushdown pushdown_;
 
 public:
   /**
@@ -49,26 +102,32 @@ public:
    *        will return an exception. DOT_ASGAP will convert all dots
    *        to gaps and DOT_ASUNRES will convert them to 'N', which
    *        will increase parsing time.
+   * @param pushdown Selection of species and blocks to apply while parsing (see MafParserPushdown).
    */
   MafParser(
       std::shared_ptr<std::istream> stream,
       bool parseMask = false,
       bool checkSize = true,
-      short dotOption = DOT_ERROR) :
+      short dotOption = DOT_ERROR,
+      const MafParserPushdown& pushdown = MafParserPushdown()) :
     stream_(stream),
     mask_(parseMask),
     checkSequenceSize_(checkSize),
     cmAlphabet_(AlphabetTools::DNA_ALPHABET),
     firstBlock_(true),
-    dotOption_(dotOption)
-  {}
+    dotOption_(dotOption),
+    pushdown_(pushdown)
+  {
+    if (pushdown_.chromosomes.size() > 0 && pushdown_.reference == "")
+      throw Exception("MafParser (constructor). A reference species must be specified for chromosome selection.");
+  }
 
 private:
   // Recopy is forbidden!
   MafParser(const MafParser& maf) :
     stream_(nullptr), mask_(maf.mask_), checkSequenceSize_(maf.checkSequenceSize_),
     cmAlphabet_(AlphabetTools::DNA_ALPHABET), firstBlock_(maf.firstBlock_),
-    dotOption_(maf.dotOption_) {}
+    dotOption_(maf.dotOption_), pushdown_(maf.pushdown_) {}
 
   MafParser& operator=(const MafParser& maf)
   {
@@ -77,12 +136,29 @@ private:
     checkSequenceSize_ = maf.checkSequenceSize_;
     firstBlock_ = maf.firstBlock_;
     dotOption_ = maf.dotOption_;
+    pushdown_ = maf.pushdown_;
     return *this;
   }
 
+public:
+  const MafParserPushdown& getPushdown() const { return pushdown_; }
+
 private:
   std::unique_ptr<MafBlock> analyseCurrentBlock_();
 
+  /**
+   * @brief Parse the next paragraph.
+   *
+   * @param discarded Set to true if the paragraph does not match the pushdown specification.
+   * @return The parsed block, or nullptr if the block was discarded or the end of the stream was reached.
+   */
+  std::unique_ptr<MafBlock> parseNextBlock_(bool& discarded);
+
+  /**
+   * @brief Read and ignore all lines until the end of the current paragraph.
+   */
+  void skipParagraph_();
+
 public:
   static constexpr short DOT_ERROR = 0;
   static constexpr short DOT_ASGAP = 1;
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "MafSequence.h"
+#include "DnaTraits.h"
 
 // From the STL:
 #include <string>
@@ -16,11 +17,16 @@ unique_ptr<MafSequence> MafSequence::subSequence(size_t startAt, size_t length)
   size_t begin = begin_;
   if (hasCoordinates_)
   {
-    for (size_t i = 0; i < startAt; ++i)
-    {
-      if (!getAlphabet()->isGap(operator[](i)))
-        begin++;
-    }
+    const vector<int>& content = getContent();
+    begin += AlphabetTraitsTools::dispatch(*getAlphabet(), [&](const auto& traits) {
+          size_t n = 0;
+          for (size_t i = 0; i < startAt; ++i)
+          {
+            if (!traits.isGap(content[i]))
+              n++;
+          }
+          return n;
+        });
   }
   auto newSeq = make_unique<MafSequence>(getName(), subseq, begin, strand_, srcSize_);
   if (!hasCoordinates_)
@@ -92,6 +92,29 @@ public:
       splitNameIntoSpeciesAndChromosome(name, species_, chromosome_);
   }
 
+  MafSequence(
+      const std::string& name,
+      const std::vector<int>& sequence,
+      size_t begin,
+      char strand,
+      size_t srcSize,
+      bool parseName = true,
+      std::shared_ptr<const Alphabet> alphabet = AlphabetTools::DNA_ALPHABET) :
+    AbstractTemplateSymbolList<int>(alphabet),
+    SequenceWithAnnotation(name, sequence, alphabet),
+    hasCoordinates_(true),
+    begin_(begin),
+    species_(""),
+    chromosome_(""),
+    strand_(strand),
+    size_(0),
+    srcSize_(srcSize)
+  {
+    size_ = SequenceTools::getNumberOfSites(*this);
+    if (parseName)
+      splitNameIntoSpeciesAndChromosome(name, species_, chromosome_);
+  }
+
   MafSequence(const MafSequence& mafSeq) :
     AbstractTemplateSymbolList<int>(mafSeq),
     SequenceWithAnnotation(mafSeq),
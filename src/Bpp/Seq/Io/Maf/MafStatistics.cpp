@@ -7,6 +7,7 @@
 #include <Bpp/Seq/Container/VectorSiteContainer.h>
 #include <Bpp/Seq/Container/SiteContainerTools.h>
 #include <Bpp/Seq/SiteTools.h>
+#include "../../Feature/Gff/GffFeatureReader.h"
 
 // From bpp-core:
 #include <Bpp/Numeric/NumConstants.h>
@@ -14,6 +15,7 @@
 // From the STL:
 #include <cmath>
 #include <map>
+#include <algorithm>
 
 using namespace bpp;
 using namespace std;
@@ -57,6 +59,25 @@ unique_ptr<SiteContainerInterface> AbstractSpeciesSelectionMafStatistics::getSit
   return alignment;
 }
 
+vector<const MafSequence*> AbstractSpeciesSelectionMafStatistics::getSequenceSelection_(const MafBlock& block) const
+{
+  vector<const MafSequence*> selection;
+  if (noSpeciesMeansAllSpecies_ && species_.size() == 0)
+  {
+    for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+    {
+      selection.push_back(&block.sequence(i));
+    }
+  }
+  // Otherwise, we select species:
+  for (size_t i = 0; i < species_.size(); ++i)
+  {
+    vector<const MafSequence*> tmp = block.getSequencesForSpecies(species_[i]);
+    selection.insert(selection.end(), tmp.begin(), tmp.end());
+  }
+  return selection;
+}
+
 AbstractSpeciesMultipleSelectionMafStatistics::AbstractSpeciesMultipleSelectionMafStatistics(const std::vector< std::vector<std::string>>& species) :
   species_(species)
 {
@@ -93,6 +114,20 @@ vector<unique_ptr<SiteContainerInterface>> AbstractSpeciesMultipleSelectionMafSt
   return alignments;
 }
 
+vector<vector<const MafSequence*>> AbstractSpeciesMultipleSelectionMafStatistics::getSequenceSelections_(const MafBlock& block) const
+{
+  vector<vector<const MafSequence*>> selections(species_.size());
+  for (size_t k = 0; k < species_.size(); ++k)
+  {
+    for (size_t i = 0; i < species_[k].size(); ++i)
+    {
+      vector<const MafSequence*> tmp = block.getSequencesForSpecies(species_[k][i]);
+      selections[k].insert(selections[k].end(), tmp.begin(), tmp.end());
+    }
+  }
+  return selections;
+}
+
 vector<string> CharacterCountsMafStatistics::getSupportedTags() const
 {
   vector<string> tags;
@@ -177,7 +212,7 @@ void SiteFrequencySpectrumMafStatistics::compute(const MafBlock& block)
       for (size_t j = 0; !isUnresolved && !isSaturated && j < site.size(); ++j)
       {
         state = site[j];
-        if (alphabet_->isGap(state) || alphabet_->isUnresolved(state))
+        if (!DnaTraits::isResolved(state))
         {
           isUnresolved = true;
         }
@@ -198,9 +233,7 @@ void SiteFrequencySpectrumMafStatistics::compute(const MafBlock& block)
       {
         nbSaturated++;
       }
-      else if (hasOutgroup && (
-            alignment->getAlphabet()->isGap((*outgroupSeq)[i]) ||
-            alignment->getAlphabet()->isUnresolved((*outgroupSeq)[i])))
+      else if (hasOutgroup && !DnaTraits::isResolved((*outgroupSeq)[i]))
       {
         nbUnresolved++;
       }
@@ -339,44 +372,33 @@ vector<string> SiteMafStatistics::getSupportedTags() const
 
 void SiteMafStatistics::compute(const MafBlock& block)
 {
-  auto alignment = getSiteContainer_(block);
+  vector<const MafSequence*> selection = getSequenceSelection_(block);
   unsigned int nbNg = 0;
   unsigned int nbCo = 0;
   unsigned int nbPi = 0;
-  unsigned int nbP1 = 0;
-  unsigned int nbP2 = 0;
-  unsigned int nbP3 = 0;
-  unsigned int nbP4 = 0;
-  if (alignment->getNumberOfSequences() > 0)
+  unsigned int nbP[5] = {0, 0, 0, 0, 0};
+  if (selection.size() > 0)
   {
-    for (size_t i = 0; i < alignment->getNumberOfSites(); ++i)
+    for (size_t i = 0; i < block.getNumberOfSites(); ++i)
     {
-      if (!SiteTools::hasGap(alignment->site(i)))
+      ColumnClass c = ColumnClassifier::classify(selection, i);
+      if (!c.hasGap)
         nbNg++;
-      if (SiteTools::isComplete(alignment->site(i)))
+      if (c.isComplete())
       {
         nbCo++;
-        map<int, size_t> counts;
-        SiteTools::getCounts(alignment->site(i), counts);
-        switch (counts.size())
-        {
-        case 1: nbP1++; break;
-        case 2: nbP2++; break;
-        case 3: nbP3++; break;
-        case 4: nbP4++; break;
-        default: throw Exception("The impossible happened. Probably a distortion in the Minkowski space.");
-        }
+        nbP[c.getNumberOfAlleles()]++;
       }
-      if (SiteTools::isParsimonyInformativeSite(alignment->site(i)))
+      if (c.isParsimonyInformative)
         nbPi++;
     }
   }
   result_.setValue("NbWithoutGap", nbNg);
   result_.setValue("NbComplete", nbCo);
-  result_.setValue("NbConstant", nbP1);
-  result_.setValue("NbBiallelic", nbP2);
-  result_.setValue("NbTriallelic", nbP3);
-  result_.setValue("NbQuadriallelic", nbP4);
+  result_.setValue("NbConstant", nbP[1]);
+  result_.setValue("NbBiallelic", nbP[2]);
+  result_.setValue("NbTriallelic", nbP[3]);
+  result_.setValue("NbQuadriallelic", nbP[4]);
   result_.setValue("NbParsimonyInformative", nbPi);
 }
 
@@ -396,23 +418,18 @@ vector<string> PolymorphismMafStatistics::getSupportedTags() const
   return tags;
 }
 
-vector<int> PolymorphismMafStatistics::getPatterns_(const SiteContainerInterface& sites)
+vector<int> PolymorphismMafStatistics::getPatterns_(const vector<const MafSequence*>& sequences, size_t nbColumns)
 {
-  vector<int> patterns(sites.getNumberOfSites());
-  for (size_t i = 0; i < sites.getNumberOfSites(); ++i)
+  vector<int> patterns(nbColumns);
+  for (size_t i = 0; i < nbColumns; ++i)
   {
-    const Site& site = sites.site(i);
+    ColumnClass c = ColumnClassifier::classify(sequences, i);
     int s = -1; // Unresolved
-    if (SiteTools::isComplete(site))
+    if (c.isComplete())
     {
-      if (SiteTools::isConstant(site))
-      {
-        s = site[0]; // The fixed state
-      }
-      else
-      {
+      s = c.getFixedState(); // The fixed state, if any
+      if (s == -1)
         s = -10; // Polymorphic.
-      }
     }
     patterns[i] = s;
   }
@@ -421,7 +438,7 @@ vector<int> PolymorphismMafStatistics::getPatterns_(const SiteContainerInterface
 
 void PolymorphismMafStatistics::compute(const MafBlock& block)
 {
-  vector<unique_ptr<SiteContainerInterface>> alignments = getSiteContainers_(block);
+  vector<vector<const MafSequence*>> selections = getSequenceSelections_(block);
   unsigned int nbF = 0;
   unsigned int nbP = 0;
   unsigned int nbFF = 0;
@@ -435,13 +452,13 @@ void PolymorphismMafStatistics::compute(const MafBlock& block)
   // Get all patterns:
   vector<int> patterns1(block.getNumberOfSites(), -1);
   vector<int> patterns2(block.getNumberOfSites(), -1);
-  if (alignments[0]->getNumberOfSequences() > 0)
+  if (selections[0].size() > 0)
   {
-    patterns1 = getPatterns_(*alignments[0]);
+    patterns1 = getPatterns_(selections[0], block.getNumberOfSites());
   }
-  if (alignments[1]->getNumberOfSequences() > 0)
+  if (selections[1].size() > 0)
   {
-    patterns2 = getPatterns_(*alignments[1]);
+    patterns2 = getPatterns_(selections[1], block.getNumberOfSites());
   }
   // Compare patterns:
   for (size_t i = 0; i < block.getNumberOfSites(); ++i)
@@ -586,3 +603,641 @@ void SequenceDiversityMafStatistics::compute(const MafBlock& block)
   result_.setValue("TajimaPi", pi);
   result_.setValue("TajimaD", tajd);
 }
+
+vector<string> LinkageDisequilibriumMafStatistics::getSupportedTags() const
+{
+  vector<string> tags;
+  tags.push_back("NbBiallelic");
+  for (size_t i = 0; i < nbPairs_.size(); ++i)
+  {
+    tags.push_back("NbPairsBin" + TextTools::toString(i + 1));
+  }
+  for (size_t i = 0; i < nbPairs_.size(); ++i)
+  {
+    tags.push_back("MeanR2Bin" + TextTools::toString(i + 1));
+  }
+  for (size_t i = 0; i < nbPairs_.size(); ++i)
+  {
+    tags.push_back("MeanDprimeBin" + TextTools::toString(i + 1));
+  }
+  return tags;
+}
+
+void LinkageDisequilibriumMafStatistics::compute(const MafBlock& block)
+{
+  fill(nbPairs_.begin(), nbPairs_.end(), 0);
+  fill(sumR2_.begin(), sumR2_.end(), 0.);
+  fill(sumDprime_.begin(), sumDprime_.end(), 0.);
+
+  vector<const MafSequence*> selection = getSequenceSelection_(block);
+  const MafSequence* refSeq = nullptr;
+  if (refSpecies_ != "")
+  {
+    if (block.hasSequenceForSpecies(refSpecies_))
+      refSeq = &block.sequenceForSpecies(refSpecies_);
+    else
+      selection.clear(); // No coordinates available, the block is ignored.
+  }
+  haplotypes_.build(selection, refSeq);
+
+  auto accumulate = [this](size_t i, size_t j, const PairwiseLinkageDisequilibrium& ld)
+                    {
+                      size_t dist = haplotypes_.getPosition(j) - haplotypes_.getPosition(i);
+                      if (dist == 0)
+                        return;
+                      size_t bin = (dist - 1) / binWidth_;
+                      nbPairs_[bin]++;
+                      sumR2_[bin] += ld.r2;
+                      sumDprime_[bin] += ld.dPrime;
+                    };
+  haplotypes_.computeAllPairs(maxDistance_, accumulate);
+
+  result_.setValue("NbBiallelic", static_cast<unsigned int>(haplotypes_.getNumberOfSites()));
+  for (size_t i = 0; i < nbPairs_.size(); ++i)
+  {
+    string bin = TextTools::toString(i + 1);
+    result_.setValue("NbPairsBin" + bin, nbPairs_[i]);
+    if (nbPairs_[i] > 0)
+    {
+      result_.setValue("MeanR2Bin" + bin, sumR2_[i] / static_cast<double>(nbPairs_[i]));
+      result_.setValue("MeanDprimeBin" + bin, sumDprime_[i] / static_cast<double>(nbPairs_[i]));
+    }
+    else
+    {
+      result_.setValue("MeanR2Bin" + bin, NumConstants::NaN());
+      result_.setValue("MeanDprimeBin" + bin, NumConstants::NaN());
+    }
+    cumNbPairs_[i] += nbPairs_[i];
+    cumSumR2_[i] += sumR2_[i];
+    cumSumDprime_[i] += sumDprime_[i];
+  }
+}
+
+vector<double> LinkageDisequilibriumMafStatistics::getCumulatedMeanR2() const
+{
+  vector<double> means(cumNbPairs_.size());
+  for (size_t i = 0; i < means.size(); ++i)
+  {
+    means[i] = cumNbPairs_[i] > 0 ? cumSumR2_[i] / cumNbPairs_[i] : NumConstants::NaN();
+  }
+  return means;
+}
+
+vector<double> LinkageDisequilibriumMafStatistics::getCumulatedMeanDprime() const
+{
+  vector<double> means(cumNbPairs_.size());
+  for (size_t i = 0; i < means.size(); ++i)
+  {
+    means[i] = cumNbPairs_[i] > 0 ? cumSumDprime_[i] / cumNbPairs_[i] : NumConstants::NaN();
+  }
+  return means;
+}
+
+MutationSpectrumMafStatistics::MutationSpectrumMafStatistics(
+    const std::vector<std::string>& ingroup,
+    const std::string& outgroup,
+    const std::string& contextSpecies) :
+  AbstractMafStatistics(),
+  AbstractSpeciesSelectionMafStatistics(ingroup),
+  outgroup_(outgroup),
+  contextSpecies_(contextSpecies == "" ? outgroup : contextSpecies),
+  counts_(256),
+  cumCounts_(96),
+  classes_(256, -1),
+  classNames_(96)
+{
+  // Precompute the class of each 8 bits code, collapsing purine ancestral states on the opposite strand:
+  const string bases = "ACGT";
+  for (int left = 0; left < 4; ++left)
+  {
+    for (int anc = 0; anc < 4; ++anc)
+    {
+      for (int right = 0; right < 4; ++right)
+      {
+        for (int der = 0; der < 4; ++der)
+        {
+          if (der == anc)
+            continue;
+          int l = left, a = anc, r = right, d = der;
+          if (a == 0 || a == 2)
+          {
+            // Reverse complement, using 3 - x as complement of x:
+            l = 3 - right;
+            a = 3 - anc;
+            r = 3 - left;
+            d = 3 - der;
+          }
+          // a is now C (1) or T (3), and d is one of the three other bases:
+          int sub = (a == 1 ? 0 : 3) + (d < a ? d : d - 1);
+          int cls = sub * 16 + l * 4 + r;
+          classes_[static_cast<size_t>((left << 6) | (anc << 4) | (right << 2) | der)] = static_cast<short>(cls);
+          classNames_[static_cast<size_t>(cls)] = string(1, bases[static_cast<size_t>(l)]) + "[" + bases[static_cast<size_t>(a)] + ">" + bases[static_cast<size_t>(d)] + "]" + bases[static_cast<size_t>(r)];
+        }
+      }
+    }
+  }
+}
+
+vector<string> MutationSpectrumMafStatistics::getSupportedTags() const
+{
+  vector<string> tags(classNames_);
+  tags.push_back("NbPolarized");
+  return tags;
+}
+
+void MutationSpectrumMafStatistics::compute(const MafBlock& block)
+{
+  fill(counts_.begin(), counts_.end(), 0);
+  unsigned int nbPolarized = 0;
+  vector<const MafSequence*> ingroup = getSequenceSelection_(block);
+  if (ingroup.size() > 0 && block.hasSequenceForSpecies(outgroup_) && block.hasSequenceForSpecies(contextSpecies_))
+  {
+    const vector<int>& out = block.sequenceForSpecies(outgroup_).getContent();
+    const vector<int>& ctx = block.sequenceForSpecies(contextSpecies_).getContent();
+    vector<const vector<int>*> rows(ingroup.size());
+    for (size_t j = 0; j < ingroup.size(); ++j)
+    {
+      rows[j] = &ingroup[j]->getContent();
+    }
+    size_t nc = block.getNumberOfSites();
+    for (size_t i = 1; i + 1 < nc; ++i)
+    {
+      int anc = out[i];
+      int left = ctx[i - 1];
+      int right = ctx[i + 1];
+      // Resolved nucleotides are coded 0 to 3, anything else (gaps = -1, generic characters > 3) has other bits set:
+      if ((anc | left | right) & ~3)
+        continue;
+      unsigned int states = 0;
+      int unresolved = 0;
+      for (const auto* row : rows)
+      {
+        int x = (*row)[i];
+        unresolved |= x & ~3;
+        states |= 1u << (x & 3);
+      }
+      if (unresolved)
+        continue;
+      nbPolarized++;
+      unsigned int derived = states & ~(1u << anc);
+      // Exactly one derived state:
+      if (derived == 0 || (derived & (derived - 1)))
+        continue;
+      int der = static_cast<int>(BitTools::countTrailingZeros(derived));
+      counts_[static_cast<size_t>((left << 6) | (anc << 4) | (right << 2) | der)]++;
+    }
+  }
+
+  // Collapse to the 96 classes:
+  vector<unsigned int> spectrum(96);
+  for (size_t k = 0; k < counts_.size(); ++k)
+  {
+    if (classes_[k] >= 0)
+      spectrum[static_cast<size_t>(classes_[k])] += counts_[k];
+  }
+  for (size_t c = 0; c < spectrum.size(); ++c)
+  {
+    result_.setValue(classNames_[c], spectrum[c]);
+    cumCounts_[c] += spectrum[c];
+  }
+  result_.setValue("NbPolarized", nbPolarized);
+}
+
+SubstitutionMatrixMafStatistics::SubstitutionMatrixMafStatistics(
+    const vector<pair<string, string>>& pairs,
+    bool withGaps) :
+  AbstractMafStatistics(),
+  pairs_(pairs),
+  withGaps_(withGaps),
+  size_(withGaps ? 5 : 4),
+  cumCounts_(),
+  tags_()
+{
+  init_();
+}
+
+SubstitutionMatrixMafStatistics::SubstitutionMatrixMafStatistics(
+    const string& reference,
+    const vector<string>& species,
+    bool withGaps) :
+  AbstractMafStatistics(),
+  pairs_(),
+  withGaps_(withGaps),
+  size_(withGaps ? 5 : 4),
+  cumCounts_(),
+  tags_()
+{
+  for (const auto& sp : species)
+  {
+    if (sp != reference)
+      pairs_.push_back(make_pair(reference, sp));
+  }
+  init_();
+}
+
+void SubstitutionMatrixMafStatistics::init_()
+{
+  const string states = "ACGT-";
+  cumCounts_.assign(pairs_.size(), vector<double>(size_ * size_));
+  for (const auto& p : pairs_)
+  {
+    for (size_t a = 0; a < size_; ++a)
+    {
+      for (size_t b = 0; b < size_; ++b)
+      {
+        tags_.push_back(p.first + "-" + p.second + "." + states[a] + states[b]);
+      }
+    }
+  }
+}
+
+void SubstitutionMatrixMafStatistics::encodeRow_(const vector<int>& row, vector<unsigned char>& codes)
+{
+  // A, C, G, T -> 0-3, gap -> 4, anything else -> 5.
+  codes.resize(row.size());
+  for (size_t i = 0; i < row.size(); ++i)
+  {
+    int x = row[i];
+    codes[i] = static_cast<unsigned char>(x >= 0 && x < 4 ? x : (x == -1 ? 4 : 5));
+  }
+}
+
+void SubstitutionMatrixMafStatistics::compute(const MafBlock& block)
+{
+  // Encode each sequence once, as it may be involved in several pairs:
+  map<string, vector<unsigned char>> codes;
+  unsigned int hist[36];
+  size_t k = 0;
+  for (size_t p = 0; p < pairs_.size(); ++p)
+  {
+    fill(hist, hist + 36, 0u);
+    if (block.getNumberOfSites() > 0 &&
+        block.hasSequenceForSpecies(pairs_[p].first) &&
+        block.hasSequenceForSpecies(pairs_[p].second))
+    {
+      for (const string* sp : { &pairs_[p].first, &pairs_[p].second })
+      {
+        if (codes.find(*sp) == codes.end())
+          encodeRow_(block.sequenceForSpecies(*sp).getContent(), codes[*sp]);
+      }
+      const unsigned char* x = &codes[pairs_[p].first][0];
+      const unsigned char* y = &codes[pairs_[p].second][0];
+      size_t n = block.getNumberOfSites();
+      for (size_t i = 0; i < n; ++i)
+      {
+        hist[x[i] * 6 + y[i]]++;
+      }
+    }
+    for (size_t a = 0; a < size_; ++a)
+    {
+      for (size_t b = 0; b < size_; ++b)
+      {
+        unsigned int c = hist[a * 6 + b];
+        result_.setValue(tags_[k++], c);
+        cumCounts_[p][a * size_ + b] += c;
+      }
+    }
+  }
+}
+
+void SubstitutionMatrixMafStatistics::mergeCumulatedCounts(const SubstitutionMatrixMafStatistics& stats)
+{
+  if (stats.pairs_ != pairs_ || stats.size_ != size_)
+    throw Exception("SubstitutionMatrixMafStatistics::mergeCumulatedCounts. Instances do not compare the same pairs.");
+  for (size_t p = 0; p < cumCounts_.size(); ++p)
+  {
+    for (size_t i = 0; i < cumCounts_[p].size(); ++i)
+    {
+      cumCounts_[p][i] += stats.cumCounts_[p][i];
+    }
+  }
+}
+
+CodonDivergenceMafStatistics::CodonDivergenceMafStatistics(
+    const GeneticCode& gCode,
+    const string& reference,
+    const vector<string>& species) :
+  AbstractMafStatistics(),
+  refSpecies_(reference),
+  pairs_(),
+  synSites_(64),
+  synDiffs_(64 * 64),
+  nonSynDiffs_(64 * 64),
+  isValid_(64 * 64),
+  tags_(),
+  cumValues_()
+{
+  for (size_t i = 0; i + 1 < species.size(); ++i)
+  {
+    for (size_t j = i + 1; j < species.size(); ++j)
+    {
+      pairs_.push_back(make_pair(species[i], species[j]));
+    }
+  }
+  cumValues_.assign(pairs_.size(), vector<double>(5));
+  for (const auto& p : pairs_)
+  {
+    string prefix = p.first + "-" + p.second + ".";
+    tags_.push_back(prefix + "NbCodons");
+    tags_.push_back(prefix + "SynSites");
+    tags_.push_back(prefix + "NonSynSites");
+    tags_.push_back(prefix + "SynDiffs");
+    tags_.push_back(prefix + "NonSynDiffs");
+  }
+  initTables_(gCode);
+}
+
+void CodonDivergenceMafStatistics::initTables_(const GeneticCode& gCode)
+{
+  // Codons are coded as 16 * n1 + 4 * n2 + n3, as in the CodonAlphabet class.
+  const int shifts[3] = {16, 4, 1};
+  vector<bool> isStop(64);
+  for (int c = 0; c < 64; ++c)
+  {
+    isStop[static_cast<size_t>(c)] = gCode.isStop(c);
+  }
+
+  // Synonymous sites:
+  for (int c = 0; c < 64; ++c)
+  {
+    if (isStop[static_cast<size_t>(c)])
+      continue;
+    double s = 0;
+    for (int p = 0; p < 3; ++p)
+    {
+      int x = (c / shifts[p]) % 4;
+      for (int y = 0; y < 4; ++y)
+      {
+        if (y == x)
+          continue;
+        int c2 = c + (y - x) * shifts[p];
+        if (!isStop[static_cast<size_t>(c2)] && gCode.areSynonymous(c, c2))
+          s += 1. / 3.;
+      }
+    }
+    synSites_[static_cast<size_t>(c)] = s;
+  }
+
+  // Differences, averaged over pathways:
+  for (int c1 = 0; c1 < 64; ++c1)
+  {
+    for (int c2 = 0; c2 < 64; ++c2)
+    {
+      size_t k = static_cast<size_t>(c1 * 64 + c2);
+      if (isStop[static_cast<size_t>(c1)] || isStop[static_cast<size_t>(c2)])
+        continue;
+      vector<int> diffs;
+      for (int p = 0; p < 3; ++p)
+      {
+        if ((c1 / shifts[p]) % 4 != (c2 / shifts[p]) % 4)
+          diffs.push_back(p);
+      }
+      // Loop over all orders of the differing positions:
+      double sd = 0, nd = 0;
+      unsigned int nbPaths = 0;
+      do
+      {
+        int c = c1;
+        double s = 0, n = 0;
+        bool ok = true;
+        for (size_t i = 0; ok && i < diffs.size(); ++i)
+        {
+          int p = diffs[i];
+          int x = (c / shifts[p]) % 4;
+          int y = (c2 / shifts[p]) % 4;
+          int next = c + (y - x) * shifts[p];
+          if (isStop[static_cast<size_t>(next)])
+          {
+            ok = false;
+          }
+          else
+          {
+            if (gCode.areSynonymous(c, next))
+              s++;
+            else
+              n++;
+            c = next;
+          }
+        }
+        if (ok)
+        {
+          sd += s;
+          nd += n;
+          nbPaths++;
+        }
+      }
+      while (next_permutation(diffs.begin(), diffs.end()));
+      if (nbPaths > 0)
+      {
+        synDiffs_[k] = sd / nbPaths;
+        nonSynDiffs_[k] = nd / nbPaths;
+        isValid_[k] = true;
+      }
+    }
+  }
+}
+
+void CodonDivergenceMafStatistics::compute(const MafBlock& block)
+{
+  vector<double> values(pairs_.size() * 5);
+  if (block.hasSequenceForSpecies(refSpecies_))
+  {
+    // Get the codon positions along the reference:
+    const MafSequence& refSeq = block.sequenceForSpecies(refSpecies_);
+    size_t phase = 0;
+    if (block.hasProperty(GffFeatureReader::GFF_PHASE))
+      phase = static_cast<size_t>(dynamic_cast<const BppInteger&>(block.getProperty(GffFeatureReader::GFF_PHASE)).getValue());
+    vector<size_t> columns;
+    size_t nbBases = 0;
+    for (size_t i = 0; i < refSeq.size(); ++i)
+    {
+      if (refSeq[i] != -1)
+      {
+        if (nbBases++ >= phase)
+          columns.push_back(i);
+      }
+    }
+    size_t nbCodons = columns.size() / 3;
+
+    // Encode all sequences as codons once:
+    map<string, vector<int>> codons;
+    for (const auto& p : pairs_)
+    {
+      for (const string* sp : { &p.first, &p.second })
+      {
+        if (codons.find(*sp) != codons.end() || !block.hasSequenceForSpecies(*sp))
+          continue;
+        const vector<int>& seq = block.sequenceForSpecies(*sp).getContent();
+        vector<int>& cod = codons[*sp];
+        cod.resize(nbCodons);
+        for (size_t c = 0; c < nbCodons; ++c)
+        {
+          int x1 = seq[columns[3 * c]];
+          int x2 = seq[columns[3 * c + 1]];
+          int x3 = seq[columns[3 * c + 2]];
+          // -1 if any position is not A, C, G or T:
+          cod[c] = ((x1 | x2 | x3) & ~3) ? -1 : 16 * x1 + 4 * x2 + x3;
+        }
+      }
+    }
+
+    for (size_t p = 0; p < pairs_.size(); ++p)
+    {
+      auto it1 = codons.find(pairs_[p].first);
+      auto it2 = codons.find(pairs_[p].second);
+      if (it1 == codons.end() || it2 == codons.end())
+        continue;
+      const vector<int>& cod1 = it1->second;
+      const vector<int>& cod2 = it2->second;
+      double* v = &values[p * 5];
+      for (size_t c = 0; c < nbCodons; ++c)
+      {
+        if (cod1[c] < 0 || cod2[c] < 0)
+          continue;
+        size_t k = static_cast<size_t>(cod1[c] * 64 + cod2[c]);
+        if (!isValid_[k])
+          continue; // Stop codon.
+        double s = (synSites_[static_cast<size_t>(cod1[c])] + synSites_[static_cast<size_t>(cod2[c])]) / 2.;
+        v[0]++;
+        v[1] += s;
+        v[2] += 3. - s;
+        v[3] += synDiffs_[k];
+        v[4] += nonSynDiffs_[k];
+      }
+    }
+  }
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    result_.setValue(tags_[i], values[i]);
+    cumValues_[i / 5][i % 5] += values[i];
+  }
+}
+
+vector<string> HaplotypeMafStatistics::getSupportedTags() const
+{
+  vector<string> tags;
+  tags.push_back("NbSequences");
+  tags.push_back("NbHaplotypes");
+  tags.push_back("HaplotypeHomozygosity");
+  tags.push_back("HaplotypeDiversity");
+  return tags;
+}
+
+void HaplotypeMafStatistics::compute(const MafBlock& block)
+{
+  vector<const MafSequence*> selection = getSequenceSelection_(block);
+  size_t nbCols = block.getNumberOfSites();
+
+  // Remove haplotypes or sites with missing data, according to the policy:
+  vector<bool> keepCol(nbCols, true);
+  if (missingDataPolicy_ != MISSING_AS_STATE)
+  {
+    vector<const MafSequence*> complete;
+    for (const MafSequence* seq : selection)
+    {
+      const vector<int>& content = seq->getContent();
+      bool isComplete = AlphabetTraitsTools::dispatch(*seq->getAlphabet(), [&](const auto& traits) {
+            bool b = true;
+            for (size_t i = 0; i < nbCols; ++i)
+            {
+              if (!traits.isResolved(content[i]))
+              {
+                b = false;
+                keepCol[i] = false;
+              }
+            }
+            return b;
+          });
+      if (isComplete)
+        complete.push_back(seq);
+    }
+    if (missingDataPolicy_ == MISSING_IGNORE_SEQUENCES)
+    {
+      selection = complete;
+      fill(keepCol.begin(), keepCol.end(), true);
+    }
+  }
+  vector<size_t> columns;
+  for (size_t i = 0; i < nbCols; ++i)
+  {
+    if (keepCol[i])
+      columns.push_back(i);
+  }
+
+  // Pack and hash all haplotypes:
+  size_t n = selection.size();
+  size_t len = columns.size();
+  packed_.resize(n * len);
+  hashes_.resize(n);
+  for (size_t h = 0; h < n; ++h)
+  {
+    const vector<int>& content = selection[h]->getContent();
+    uint8_t* row = len > 0 ? &packed_[h * len] : nullptr;
+    uint64_t hash = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+      // States are shifted so that the gap (-1) is coded 0:
+      row[i] = static_cast<uint8_t>(content[columns[i]] + 1);
+      hash = hash * 0x100000001B3ULL + row[i];
+    }
+    hashes_[h] = hash;
+  }
+
+  // Count distinct haplotypes, with linear probing:
+  size_t tableSize = 1;
+  while (tableSize < 2 * n)
+  {
+    tableSize <<= 1;
+  }
+  table_.assign(tableSize, -1);
+  representatives_.clear();
+  counts_.clear();
+  for (size_t h = 0; h < n; ++h)
+  {
+    // Mix the bits of the hash before using it as an index:
+    uint64_t x = hashes_[h];
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    size_t slot = static_cast<size_t>(x) & (tableSize - 1);
+    while (true)
+    {
+      int k = table_[slot];
+      if (k == -1)
+      {
+        table_[slot] = static_cast<int>(representatives_.size());
+        representatives_.push_back(h);
+        counts_.push_back(1);
+        break;
+      }
+      size_t r = representatives_[static_cast<size_t>(k)];
+      if (hashes_[r] == hashes_[h] &&
+          equal(packed_.begin() + static_cast<ptrdiff_t>(r * len),
+                packed_.begin() + static_cast<ptrdiff_t>((r + 1) * len),
+                packed_.begin() + static_cast<ptrdiff_t>(h * len)))
+      {
+        counts_[static_cast<size_t>(k)]++;
+        break;
+      }
+      slot = (slot + 1) & (tableSize - 1);
+    }
+  }
+
+  double dn = static_cast<double>(n);
+  double homozygosity = 0;
+  for (unsigned int c : counts_)
+  {
+    double p = static_cast<double>(c) / dn;
+    homozygosity += p * p;
+  }
+  result_.setValue("NbSequences", static_cast<unsigned int>(n));
+  result_.setValue("NbHaplotypes", static_cast<unsigned int>(counts_.size()));
+  if (n > 0)
+    result_.setValue("HaplotypeHomozygosity", homozygosity);
+  else
+    result_.setValue("HaplotypeHomozygosity", NumConstants::NaN());
+  if (n > 1)
+    result_.setValue("HaplotypeDiversity", dn / (dn - 1.) * (1. - homozygosity));
+  else
+    result_.setValue("HaplotypeDiversity", NumConstants::NaN());
+}
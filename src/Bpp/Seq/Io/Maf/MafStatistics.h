@@ -6,6 +6,12 @@
 #define _MAFSTATISTICS_H_
 
 #include "MafBlock.h"
+#include "BiallelicHaplotypeMatrix.h"
+#include "ColumnClassifier.h"
+#include "DnaTraits.h"
+
+// From bpp-seq:
+#include <Bpp/Seq/GeneticCode/GeneticCode.h>
 
 // From bpp-core:
 #include <Bpp/Utils/MapTools.h>
@@ -15,6 +21,7 @@
 // From the STL:
 #include <map>
 #include <string>
+#include <cstdint>
 
 namespace bpp
 {
@@ -371,6 +378,12 @@ public:
 
 protected:
   std::unique_ptr<SiteContainerInterface> getSiteContainer_(const MafBlock& block);
+
+  /**
+   * @return Pointers toward the selected sequences in the block, without any copy.
+   * @param block The input block.
+   */
+  std::vector<const MafSequence*> getSequenceSelection_(const MafBlock& block) const;
 };
 
 
@@ -390,6 +403,12 @@ public:
 
 protected:
   std::vector<std::unique_ptr<SiteContainerInterface>> getSiteContainers_(const MafBlock& block);
+
+  /**
+   * @return Pointers toward the sequences of each selection in the block, without any copy.
+   * @param block The input block.
+   */
+  std::vector<std::vector<const MafSequence*>> getSequenceSelections_(const MafBlock& block) const;
 };
 
 
@@ -659,7 +678,7 @@ public:
   std::vector<std::string> getSupportedTags() const;
 
 private:
-  static std::vector<int> getPatterns_(const SiteContainerInterface& sites);
+  static std::vector<int> getPatterns_(const std::vector<const MafSequence*>& sequences, size_t nbColumns);
 };
 
 
@@ -694,6 +713,402 @@ public:
 private:
   static std::vector<int> getPatterns_(const SiteContainerInterface& sites);
 };
+
+
+/**
+ * @brief Compute the decay of linkage disequilibrium with distance.
+ *
+ * Biallelic sites of the selected sequences are extracted and bit-packed (see BiallelicHaplotypeMatrix),
+ * and the r² and D' measures are computed for all pairs of sites distant of at most a given number of positions.
+ * Pairs are then binned according to their distance, the first bin containing distances in ]0, binWidth],
+ * the second ]binWidth, 2 x binWidth], etc.
+ * Missing data (gaps and unresolved characters) are handled pairwise.
+ *
+ * For each block, the following values are provided:
+ * - NbBiallelic: the number of biallelic sites,
+ * - NbPairsBin[i]: the number of pairs of sites in bin i,
+ * - MeanR2Bin[i]: the average r² in bin i,
+ * - MeanDprimeBin[i]: the average D' in bin i.
+ *
+ * In addition, the numbers of pairs and sums of r² and D' are cumulated over all blocks
+ * to provide a genome-wide decay curve.
+ */
+class LinkageDisequilibriumMafStatistics :
+  public AbstractMafStatistics,
+  public AbstractSpeciesSelectionMafStatistics
+{
+private:
+  size_t maxDistance_;
+  size_t binWidth_;
+  std::string refSpecies_;
+  BiallelicHaplotypeMatrix haplotypes_;
+  std::vector<unsigned int> nbPairs_;
+  std::vector<double> sumR2_;
+  std::vector<double> sumDprime_;
+  std::vector<double> cumNbPairs_;
+  std::vector<double> cumSumR2_;
+  std::vector<double> cumSumDprime_;
+
+public:
+  /**
+   * @param species The species to use (one haplotype per sequence).
+   * @param maxDistance The maximum distance between two sites.
+   * @param binWidth The width of the distance bins.
+   * @param reference [optional] A reference species used to compute distances.
+   * If not specified, distances are computed in number of alignment columns.
+   */
+  LinkageDisequilibriumMafStatistics(
+      const std::vector<std::string>& species,
+      size_t maxDistance,
+      size_t binWidth,
+      const std::string& reference = "") :
+    AbstractMafStatistics(),
+    AbstractSpeciesSelectionMafStatistics(species),
+    maxDistance_(maxDistance),
+    binWidth_(binWidth),
+    refSpecies_(reference),
+    haplotypes_(),
+    nbPairs_(),
+    sumR2_(),
+    sumDprime_(),
+    cumNbPairs_(),
+    cumSumR2_(),
+    cumSumDprime_()
+  {
+    if (binWidth_ == 0)
+      throw Exception("LinkageDisequilibriumMafStatistics (constructor): bin width should be strictly positive.");
+    size_t nbBins = (maxDistance_ + binWidth_ - 1) / binWidth_;
+    nbPairs_.resize(nbBins);
+    sumR2_.resize(nbBins);
+    sumDprime_.resize(nbBins);
+    cumNbPairs_.resize(nbBins);
+    cumSumR2_.resize(nbBins);
+    cumSumDprime_.resize(nbBins);
+  }
+
+  virtual ~LinkageDisequilibriumMafStatistics() {}
+
+public:
+  std::string getShortName() const { return "LinkageDisequilibrium"; }
+  std::string getFullName() const { return "Linkage disequilibrium decay."; }
+  void compute(const MafBlock& block);
+  std::vector<std::string> getSupportedTags() const;
+
+  size_t getNumberOfBins() const { return nbPairs_.size(); }
+
+  /**
+   * @return The number of pairs in each distance bin, cumulated over all blocks analysed so far.
+   */
+  const std::vector<double>& getCumulatedNumberOfPairs() const { return cumNbPairs_; }
+
+  /**
+   * @return The average r² in each distance bin, over all blocks analysed so far.
+   */
+  std::vector<double> getCumulatedMeanR2() const;
+
+  /**
+   * @return The average D' in each distance bin, over all blocks analysed so far.
+   */
+  std::vector<double> getCumulatedMeanDprime() const;
+
+  void resetCumulatedValues()
+  {
+    std::fill(cumNbPairs_.begin(), cumNbPairs_.end(), 0.);
+    std::fill(cumSumR2_.begin(), cumSumR2_.end(), 0.);
+    std::fill(cumSumDprime_.begin(), cumSumDprime_.end(), 0.);
+  }
+};
+
+
+/**
+ * @brief Compute the trinucleotide-context substitution spectrum of a maf block.
+ *
+ * Each alignment column is polarized using an outgroup sequence: the outgroup state is taken
+ * as the ancestral state, and its context is given by the flanking columns of a context sequence
+ * (by default the outgroup itself). A substitution is counted when the ingroup sequences
+ * carry exactly one state different from the outgroup (either polymorphic with the ancestral state, or fixed).
+ * Columns where the ingroup contains a gap or unresolved character, or more than one derived state, are ignored,
+ * as well as columns where the ancestral state or its context is not resolved.
+ *
+ * Substitutions are reported as the 96 classes of single base substitutions,
+ * where the ancestral base is a pyrimidine (substitutions from a purine are reverse-complemented).
+ * Tags follow the usual notation, e.g. A[C>T]G. The number of polarized columns is given by the "NbPolarized" tag.
+ *
+ * Internally, each column is encoded as a 6 bits context (left base, ancestral base, right base) plus 2 bits for the derived base,
+ * which are used to increment a fixed array of 256 counters. Classes are only collapsed when results are requested.
+ * Counts are also cumulated over all blocks; instances analysing distinct parts of the data can be combined with mergeCumulatedCounts.
+ */
+class MutationSpectrumMafStatistics :
+  public AbstractMafStatistics,
+  public AbstractSpeciesSelectionMafStatistics
+{
+private:
+  std::string outgroup_;
+  std::string contextSpecies_;
+  std::vector<unsigned int> counts_;
+  std::vector<double> cumCounts_;
+  std::vector<short> classes_;
+  std::vector<std::string> classNames_;
+
+public:
+  /**
+   * @param ingroup The ingroup species.
+   * @param outgroup The outgroup species, used to polarize substitutions.
+   * @param contextSpecies [optional] The species used to get the flanking context. If empty, the outgroup is used.
+   */
+  MutationSpectrumMafStatistics(
+      const std::vector<std::string>& ingroup,
+      const std::string& outgroup,
+      const std::string& contextSpecies = "");
+
+  virtual ~MutationSpectrumMafStatistics() {}
+
+public:
+  std::string getShortName() const { return "MutationSpectrum"; }
+  std::string getFullName() const { return "Trinucleotide-context substitution spectrum."; }
+  void compute(const MafBlock& block);
+  std::vector<std::string> getSupportedTags() const;
+
+  /**
+   * @return The counts for the 96 classes, cumulated over all blocks analysed so far.
+   * Classes are in the same order as the tags returned by getSupportedTags().
+   */
+  const std::vector<double>& getCumulatedSpectrum() const { return cumCounts_; }
+
+  /**
+   * @brief Add the cumulated counts of another instance to this one.
+   *
+   * @param stats Another instance, typically used on another part of the data set.
+   */
+  void mergeCumulatedCounts(const MutationSpectrumMafStatistics& stats)
+  {
+    for (size_t i = 0; i < cumCounts_.size(); ++i)
+    {
+      cumCounts_[i] += stats.cumCounts_[i];
+    }
+  }
+
+  void resetCumulatedCounts()
+  {
+    std::fill(cumCounts_.begin(), cumCounts_.end(), 0.);
+  }
+};
+
+
+/**
+ * @brief Compute pairwise substitution count matrices between pairs of species.
+ *
+ * For each requested pair of species, a 4x4 matrix (or 5x5 if gaps are included) counts the number of
+ * columns with state a in the first species and state b in the second species.
+ * Columns with unresolved characters in any of the two sequences are ignored.
+ * If a species is missing from a block, all counts are 0 for the corresponding pairs.
+ * If a species has more than one sequence in a block, the first one is used.
+ *
+ * For each pair, results are provided with tags "Species1-Species2.ab", where a and b are the states in the two species
+ * (A, C, G, T, or - for gaps). Matrices are also cumulated over all blocks, for genome-wide analyses.
+ *
+ * Rows are first converted to one byte codes, and counts are obtained by incrementing a
+ * 36 bins histogram indexed by a * 6 + b, without any test in the inner loop.
+ */
+class SubstitutionMatrixMafStatistics :
+  public AbstractMafStatistics
+{
+private:
+  std::vector<std::pair<std::string, std::string>> pairs_;
+  bool withGaps_;
+  size_t size_;
+  std::vector<std::vector<double>> cumCounts_;
+  std::vector<std::string> tags_;
+
+public:
+  /**
+   * @param pairs The pairs of species to compare.
+   * @param withGaps Tell if gaps should be counted as a fifth state.
+   */
+  SubstitutionMatrixMafStatistics(
+      const std::vector<std::pair<std::string, std::string>>& pairs,
+      bool withGaps = false);
+
+  /**
+   * @param reference The reference species.
+   * @param species The species to compare to the reference.
+   * @param withGaps Tell if gaps should be counted as a fifth state.
+   */
+  SubstitutionMatrixMafStatistics(
+      const std::string& reference,
+      const std::vector<std::string>& species,
+      bool withGaps = false);
+
+  virtual ~SubstitutionMatrixMafStatistics() {}
+
+public:
+  std::string getShortName() const { return "SubstitutionMatrix"; }
+  std::string getFullName() const { return "Pairwise substitution count matrices."; }
+  void compute(const MafBlock& block);
+  std::vector<std::string> getSupportedTags() const { return tags_; }
+
+  size_t getNumberOfPairs() const { return pairs_.size(); }
+
+  /**
+   * @return The cumulated count matrix for a given pair, as a vector in row-major order (4x4 or 5x5).
+   * @param i The index of the pair.
+   */
+  const std::vector<double>& getCumulatedMatrix(size_t i) const { return cumCounts_[i]; }
+
+  /**
+   * @brief Add the cumulated counts of another instance with the same pairs to this one.
+   *
+   * @param stats Another instance, typically used on another part of the data set.
+   */
+  void mergeCumulatedCounts(const SubstitutionMatrixMafStatistics& stats);
+
+  void resetCumulatedCounts()
+  {
+    for (auto& m : cumCounts_)
+    {
+      std::fill(m.begin(), m.end(), 0.);
+    }
+  }
+
+private:
+  void init_();
+
+  static void encodeRow_(const std::vector<int>& row, std::vector<unsigned char>& codes);
+};
+
+
+/**
+ * @brief Compute synonymous and nonsynonymous sites and differences between pairs of species, for coding alignments.
+ *
+ * Counts follow the method of Nei and Gojobori (1986): for each codon, the number of synonymous sites
+ * is the proportion of single point mutations that are synonymous, summed over the three positions
+ * (mutations to stop codons are counted as nonsynonymous). Sites are averaged over the two codons compared.
+ * When two codons differ at more than one position, differences are averaged over all mutational pathways
+ * which do not go through a stop codon.
+ *
+ * Codons are read along the reference sequence: columns where the reference has a gap are skipped,
+ * and the first codon starts after the number of positions given by the phase of the block.
+ * The phase is read from the GffFeatureReader::GFF_PHASE block property (as set by FeatureExtractorMafIterator),
+ * and is 0 if the property is absent.
+ * Codons containing a gap or unresolved character, or a stop codon, in any of the two species of a pair are ignored.
+ *
+ * All values are read from 64x64 tables precomputed from the genetic code at construction.
+ * For each pair, the following tags are provided (prefixed by "Species1-Species2."):
+ * - NbCodons: number of codons compared,
+ * - SynSites, NonSynSites: number of synonymous and nonsynonymous sites,
+ * - SynDiffs, NonSynDiffs: number of synonymous and nonsynonymous differences.
+ * These values are also cumulated over all blocks.
+ */
+class CodonDivergenceMafStatistics :
+  public AbstractMafStatistics
+{
+private:
+  std::string refSpecies_;
+  std::vector<std::pair<std::string, std::string>> pairs_;
+  std::vector<double> synSites_;
+  std::vector<double> synDiffs_;
+  std::vector<double> nonSynDiffs_;
+  std::vector<bool> isValid_;
+  std::vector<std::string> tags_;
+  std::vector<std::vector<double>> cumValues_;
+
+public:
+  /**
+   * @param gCode The genetic code to use.
+   * @param reference The reference species, defining the reading frame.
+   * @param species The species to compare. All pairs of species will be compared.
+   */
+  CodonDivergenceMafStatistics(
+      const GeneticCode& gCode,
+      const std::string& reference,
+      const std::vector<std::string>& species);
+
+  virtual ~CodonDivergenceMafStatistics() {}
+
+public:
+  std::string getShortName() const { return "CodonDivergence"; }
+  std::string getFullName() const { return "Synonymous and nonsynonymous divergence."; }
+  void compute(const MafBlock& block);
+  std::vector<std::string> getSupportedTags() const { return tags_; }
+
+  size_t getNumberOfPairs() const { return pairs_.size(); }
+
+  /**
+   * @return The cumulated values for a given pair, in the order NbCodons, SynSites, NonSynSites, SynDiffs, NonSynDiffs.
+   * @param i The index of the pair.
+   */
+  const std::vector<double>& getCumulatedValues(size_t i) const { return cumValues_[i]; }
+
+private:
+  void initTables_(const GeneticCode& gCode);
+};
+
+/**
+ * @brief Compute haplotype-based diversity statistics.
+ *
+ * Each selected sequence is considered as a haplotype. Sequences are packed into one byte per position
+ * and hashed with a rolling 64-bit polynomial hash, the number of distinct haplotypes being then
+ * counted with an open-addressing hash table, in linear time with the size of the block.
+ * Haplotypes with identical hash are compared position by position, so that collisions do not bias the counts.
+ * To compute statistics in windows, use this class together with WindowSplitMafIterator.
+ *
+ * Missing data (gaps and unresolved characters) are handled according to one of the following policies:
+ * - MISSING_IGNORE_SEQUENCES: sequences with at least one missing character are discarded,
+ * - MISSING_IGNORE_SITES: positions with at least one missing character in any sequence are discarded,
+ * - MISSING_AS_STATE: missing characters are treated as regular states.
+ *
+ * The following values are provided:
+ * - NbSequences: the number of haplotypes used,
+ * - NbHaplotypes: the number of distinct haplotypes,
+ * - HaplotypeHomozygosity: the sum of the squared haplotype frequencies,
+ * - HaplotypeDiversity: Nei's unbiased haplotype diversity, n / (n - 1) (1 - sum p_i²).
+ */
+class HaplotypeMafStatistics :
+  public AbstractMafStatistics,
+  public AbstractSpeciesSelectionMafStatistics
+{
+public:
+  static constexpr short MISSING_IGNORE_SEQUENCES = 0;
+  static constexpr short MISSING_IGNORE_SITES = 1;
+  static constexpr short MISSING_AS_STATE = 2;
+
+private:
+  short missingDataPolicy_;
+  std::vector<uint8_t> packed_;
+  std::vector<uint64_t> hashes_;
+  std::vector<int> table_;
+  std::vector<size_t> representatives_;
+  std::vector<unsigned int> counts_;
+
+public:
+  /**
+   * @param species The species to use (one haplotype per sequence).
+   * @param missingDataPolicy How to handle missing data (see class description).
+   */
+  HaplotypeMafStatistics(const std::vector<std::string>& species, short missingDataPolicy = MISSING_IGNORE_SEQUENCES) :
+    AbstractMafStatistics(),
+    AbstractSpeciesSelectionMafStatistics(species),
+    missingDataPolicy_(missingDataPolicy),
+    packed_(),
+    hashes_(),
+    table_(),
+    representatives_(),
+    counts_()
+  {
+    if (missingDataPolicy != MISSING_IGNORE_SEQUENCES &&
+        missingDataPolicy != MISSING_IGNORE_SITES &&
+        missingDataPolicy != MISSING_AS_STATE)
+      throw Exception("HaplotypeMafStatistics (constructor). Unknown policy for missing data.");
+  }
+
+  virtual ~HaplotypeMafStatistics() {}
+
+public:
+  std::string getShortName() const { return "HaplotypeStatistics"; }
+  std::string getFullName() const { return "Haplotype diversity statistics."; }
+  void compute(const MafBlock& block);
+  std::vector<std::string> getSupportedTags() const;
+};
 } // end of namespace bpp
 
 #endif // _MAFSTATISTICS_H_
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MaskIntervalOutputMafIterator.h"
+#include "DnaTraits.h"
+#include "BitTools.h"
+
+// From bpp-seq:
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+using namespace std;
+
+void MaskIntervalOutputMafIterator::addBlock_(const MafBlock& block)
+{
+  isFlushed_ = false;
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    const MafSequence& seq = block.sequence(i);
+    if (!species_.empty() && find(species_.begin(), species_.end(), seq.getSpecies()) == species_.end())
+      continue;
+    if (!seq.hasCoordinates() || !seq.hasAnnotation(SequenceMask::MASK))
+      continue;
+    addSequence_(seq);
+  }
+}
+
+void MaskIntervalOutputMafIterator::addSequence_(const MafSequence& seq)
+{
+  const vector<bool>& mask = dynamic_cast<const SequenceMask&>(seq.annotation(SequenceMask::MASK)).getMask();
+  const vector<int>& content = seq.getContent();
+  size_t n = min(mask.size(), content.size());
+  size_t nbWords = BitTools::getNumberOfWords(n);
+
+  // Pack masked residues and residues into bit vectors:
+  maskWords_.assign(nbWords, 0);
+  residueWords_.assign(nbWords, 0);
+  for (size_t w = 0; w < nbWords; ++w)
+  {
+    size_t first = w << 6;
+    size_t last = min(first + 64, n);
+    uint64_t m = 0, r = 0;
+    for (size_t j = first; j < last; ++j)
+    {
+      uint64_t isResidue = DnaTraits::isGap(content[j]) ? 0 : 1;
+      uint64_t isMasked = mask[j] ? isResidue : 0;
+      r |= isResidue << (j - first);
+      m |= isMasked << (j - first);
+    }
+    maskWords_[w] = m;
+    residueWords_[w] = r;
+  }
+
+  // Find masked runs and convert them to genomic coordinates:
+  const string& species = seq.getSpecies();
+  const string& chr = seq.getChromosome();
+  bool negative = seq.getStrand() == '-';
+  size_t offset = seq.start();
+  size_t srcSize = seq.getSrcSize();
+  size_t pos = 0;
+  size_t rank = 0; // Number of residues before pos.
+  while (pos < n)
+  {
+    size_t a = BitTools::findNextSetBit(maskWords_.data(), n, pos);
+    if (a >= n)
+      break;
+    size_t b = BitTools::findNextClearBit(maskWords_.data(), n, a);
+    // Extend over runs only separated by gaps:
+    while (b < n)
+    {
+      size_t c = BitTools::findNextSetBit(residueWords_.data(), n, b);
+      if (c >= n || !BitTools::testBit(maskWords_.data(), c))
+        break;
+      b = BitTools::findNextClearBit(maskWords_.data(), n, c);
+    }
+    size_t start = rank + BitTools::countBits(residueWords_.data(), pos, a);
+    size_t end = start + BitTools::countBits(residueWords_.data(), a, b);
+    rank = end;
+    pos = b;
+    if (negative)
+      addInterval_(species, chr, srcSize - offset - end, srcSize - offset - start);
+    else
+      addInterval_(species, chr, offset + start, offset + end);
+  }
+}
+
+void MaskIntervalOutputMafIterator::addInterval_(const string& species, const string& chr, size_t start, size_t end)
+{
+  auto key = make_pair(species, chr);
+  auto it = pending_.find(key);
+  if (it == pending_.end())
+  {
+    Interval_& interval = pending_[key];
+    interval.start = start;
+    interval.end = end;
+    return;
+  }
+  Interval_& interval = it->second;
+  if (start == interval.end)
+  {
+    interval.end = end;
+  }
+  else if (end == interval.start)
+  {
+    interval.start = start;
+  }
+  else
+  {
+    writeInterval_(species, chr, interval);
+    interval.start = start;
+    interval.end = end;
+  }
+}
+
+void MaskIntervalOutputMafIterator::writeInterval_(const string& species, const string& chr, const Interval_& interval)
+{
+  if (output_ && interval.end - interval.start >= minLength_)
+    *output_ << chr << "\t" << interval.start << "\t" << interval.end << "\t" << species << "\n";
+}
+
+void MaskIntervalOutputMafIterator::flush()
+{
+  if (isFlushed_)
+    return;
+  for (const auto& it : pending_)
+  {
+    writeInterval_(it.first.first, it.first.second, it.second);
+  }
+  pending_.clear();
+  if (output_)
+    output_->flush();
+  isFlushed_ = true;
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MASKINTERVALOUTPUTMAFITERATOR_H_
+#define _MASKINTERVALOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief This iterator writes the soft-masked intervals of each species in BED format.
+ *
+ * Masks are read from the SequenceMask annotation of each sequence, which is created by MafParser
+ * when masks are parsed. Sequences without mask or without coordinates are ignored.
+ * Each interval is written as a line 'chromosome start end species', with 0-based, half-open coordinates
+ * on the positive strand of the chromosome.
+ *
+ * For each sequence, the mask and the positions of non-gap characters are packed into bit vectors,
+ * so that the bounds of masked runs are found a word at a time, and their genomic coordinates are
+ * obtained by counting the non-gap positions before them. Runs only separated by gaps are merged.
+ *
+ * Intervals are merged across blocks in a streaming fashion: the last interval of each species and chromosome
+ * is kept, and extended if the next masked run of this species on this chromosome is adjacent to it.
+ * Otherwise it is written. Intervals are therefore fully merged when blocks are sorted along each chromosome
+ * of each species, even if blocks from several chromosomes are interleaved, as is typically the case for
+ * non-reference species. Otherwise, adjacent intervals may be written on several lines.
+ */
+class MaskIntervalOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+private:
+  struct Interval_
+  {
+    size_t start;
+    size_t end;
+
+    Interval_() : start(0), end(0) {}
+  };
+
+  std::shared_ptr<std::ostream> output_;
+  std::vector<std::string> species_;
+  size_t minLength_;
+  std::map<std::pair<std::string, std::string>, Interval_> pending_; // Indexed by species and chromosome.
+  std::vector<uint64_t> maskWords_;
+  std::vector<uint64_t> residueWords_;
+  bool isFlushed_;
+
+public:
+  /**
+   * @brief Build a new MaskIntervalOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param out The output stream where to write the intervals.
+   * @param species The species for which masked intervals should be written. If empty, all species are considered.
+   * @param minLength The minimum length of an interval to be written.
+   */
+  MaskIntervalOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      const std::vector<std::string>& species = std::vector<std::string>(),
+      size_t minLength = 1) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    species_(species),
+    minLength_(minLength),
+    pending_(),
+    maskWords_(),
+    residueWords_(),
+    isFlushed_(false)
+  {}
+
+  virtual ~MaskIntervalOutputMafIterator()
+  {
+    try
+    {
+      flush();
+    }
+    catch (...)
+    {}
+  }
+
+private:
+  MaskIntervalOutputMafIterator(const MaskIntervalOutputMafIterator&) = delete;
+  MaskIntervalOutputMafIterator& operator=(const MaskIntervalOutputMafIterator&) = delete;
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (currentBlock_)
+      addBlock_(*currentBlock_);
+    else
+      flush();
+    return std::move(currentBlock_);
+  }
+
+  /**
+   * @brief Write all pending intervals.
+   *
+   * This is called automatically when the end of the input is reached.
+   */
+  void flush();
+
+private:
+  void addBlock_(const MafBlock& block);
+
+  void addSequence_(const MafSequence& seq);
+
+  /**
+   * @brief Merge an interval with the pending interval of a species on a chromosome, or write the pending one and replace it.
+   */
+  void addInterval_(const std::string& species, const std::string& chr, size_t start, size_t end);
+
+  void writeInterval_(const std::string& species, const std::string& chr, const Interval_& interval);
+};
+} // end of namespace bpp.
+
+#endif // _MASKINTERVALOUTPUTMAFITERATOR_H_
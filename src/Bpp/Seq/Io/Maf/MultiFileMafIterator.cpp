@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "MultiFileMafIterator.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+
+using namespace std;
+
+namespace
+{
+// Comparison for a min-heap: returns true if e1 should come after e2.
+template<class Entry>
+bool comesAfter(const Entry& e1, const Entry& e2)
+{
+  // Blocks without key come first:
+  if (e1.hasKey != e2.hasKey)
+    return e1.hasKey;
+  if (e1.hasKey)
+  {
+    int c = e1.chr.compare(e2.chr);
+    if (c != 0)
+      return c > 0;
+    if (e1.start != e2.start)
+      return e1.start > e2.start;
+  }
+  return e1.input > e2.input;
+}
+}
+
+void MultiFileMafIterator::pushNextBlock_(size_t input)
+{
+  auto block = inputs_[input]->nextBlock();
+  if (!block)
+    return;
+  Entry_ entry;
+  entry.input = input;
+  if (block->hasSequenceForSpecies(refSpecies_))
+  {
+    const MafSequence& refSeq = block->sequenceForSpecies(refSpecies_);
+    if (refSeq.hasCoordinates())
+    {
+      entry.hasKey = true;
+      entry.chr = refSeq.getChromosome();
+      entry.start = refSeq.getRange().begin();
+    }
+  }
+  entry.block = std::move(block);
+  heap_.push_back(std::move(entry));
+  push_heap(heap_.begin(), heap_.end(), comesAfter<Entry_>);
+}
+
+unique_ptr<MafBlock> MultiFileMafIterator::analyseCurrentBlock_()
+{
+  if (mode_ == MODE_CONCATENATE)
+  {
+    while (currentInput_ < inputs_.size())
+    {
+      auto block = inputs_[currentInput_]->nextBlock();
+      if (block)
+        return block;
+      if (verbose_)
+        ApplicationTools::displayMessage("MultiFileMafIterator: input " + TextTools::toString(currentInput_ + 1) + " done.");
+      currentInput_++;
+    }
+    return nullptr;
+  }
+
+  // Merge mode:
+  if (!heapInitialized_)
+  {
+    heap_.reserve(inputs_.size());
+    for (size_t i = 0; i < inputs_.size(); ++i)
+    {
+      pushNextBlock_(i);
+    }
+    heapInitialized_ = true;
+  }
+  if (heap_.empty())
+    return nullptr;
+  pop_heap(heap_.begin(), heap_.end(), comesAfter<Entry_>);
+  auto block = std::move(heap_.back().block);
+  size_t input = heap_.back().input;
+  heap_.pop_back();
+  // Refill from the input the block came from, so that there is always one block per active input:
+  pushNextBlock_(input);
+  return block;
+}
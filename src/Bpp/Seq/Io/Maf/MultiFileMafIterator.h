@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _MULTIFILEMAFITERATOR_H_
+#define _MULTIFILEMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+
+#include <Bpp/Text/TextTools.h>
+
+// From the STL:
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace bpp
+{
+/**
+ * @brief A MafIterator reading blocks from several input iterators, typically one MafParser per file.
+ *
+ * Two modes are available:
+ * - MODE_CONCATENATE: all blocks of the first input are returned, then all blocks of the second one, etc.
+ *   Only the current input is read.
+ * - MODE_MERGE: blocks are returned in increasing order of chromosome name and start position of the reference species,
+ *   with a k-way merge of the inputs. Each input must itself be sorted in this order, which is for instance the case
+ *   of files split by chromosome or by chunks of a sorted alignment, even if chunks overlap.
+ *   Blocks without the reference species, or without coordinates, are returned as soon as they are read.
+ *   Ties are resolved by the order of the inputs.
+ *
+ * In merge mode, exactly one block per input is read in advance, and the next block is selected with a binary heap,
+ * so that memory usage does not depend on the size of the inputs, and the cost per block is logarithmic in the number of inputs.
+ */
+class MultiFileMafIterator :
+  public AbstractMafIterator
+{
+public:
+  static constexpr short MODE_CONCATENATE = 0;
+  static constexpr short MODE_MERGE = 1;
+
+private:
+  struct Entry_
+  {
+    std::unique_ptr<MafBlock> block;
+    bool hasKey;
+    std::string chr;
+    size_t start;
+    size_t input;
+
+    Entry_() : block(), hasKey(false), chr(), start(0), input(0) {}
+  };
+
+private:
+  std::vector<std::shared_ptr<MafIteratorInterface>> inputs_;
+  short mode_;
+  std::string refSpecies_;
+  size_t currentInput_;
+  std::vector<Entry_> heap_;
+  bool heapInitialized_;
+
+public:
+  /**
+   * @brief Build a new MultiFileMafIterator object.
+   *
+   * @param inputs The input iterators.
+   * @param mode One of MODE_CONCATENATE or MODE_MERGE.
+   * @param reference The species used to sort blocks, in merge mode.
+   */
+  MultiFileMafIterator(
+      const std::vector<std::shared_ptr<MafIteratorInterface>>& inputs,
+      short mode = MODE_CONCATENATE,
+      const std::string& reference = "") :
+    inputs_(inputs),
+    mode_(mode),
+    refSpecies_(reference),
+    currentInput_(0),
+    heap_(),
+    heapInitialized_(false)
+  {
+    if (mode_ != MODE_CONCATENATE && mode_ != MODE_MERGE)
+      throw Exception("MultiFileMafIterator. Unknown mode: " + TextTools::toString(mode_) + ".");
+    if (mode_ == MODE_MERGE && refSpecies_ == "")
+      throw Exception("MultiFileMafIterator. A reference species must be specified for merging.");
+  }
+
+private:
+  // Recopy is forbidden!
+  MultiFileMafIterator(const MultiFileMafIterator& iterator) :
+    AbstractMafIterator(iterator),
+    inputs_(),
+    mode_(iterator.mode_),
+    refSpecies_(iterator.refSpecies_),
+    currentInput_(0),
+    heap_(),
+    heapInitialized_(false)
+  {}
+
+  MultiFileMafIterator& operator=(const MultiFileMafIterator& iterator)
+  {
+    AbstractMafIterator::operator=(iterator);
+    inputs_.clear();
+    mode_ = iterator.mode_;
+    refSpecies_ = iterator.refSpecies_;
+    currentInput_ = 0;
+    heap_.clear();
+    heapInitialized_ = false;
+    return *this;
+  }
+
+public:
+  size_t getNumberOfInputs() const { return inputs_.size(); }
+
+private:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_();
+
+  /**
+   * @brief Read the next block of an input and add it to the heap, if any.
+   */
+  void pushNextBlock_(size_t input);
+};
+} // end of namespace bpp.
+
+#endif // _MULTIFILEMAFITERATOR_H_
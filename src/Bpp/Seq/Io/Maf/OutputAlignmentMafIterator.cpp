@@ -51,6 +51,13 @@ unique_ptr<MafBlock> OutputAlignmentMafIterator::analyseCurrentBlock_()
 
 void OutputAlignmentMafIterator::writeBlock(std::ostream& out, const MafBlock& block) const
 {
+  if (directWriter_)
+  {
+    if (addLDHatHeader_)
+      out << block.getNumberOfSequences() << " " << block.getNumberOfSites() << " 1" << endl; // We here assume sequences are haploid.
+    directWriter_->writeBlock(out, block);
+    return;
+  }
   // First get alignment:
   auto aln = block.getAlignment();
   // Format sequence names:
@@ -6,6 +6,7 @@
 #define _OUTPUTALIGNMENTMAFITERATOR_H_
 
 #include "AbstractMafIterator.h"
+#include "MafAlignmentWriter.h"
 
 // From bpp-seq:
 #include <Bpp/Seq/Io/OSequence.h>
@@ -31,6 +32,7 @@ private:
   bool outputCoordinates_;
   bool addLDHatHeader_;
   std::unique_ptr<OAlignment> writer_;
+  std::unique_ptr<MafAlignmentWriterInterface> directWriter_;
   unsigned int currentBlockIndex_;
   std::string refSpecies_;
 
@@ -65,6 +67,7 @@ public:
     outputCoordinates_(outputCoordinates),
     addLDHatHeader_(addLDHatHeader),
     writer_(std::move(writer)),
+    directWriter_(),
     currentBlockIndex_(0),
     refSpecies_(reference)
   {
@@ -103,6 +106,7 @@ public:
     outputCoordinates_(outputCoordinates),
     addLDHatHeader_(addLDHatHeader),
     writer_(std::move(writer)),
+    directWriter_(),
     currentBlockIndex_(0),
     refSpecies_(reference)
   {
@@ -110,6 +114,66 @@ public:
       throw Exception("OutputAlignmentMafIterator (constructor 2): sequence writer should not be a NULL pointer!");
   }
 
+  /**
+   * @brief Creates a new OutputAlignmentMafIterator object using a direct writer.
+   *
+   * Blocks are formatted directly from their rows, without conversion to an alignment container.
+   * Sequence names are generated by the writer (see AbstractMafAlignmentWriter for the name template).
+   * @param iterator The input iterator
+   * @param out A pointer toward the output stream.
+   * @param writer The direct writer to use, which will be own by this instance.
+   * @param addLDHatHeader Tell if first line of file should contain number and lenght of sequences (for instance for use with LDhat/convert).
+   */
+  OutputAlignmentMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<std::ostream> out,
+      std::unique_ptr<MafAlignmentWriterInterface> writer,
+      bool addLDHatHeader = false) :
+    AbstractFilterMafIterator(iterator),
+    output_(out),
+    file_(),
+    mask_(false),
+    outputCoordinates_(false),
+    addLDHatHeader_(addLDHatHeader),
+    writer_(),
+    directWriter_(std::move(writer)),
+    currentBlockIndex_(0),
+    refSpecies_()
+  {
+    if (!directWriter_)
+      throw Exception("OutputAlignmentMafIterator (constructor 3): sequence writer should not be a NULL pointer!");
+  }
+
+  /**
+   * @brief Creates a new OutputAlignmentMafIterator object using a direct writer, with one file per block.
+   *
+   * @param iterator The input iterator
+   * @param file A string describing the path to the output files (see constructor 2).
+   * @param writer The direct writer to use, which will be own by this instance.
+   * @param addLDHatHeader Tell if first line of file should contain number and lenght of sequences (for instance for use with LDhat/convert).
+   * @param reference [optional] specify a reference species which can be used to configure file names.
+   */
+  OutputAlignmentMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      const std::string& file,
+      std::unique_ptr<MafAlignmentWriterInterface> writer,
+      bool addLDHatHeader = false,
+      const std::string& reference = "") :
+    AbstractFilterMafIterator(iterator),
+    output_(0),
+    file_(file),
+    mask_(false),
+    outputCoordinates_(false),
+    addLDHatHeader_(addLDHatHeader),
+    writer_(),
+    directWriter_(std::move(writer)),
+    currentBlockIndex_(0),
+    refSpecies_(reference)
+  {
+    if (!directWriter_)
+      throw Exception("OutputAlignmentMafIterator (constructor 4): sequence writer should not be a NULL pointer!");
+  }
+
   virtual ~OutputAlignmentMafIterator() {}
 
 private:
@@ -121,6 +185,7 @@ private:
     outputCoordinates_(iterator.outputCoordinates_),
     addLDHatHeader_(iterator.addLDHatHeader_),
     writer_(),
+    directWriter_(),
     currentBlockIndex_(iterator.currentBlockIndex_),
     refSpecies_(iterator.refSpecies_)
   {}
@@ -133,6 +198,7 @@ private:
     outputCoordinates_ = iterator.outputCoordinates_;
     addLDHatHeader_ = iterator.addLDHatHeader_;
     writer_.release();
+    directWriter_.release();
     currentBlockIndex_ = iterator.currentBlockIndex_;
     refSpecies_ = iterator.refSpecies_;
     return *this;
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "PoissonBootstrap.h"
+
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+PoissonBootstrap::PoissonBootstrap(size_t nbReplicates, size_t nbStatistics, uint64_t seed) :
+  nbReplicates_(nbReplicates),
+  nbStatistics_(nbStatistics),
+  seed_(seed),
+  nbUnits_(0),
+  observedSums_(nbStatistics, 0.),
+  observedCounts_(nbStatistics, 0.),
+  sums_(nbReplicates * nbStatistics, 0.),
+  counts_(nbReplicates * nbStatistics, 0.),
+  weights_(nbReplicates)
+{
+  if (nbReplicates == 0)
+    throw Exception("PoissonBootstrap. The number of replicates should be at least 1.");
+}
+
+unsigned int PoissonBootstrap::poisson1(uint64_t random)
+{
+  // Uniform number in [0, 1[ with 53 bits of precision:
+  double u = static_cast<double>(random >> 11) * (1. / 9007199254740992.);
+  double p = exp(-1.);
+  double cdf = p;
+  unsigned int k = 0;
+  while (u >= cdf && k < 32)
+  {
+    k++;
+    p /= k;
+    cdf += p;
+  }
+  return k;
+}
+
+void PoissonBootstrap::getWeights(uint64_t unit, vector<unsigned int>& weights) const
+{
+  weights.resize(nbReplicates_);
+  uint64_t key = mix(seed_ ^ mix(unit + 0x9E3779B97F4A7C15ULL));
+  for (size_t r = 0; r < nbReplicates_; ++r)
+  {
+    weights[r] = poisson1(mix(key + static_cast<uint64_t>(r + 1) * 0x9E3779B97F4A7C15ULL));
+  }
+}
+
+void PoissonBootstrap::add(const vector<double>& values)
+{
+  if (values.size() != nbStatistics_)
+    throw Exception("PoissonBootstrap::add. Wrong number of values: " + TextTools::toString(values.size()) + ", should be " + TextTools::toString(nbStatistics_) + ".");
+  getWeights(nbUnits_++, weights_);
+  for (size_t i = 0; i < nbStatistics_; ++i)
+  {
+    double x = values[i];
+    if (std::isnan(x))
+      continue;
+    observedSums_[i] += x;
+    observedCounts_[i]++;
+  }
+  for (size_t r = 0; r < nbReplicates_; ++r)
+  {
+    unsigned int w = weights_[r];
+    if (w == 0)
+      continue;
+    double* sums = &sums_[r * nbStatistics_];
+    double* counts = &counts_[r * nbStatistics_];
+    for (size_t i = 0; i < nbStatistics_; ++i)
+    {
+      double x = values[i];
+      if (std::isnan(x))
+        continue;
+      sums[i] += w * x;
+      counts[i] += w;
+    }
+  }
+}
+
+double PoissonBootstrap::getObservedMean(size_t statistic) const
+{
+  return observedCounts_[statistic] > 0 ? observedSums_[statistic] / observedCounts_[statistic] : numeric_limits<double>::quiet_NaN();
+}
+
+void PoissonBootstrap::getReplicateSums(size_t statistic, vector<double>& values) const
+{
+  values.resize(nbReplicates_);
+  for (size_t r = 0; r < nbReplicates_; ++r)
+  {
+    values[r] = sums_[r * nbStatistics_ + statistic];
+  }
+}
+
+void PoissonBootstrap::getReplicateMeans(size_t statistic, vector<double>& values) const
+{
+  values.resize(nbReplicates_);
+  for (size_t r = 0; r < nbReplicates_; ++r)
+  {
+    double n = counts_[r * nbStatistics_ + statistic];
+    values[r] = n > 0 ? sums_[r * nbStatistics_ + statistic] / n : numeric_limits<double>::quiet_NaN();
+  }
+}
+
+void PoissonBootstrap::getPercentileInterval(vector<double> values, double level, double& lower, double& upper)
+{
+  values.erase(remove_if(values.begin(), values.end(), [](double x) { return std::isnan(x); }), values.end());
+  if (values.empty())
+  {
+    lower = upper = numeric_limits<double>::quiet_NaN();
+    return;
+  }
+  sort(values.begin(), values.end());
+  // Linear interpolation between order statistics:
+  auto quantile = [&values](double p) {
+        double h = p * static_cast<double>(values.size() - 1);
+        size_t i = static_cast<size_t>(floor(h));
+        if (i + 1 >= values.size())
+          return values.back();
+        return values[i] + (h - static_cast<double>(i)) * (values[i + 1] - values[i]);
+      };
+  double alpha = (1. - level) / 2.;
+  lower = quantile(alpha);
+  upper = quantile(1. - alpha);
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _POISSONBOOTSTRAP_H_
+#define _POISSONBOOTSTRAP_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace bpp
+{
+/**
+ * @brief Single-pass Poisson bootstrap of additive statistics.
+ *
+ * Each resampling unit (typically a block, or a genomic window obtained with WindowSplitMafIterator)
+ * receives, for each replicate, an independent weight drawn from a Poisson distribution of mean 1.
+ * This approximates the multinomial weights of the classical bootstrap, but does not require to know
+ * the number of units in advance, so that all replicates can be accumulated while streaming the data once.
+ *
+ * Weights are generated by a counter-based random number generator: the weight of a unit in a replicate
+ * only depends on the seed, the index of the unit and the index of the replicate. As units are indexed
+ * in the order they are added, results are reproducible for a given seed and input order,
+ * but processing the same units in another order gives different replicates.
+ *
+ * For each statistic, the weighted sum of the values and the weighted number of units with a value are accumulated,
+ * so that both the total and the mean per unit can be bootstrapped. Missing values (NaN) are ignored.
+ */
+class PoissonBootstrap
+{
+private:
+  size_t nbReplicates_;
+  size_t nbStatistics_;
+  uint64_t seed_;
+  uint64_t nbUnits_;
+  std::vector<double> observedSums_;
+  std::vector<double> observedCounts_;
+  std::vector<double> sums_; // nbStatistics_ values per replicate.
+  std::vector<double> counts_;
+  std::vector<unsigned int> weights_;
+
+public:
+  /**
+   * @param nbReplicates The number of bootstrap replicates.
+   * @param nbStatistics The number of statistics to accumulate.
+   * @param seed The seed of the random number generator.
+   */
+  PoissonBootstrap(size_t nbReplicates, size_t nbStatistics, uint64_t seed = 0);
+
+  virtual ~PoissonBootstrap() {}
+
+public:
+  size_t getNumberOfReplicates() const { return nbReplicates_; }
+
+  size_t getNumberOfStatistics() const { return nbStatistics_; }
+
+  /**
+   * @return The number of units added so far.
+   */
+  uint64_t getNumberOfUnits() const { return nbUnits_; }
+
+  /**
+   * @brief Compute the weights of a unit in all replicates.
+   *
+   * @param unit The index of the unit.
+   * @param weights The vector where to store the weights, one per replicate.
+   */
+  void getWeights(uint64_t unit, std::vector<unsigned int>& weights) const;
+
+  /**
+   * @brief Add the values of the next unit. Units are numbered in the order they are added.
+   *
+   * @param values The values of all statistics for this unit, NaN for missing values.
+   */
+  void add(const std::vector<double>& values);
+
+  double getObservedSum(size_t statistic) const { return observedSums_[statistic]; }
+
+  double getObservedMean(size_t statistic) const;
+
+  /**
+   * @return The number of units with a value for a statistic.
+   */
+  uint64_t getObservedCount(size_t statistic) const { return static_cast<uint64_t>(observedCounts_[statistic]); }
+
+  /**
+   * @param statistic The index of the statistic.
+   * @param values The vector where to store the sum of the statistic in each replicate.
+   */
+  void getReplicateSums(size_t statistic, std::vector<double>& values) const;
+
+  /**
+   * @param statistic The index of the statistic.
+   * @param values The vector where to store the mean of the statistic in each replicate (NaN if no value was sampled).
+   */
+  void getReplicateMeans(size_t statistic, std::vector<double>& values) const;
+
+  /**
+   * @brief Compute a percentile confidence interval.
+   *
+   * @param values The replicate values. NaN values are ignored.
+   * @param level The confidence level, for instance 0.95.
+   * @param lower, upper The bounds of the interval, NaN if there is no value.
+   */
+  static void getPercentileInterval(std::vector<double> values, double level, double& lower, double& upper);
+
+  /**
+   * @return A Poisson(1) random variable obtained by inversion of a 64 bits random number.
+   */
+  static unsigned int poisson1(uint64_t random);
+
+  /**
+   * @return A well-mixed 64 bits value (finalizer of the SplitMix64 generator).
+   */
+  static uint64_t mix(uint64_t x)
+  {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+  }
+};
+} // end of namespace bpp.
+
+#endif // _POISSONBOOTSTRAP_H_
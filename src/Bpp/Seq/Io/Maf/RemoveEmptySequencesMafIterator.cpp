@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "RemoveEmptySequencesMafIterator.h"
+#include "DnaTraits.h"
 
 using namespace bpp;
 using namespace std;
@@ -20,7 +21,7 @@ unique_ptr<MafBlock> RemoveEmptySequencesMafIterator::analyseCurrentBlock_()
       {
         for (size_t j = 0; isEmpty && j < currentBlock_->getNumberOfSites(); ++j)
         {
-          if (!AlphabetTools::DNA_ALPHABET->isUnresolved(seq[j]) && !AlphabetTools::DNA_ALPHABET->isGap(seq[j]))
+          if (DnaTraits::isResolved(seq[j]))
             isEmpty = false;
         }
       }
@@ -28,7 +29,7 @@ unique_ptr<MafBlock> RemoveEmptySequencesMafIterator::analyseCurrentBlock_()
       {
         for (size_t j = 0; isEmpty && j < currentBlock_->getNumberOfSites(); ++j)
         {
-          if (!AlphabetTools::DNA_ALPHABET->isGap(seq[j]))
+          if (!DnaTraits::isGap(seq[j]))
             isEmpty = false;
         }
       }
@@ -0,0 +1,487 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ScoreTrack.h"
+#include "../BinaryIoTools.h"
+
+#include <Bpp/Text/TextTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace
+{
+const size_t RAW_RECORD_SIZE = 12;
+const size_t ZOOM_RECORD_SIZE = 28;
+const size_t INDEX_RECORD_SIZE = 24;
+const uint32_t FORMAT_VERSION = 1;
+
+/**
+ * @brief Sequential reading of a buffer, with bound checking.
+ */
+class Cursor
+{
+private:
+  const string& bytes_;
+  size_t pos_;
+
+public:
+  Cursor(const string& bytes) : bytes_(bytes), pos_(0) {}
+
+public:
+  const char* next(size_t nbBytes)
+  {
+    if (pos_ + nbBytes > bytes_.size())
+      throw Exception("ScoreTrackReader. Truncated index.");
+    const char* p = bytes_.data() + pos_;
+    pos_ += nbBytes;
+    return p;
+  }
+
+  uint32_t nextUInt32() { return BinaryIoTools::getUInt32(next(4)); }
+
+  uint64_t nextUInt64() { return BinaryIoTools::getInteger(next(8), 8); }
+};
+}
+
+/******************************************************************************/
+
+ScoreTrackWriter::ScoreTrackWriter(
+    shared_ptr<ostream> out,
+    const vector<uint32_t>& zoomBinSizes,
+    size_t recordsPerChunk) :
+  output_(out),
+  recordsPerChunk_(recordsPerChunk),
+  chromosomes_(),
+  chromosomeSizes_(),
+  chunk_(),
+  dataIndex_(),
+  zoomLevels_(),
+  run_(),
+  hasRun_(false),
+  offset_(0),
+  isClosed_(false)
+{
+  if (!output_)
+    throw Exception("ScoreTrackWriter. Null output stream.");
+  if (recordsPerChunk_ == 0)
+    throw Exception("ScoreTrackWriter. Chunks must contain at least one record.");
+  for (size_t i = 0; i < zoomBinSizes.size(); ++i)
+  {
+    if (zoomBinSizes[i] < 2)
+      throw Exception("ScoreTrackWriter. Zoom bins must have a size of at least 2.");
+    if (i > 0 && zoomBinSizes[i] <= zoomBinSizes[i - 1])
+      throw Exception("ScoreTrackWriter. Zoom bin sizes must be given in increasing order.");
+    zoomLevels_.push_back(ZoomLevel_(zoomBinSizes[i]));
+  }
+  chunk_.reserve(recordsPerChunk_);
+  string header = "BPPSCORE";
+  BinaryIoTools::putInteger(header, FORMAT_VERSION, 4);
+  write_(header);
+}
+
+void ScoreTrackWriter::write_(const string& bytes)
+{
+  output_->write(bytes.data(), static_cast<streamsize>(bytes.size()));
+  offset_ += bytes.size();
+}
+
+uint32_t ScoreTrackWriter::getChromosomeId_(const string& chr)
+{
+  if (!chromosomes_.empty() && chromosomes_.back() == chr)
+    return static_cast<uint32_t>(chromosomes_.size() - 1);
+  if (find(chromosomes_.begin(), chromosomes_.end(), chr) != chromosomes_.end())
+    throw Exception("ScoreTrackWriter::addScore. Scores are not sorted by chromosome: " + chr + " was met again.");
+  // Close the previous chromosome:
+  flushRun_();
+  flushChunk_();
+  if (!chromosomes_.empty())
+  {
+    for (auto& level : zoomLevels_)
+    {
+      flushZoomBin_(level, static_cast<uint32_t>(chromosomes_.size() - 1));
+    }
+  }
+  if (chromosomes_.size() >= numeric_limits<uint32_t>::max())
+    throw Exception("ScoreTrackWriter::addScore. Too many chromosomes.");
+  chromosomes_.push_back(chr);
+  chromosomeSizes_.push_back(0);
+  return static_cast<uint32_t>(chromosomes_.size() - 1);
+}
+
+void ScoreTrackWriter::addScore(const string& chr, size_t position, double value)
+{
+  if (isClosed_)
+    throw Exception("ScoreTrackWriter::addScore. The writer is closed.");
+  if (std::isnan(value))
+    return;
+  if (position >= numeric_limits<uint32_t>::max())
+    throw Exception("ScoreTrackWriter::addScore. Position is too large: " + TextTools::toString(position) + ".");
+  uint32_t chrId = getChromosomeId_(chr);
+  if (position < chromosomeSizes_[chrId])
+    throw Exception("ScoreTrackWriter::addScore. Scores are not sorted by position: " + chr + ":" + TextTools::toString(position) + ".");
+  chromosomeSizes_[chrId] = position + 1;
+  uint32_t pos = static_cast<uint32_t>(position);
+  // Values are rounded once, so that raw data and summaries are consistent:
+  float v = static_cast<float>(value);
+
+  if (hasRun_ && run_.end == pos && run_.value == v)
+  {
+    run_.end++;
+  }
+  else
+  {
+    flushRun_();
+    run_.start = pos;
+    run_.end = pos + 1;
+    run_.value = v;
+    hasRun_ = true;
+  }
+
+  for (auto& level : zoomLevels_)
+  {
+    uint32_t bin = pos / level.binSize;
+    if (bin != level.currentBin)
+      flushZoomBin_(level, chrId);
+    level.currentBin = bin;
+    level.currentSummary.add(v);
+    level.currentEnd = pos + 1;
+  }
+}
+
+void ScoreTrackWriter::flushRun_()
+{
+  if (!hasRun_)
+    return;
+  chunk_.push_back(run_);
+  hasRun_ = false;
+  if (chunk_.size() >= recordsPerChunk_)
+    flushChunk_();
+}
+
+void ScoreTrackWriter::flushChunk_()
+{
+  if (chunk_.empty())
+    return;
+  ChunkIndex_ index;
+  index.chrId = static_cast<uint32_t>(chromosomes_.size() - 1);
+  index.start = chunk_.front().start;
+  index.end = chunk_.back().end;
+  index.offset = offset_;
+  index.nbRecords = static_cast<uint32_t>(chunk_.size());
+  dataIndex_.push_back(index);
+
+  string bytes;
+  bytes.reserve(chunk_.size() * RAW_RECORD_SIZE);
+  for (const auto& record : chunk_)
+  {
+    BinaryIoTools::putInteger(bytes, record.start, 4);
+    BinaryIoTools::putInteger(bytes, record.end, 4);
+    BinaryIoTools::putFloat(bytes, record.value);
+  }
+  write_(bytes);
+  chunk_.clear();
+}
+
+void ScoreTrackWriter::flushZoomBin_(ZoomLevel_& level, uint32_t chrId)
+{
+  if (level.currentSummary.coverage == 0)
+    return;
+  ZoomRecord_ record;
+  record.chrId = chrId;
+  uint64_t start = static_cast<uint64_t>(level.currentBin) * level.binSize;
+  uint64_t end = min(start + level.binSize, static_cast<uint64_t>(numeric_limits<uint32_t>::max()));
+  record.start = static_cast<uint32_t>(start);
+  record.end = static_cast<uint32_t>(end);
+  record.summary = level.currentSummary;
+  level.records.push_back(record);
+  level.currentSummary = ScoreTrackSummary();
+}
+
+void ScoreTrackWriter::close()
+{
+  if (isClosed_)
+    return;
+  flushRun_();
+  flushChunk_();
+  if (!chromosomes_.empty())
+  {
+    for (auto& level : zoomLevels_)
+    {
+      flushZoomBin_(level, static_cast<uint32_t>(chromosomes_.size() - 1));
+    }
+  }
+
+  // Zoom chunks:
+  vector< vector<ChunkIndex_> > zoomIndex(zoomLevels_.size());
+  for (size_t l = 0; l < zoomLevels_.size(); ++l)
+  {
+    const vector<ZoomRecord_>& records = zoomLevels_[l].records;
+    size_t i = 0;
+    while (i < records.size())
+    {
+      // A chunk never spans several chromosomes:
+      size_t j = i;
+      while (j < records.size() && j - i < recordsPerChunk_ && records[j].chrId == records[i].chrId)
+      {
+        ++j;
+      }
+      ChunkIndex_ index;
+      index.chrId = records[i].chrId;
+      index.start = records[i].start;
+      index.end = records[j - 1].end;
+      index.offset = offset_;
+      index.nbRecords = static_cast<uint32_t>(j - i);
+      zoomIndex[l].push_back(index);
+
+      string bytes;
+      bytes.reserve((j - i) * ZOOM_RECORD_SIZE);
+      for (size_t k = i; k < j; ++k)
+      {
+        const ScoreTrackSummary& s = records[k].summary;
+        BinaryIoTools::putInteger(bytes, records[k].start, 4);
+        BinaryIoTools::putInteger(bytes, records[k].end, 4);
+        BinaryIoTools::putInteger(bytes, s.coverage, 4);
+        BinaryIoTools::putFloat(bytes, static_cast<float>(s.min));
+        BinaryIoTools::putFloat(bytes, static_cast<float>(s.max));
+        BinaryIoTools::putDouble(bytes, s.sum);
+      }
+      write_(bytes);
+      i = j;
+    }
+    zoomLevels_[l].records.clear();
+    zoomLevels_[l].records.shrink_to_fit();
+  }
+
+  // Index:
+  uint64_t indexOffset = offset_;
+  string bytes;
+  BinaryIoTools::putInteger(bytes, chromosomes_.size(), 4);
+  for (size_t i = 0; i < chromosomes_.size(); ++i)
+  {
+    BinaryIoTools::putInteger(bytes, chromosomes_[i].size(), 4);
+    bytes += chromosomes_[i];
+    BinaryIoTools::putInteger(bytes, chromosomeSizes_[i], 8);
+  }
+  BinaryIoTools::putInteger(bytes, zoomLevels_.size() + 1, 4);
+  auto putLevel = [&bytes](uint32_t binSize, const vector<ChunkIndex_>& chunks) {
+        BinaryIoTools::putInteger(bytes, binSize, 4);
+        BinaryIoTools::putInteger(bytes, chunks.size(), 8);
+        for (const auto& chunk : chunks)
+        {
+          BinaryIoTools::putInteger(bytes, chunk.chrId, 4);
+          BinaryIoTools::putInteger(bytes, chunk.start, 4);
+          BinaryIoTools::putInteger(bytes, chunk.end, 4);
+          BinaryIoTools::putInteger(bytes, chunk.offset, 8);
+          BinaryIoTools::putInteger(bytes, chunk.nbRecords, 4);
+        }
+      };
+  putLevel(0, dataIndex_);
+  for (size_t l = 0; l < zoomLevels_.size(); ++l)
+  {
+    putLevel(zoomLevels_[l].binSize, zoomIndex[l]);
+  }
+  // Trailer:
+  BinaryIoTools::putInteger(bytes, indexOffset, 8);
+  bytes += "BPPSCEND";
+  write_(bytes);
+  output_->flush();
+  isClosed_ = true;
+}
+
+/******************************************************************************/
+
+ScoreTrackReader::ScoreTrackReader(const string& path) :
+  input_(path.c_str(), ios::in | ios::binary),
+  chromosomes_(),
+  chromosomeSizes_(),
+  chromosomeIds_(),
+  levels_(),
+  buffer_()
+{
+  if (!input_)
+    throw Exception("ScoreTrackReader. Unable to open file " + path + ".");
+  char header[12];
+  input_.read(header, 12);
+  if (input_.gcount() != 12 || string(header, 8) != "BPPSCORE")
+    throw Exception("ScoreTrackReader. Not a score track file: " + path + ".");
+  if (BinaryIoTools::getUInt32(header + 8) != FORMAT_VERSION)
+    throw Exception("ScoreTrackReader. Unsupported format version in " + path + ".");
+
+  input_.seekg(0, ios::end);
+  streamoff fileSize = input_.tellg();
+  if (fileSize < 28)
+    throw Exception("ScoreTrackReader. Truncated file: " + path + ".");
+  char trailer[16];
+  input_.seekg(fileSize - 16);
+  input_.read(trailer, 16);
+  if (input_.gcount() != 16 || string(trailer + 8, 8) != "BPPSCEND")
+    throw Exception("ScoreTrackReader. Truncated file: " + path + ".");
+  uint64_t indexOffset = BinaryIoTools::getInteger(trailer, 8);
+  if (indexOffset < 12 || indexOffset > static_cast<uint64_t>(fileSize - 16))
+    throw Exception("ScoreTrackReader. Corrupted file: " + path + ".");
+
+  // Load the index:
+  string index(static_cast<size_t>(static_cast<uint64_t>(fileSize - 16) - indexOffset), '\0');
+  input_.seekg(static_cast<streamoff>(indexOffset));
+  input_.read(&index[0], static_cast<streamsize>(index.size()));
+  Cursor cursor(index);
+  uint32_t nbChromosomes = cursor.nextUInt32();
+  for (uint32_t i = 0; i < nbChromosomes; ++i)
+  {
+    uint32_t len = cursor.nextUInt32();
+    string name(cursor.next(len), len);
+    chromosomeIds_[name] = i;
+    chromosomes_.push_back(name);
+    chromosomeSizes_.push_back(cursor.nextUInt64());
+  }
+  uint32_t nbLevels = cursor.nextUInt32();
+  if (nbLevels == 0)
+    throw Exception("ScoreTrackReader. Corrupted file: " + path + ".");
+  levels_.resize(nbLevels);
+  for (auto& level : levels_)
+  {
+    level.binSize = cursor.nextUInt32();
+    uint64_t nbChunks = cursor.nextUInt64();
+    const char* p = cursor.next(static_cast<size_t>(nbChunks) * INDEX_RECORD_SIZE);
+    level.chunks.resize(static_cast<size_t>(nbChunks));
+    for (auto& chunk : level.chunks)
+    {
+      chunk.chrId = BinaryIoTools::getUInt32(p);
+      chunk.start = BinaryIoTools::getUInt32(p + 4);
+      chunk.end = BinaryIoTools::getUInt32(p + 8);
+      chunk.offset = BinaryIoTools::getInteger(p + 12, 8);
+      chunk.nbRecords = BinaryIoTools::getUInt32(p + 20);
+      p += INDEX_RECORD_SIZE;
+    }
+  }
+}
+
+vector<uint32_t> ScoreTrackReader::getZoomBinSizes() const
+{
+  vector<uint32_t> sizes;
+  for (size_t l = 1; l < levels_.size(); ++l)
+  {
+    sizes.push_back(levels_[l].binSize);
+  }
+  return sizes;
+}
+
+pair<size_t, size_t> ScoreTrackReader::findChunks_(const Level_& level, uint32_t chrId, uint64_t start, uint64_t end) const
+{
+  // Chunks are sorted by chromosome and do not overlap, so that their ends are sorted too:
+  auto first = lower_bound(level.chunks.begin(), level.chunks.end(), make_pair(chrId, start),
+      [](const ChunkIndex_& chunk, const pair<uint32_t, uint64_t>& p) {
+        return chunk.chrId < p.first || (chunk.chrId == p.first && chunk.end <= p.second);
+      });
+  auto last = first;
+  while (last != level.chunks.end() && last->chrId == chrId && last->start < end)
+  {
+    ++last;
+  }
+  return make_pair(static_cast<size_t>(first - level.chunks.begin()), static_cast<size_t>(last - level.chunks.begin()));
+}
+
+void ScoreTrackReader::readChunk_(const ChunkIndex_& chunk, size_t recordSize)
+{
+  buffer_.resize(static_cast<size_t>(chunk.nbRecords) * recordSize);
+  input_.clear();
+  input_.seekg(static_cast<streamoff>(chunk.offset));
+  input_.read(&buffer_[0], static_cast<streamsize>(buffer_.size()));
+  if (static_cast<size_t>(input_.gcount()) != buffer_.size())
+    throw Exception("ScoreTrackReader::readChunk_. Truncated data chunk.");
+}
+
+void ScoreTrackReader::getRecords(const string& chr, uint64_t start, uint64_t end, vector<ScoreTrackRecord>& records)
+{
+  uint32_t chrId = getChromosomeId_(chr);
+  const Level_& level = levels_[0];
+  auto range = findChunks_(level, chrId, start, end);
+  for (size_t c = range.first; c < range.second; ++c)
+  {
+    readChunk_(level.chunks[c], RAW_RECORD_SIZE);
+    const char* p = buffer_.data();
+    for (uint32_t i = 0; i < level.chunks[c].nbRecords; ++i, p += RAW_RECORD_SIZE)
+    {
+      ScoreTrackRecord record;
+      record.start = BinaryIoTools::getUInt32(p);
+      record.end = BinaryIoTools::getUInt32(p + 4);
+      record.value = BinaryIoTools::getFloat(p + 8);
+      if (record.end <= start || record.start >= end)
+        continue;
+      record.start = static_cast<uint32_t>(max(static_cast<uint64_t>(record.start), start));
+      record.end = static_cast<uint32_t>(min(static_cast<uint64_t>(record.end), end));
+      records.push_back(record);
+    }
+  }
+}
+
+ScoreTrackSummary ScoreTrackReader::getSummary(const string& chr, uint64_t start, uint64_t end)
+{
+  uint32_t chrId = getChromosomeId_(chr);
+  ScoreTrackSummary summary;
+  if (start < end)
+    summarize_(levels_.size() - 1, chrId, start, end, summary);
+  return summary;
+}
+
+void ScoreTrackReader::summarize_(size_t level, uint32_t chrId, uint64_t start, uint64_t end, ScoreTrackSummary& summary)
+{
+  const Level_& lev = levels_[level];
+  if (level == 0)
+  {
+    auto range = findChunks_(lev, chrId, start, end);
+    for (size_t c = range.first; c < range.second; ++c)
+    {
+      readChunk_(lev.chunks[c], RAW_RECORD_SIZE);
+      const char* p = buffer_.data();
+      for (uint32_t i = 0; i < lev.chunks[c].nbRecords; ++i, p += RAW_RECORD_SIZE)
+      {
+        uint64_t a = max(static_cast<uint64_t>(BinaryIoTools::getUInt32(p)), start);
+        uint64_t b = min(static_cast<uint64_t>(BinaryIoTools::getUInt32(p + 4)), end);
+        if (a < b)
+          summary.add(static_cast<double>(BinaryIoTools::getFloat(p + 8)), b - a);
+      }
+    }
+    return;
+  }
+
+  // Bins fully included in the region:
+  uint64_t binSize = lev.binSize;
+  uint64_t fullStart = (start + binSize - 1) / binSize * binSize;
+  uint64_t fullEnd = end / binSize * binSize;
+  if (fullStart >= fullEnd)
+  {
+    summarize_(level - 1, chrId, start, end, summary);
+    return;
+  }
+  auto range = findChunks_(lev, chrId, fullStart, fullEnd);
+  for (size_t c = range.first; c < range.second; ++c)
+  {
+    readChunk_(lev.chunks[c], ZOOM_RECORD_SIZE);
+    const char* p = buffer_.data();
+    for (uint32_t i = 0; i < lev.chunks[c].nbRecords; ++i, p += ZOOM_RECORD_SIZE)
+    {
+      uint64_t binStart = BinaryIoTools::getUInt32(p);
+      if (binStart < fullStart || binStart >= fullEnd)
+        continue;
+      ScoreTrackSummary s;
+      s.coverage = BinaryIoTools::getUInt32(p + 8);
+      s.min = static_cast<double>(BinaryIoTools::getFloat(p + 12));
+      s.max = static_cast<double>(BinaryIoTools::getFloat(p + 16));
+      s.sum = BinaryIoTools::getDouble(p + 20);
+      summary.add(s);
+    }
+  }
+  // Remaining parts, with finer levels:
+  if (start < fullStart)
+    summarize_(level - 1, chrId, start, fullStart, summary);
+  if (fullEnd < end)
+    summarize_(level - 1, chrId, fullEnd, end, summary);
+}
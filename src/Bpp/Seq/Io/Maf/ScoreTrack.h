@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _SCORETRACK_H_
+#define _SCORETRACK_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <limits>
+
+namespace bpp
+{
+/**
+ * @brief Summary of scores over a genomic region.
+ */
+struct ScoreTrackSummary
+{
+  uint64_t coverage; ///< Number of positions with a score.
+  double min;
+  double max;
+  double sum;
+
+  ScoreTrackSummary() :
+    coverage(0),
+    min(std::numeric_limits<double>::infinity()),
+    max(-std::numeric_limits<double>::infinity()),
+    sum(0)
+  {}
+
+  void add(double value, uint64_t nbPositions = 1)
+  {
+    coverage += nbPositions;
+    if (value < min) min = value;
+    if (value > max) max = value;
+    sum += value * static_cast<double>(nbPositions);
+  }
+
+  void add(const ScoreTrackSummary& summary)
+  {
+    coverage += summary.coverage;
+    if (summary.min < min) min = summary.min;
+    if (summary.max > max) max = summary.max;
+    sum += summary.sum;
+  }
+
+  double getMean() const
+  {
+    return coverage > 0 ? sum / static_cast<double>(coverage) : std::numeric_limits<double>::quiet_NaN();
+  }
+};
+
+/**
+ * @brief A run of consecutive positions with the same score.
+ *
+ * Coordinates are 0-based, and the end is excluded.
+ */
+struct ScoreTrackRecord
+{
+  uint32_t start;
+  uint32_t end;
+  float value;
+};
+
+/**
+ * @brief Write per-position scores in an indexed binary file.
+ *
+ * Scores must be provided in increasing order of positions within each chromosome,
+ * and all scores of a chromosome must be provided before the next chromosome starts.
+ * Consecutive positions with identical scores are stored as a single record.
+ *
+ * The file is made of:
+ * - a header, with the 8 characters "BPPSCORE" and the format version,
+ * - data chunks, each containing a fixed maximum number of records for a single chromosome,
+ * - zoom chunks, containing summaries (coverage, min, max, sum) of fixed-size bins,
+ *   one set of chunks per zoom level,
+ * - an index, with the list of chromosomes and, for each level, the list of chunks sorted by chromosome and position,
+ *   together with their coordinates and offset in the file,
+ * - a trailer, with the offset of the index and the 8 characters "BPPSCEND".
+ * All integers are unsigned and little-endian, scores are stored as IEEE floats,
+ * except the sums of zoom summaries which are stored as doubles.
+ *
+ * Zoom summaries are computed on the fly while scores are added, so that the file is written in a single pass
+ * and the output stream does not need to be seekable. Summaries are kept in memory until the file is closed,
+ * which requires one record per non-empty bin of each zoom level.
+ */
+class ScoreTrackWriter
+{
+private:
+  struct ZoomRecord_
+  {
+    uint32_t chrId;
+    uint32_t start;
+    uint32_t end;
+    ScoreTrackSummary summary;
+
+    ZoomRecord_() : chrId(0), start(0), end(0), summary() {}
+  };
+
+  struct ChunkIndex_
+  {
+    uint32_t chrId;
+    uint32_t start;
+    uint32_t end;
+    uint64_t offset;
+    uint32_t nbRecords;
+  };
+
+  struct ZoomLevel_
+  {
+    uint32_t binSize;
+    uint32_t currentBin;
+    ScoreTrackSummary currentSummary;
+    uint32_t currentEnd;
+    std::vector<ZoomRecord_> records;
+
+    ZoomLevel_(uint32_t size) : binSize(size), currentBin(0), currentSummary(), currentEnd(0), records() {}
+  };
+
+private:
+  std::shared_ptr<std::ostream> output_;
+  size_t recordsPerChunk_;
+  std::vector<std::string> chromosomes_;
+  std::vector<uint64_t> chromosomeSizes_;
+  std::vector<ScoreTrackRecord> chunk_;
+  std::vector<ChunkIndex_> dataIndex_;
+  std::vector<ZoomLevel_> zoomLevels_;
+  ScoreTrackRecord run_;
+  bool hasRun_;
+  uint64_t offset_;
+  bool isClosed_;
+
+public:
+  /**
+   * @brief Build a new writer.
+   *
+   * @param out The output stream. The header is written immediately.
+   * @param zoomBinSizes The sizes of the bins of each zoom level, in increasing order.
+   * @param recordsPerChunk The maximum number of records in each chunk.
+   */
+  ScoreTrackWriter(
+      std::shared_ptr<std::ostream> out,
+      const std::vector<uint32_t>& zoomBinSizes = {1000, 10000, 100000, 1000000},
+      size_t recordsPerChunk = 4096);
+
+  virtual ~ScoreTrackWriter() {}
+
+private:
+  ScoreTrackWriter(const ScoreTrackWriter&) = delete;
+  ScoreTrackWriter& operator=(const ScoreTrackWriter&) = delete;
+
+public:
+  /**
+   * @brief Add a score for one position.
+   *
+   * NaN scores are ignored, as positions without score.
+   *
+   * @param chr The chromosome.
+   * @param position The position, 0-based.
+   * @param value The score.
+   */
+  void addScore(const std::string& chr, size_t position, double value);
+
+  /**
+   * @brief Write the zoom levels, the index and the trailer.
+   *
+   * No score can be added afterwards.
+   */
+  void close();
+
+  bool isClosed() const { return isClosed_; }
+
+private:
+  uint32_t getChromosomeId_(const std::string& chr);
+
+  void flushRun_();
+
+  void flushChunk_();
+
+  void flushZoomBin_(ZoomLevel_& level, uint32_t chrId);
+
+  void write_(const std::string& bytes);
+};
+
+
+/**
+ * @brief Read an indexed binary score file written by ScoreTrackWriter.
+ *
+ * Only the index is loaded in memory. Queries read the chunks overlapping the requested region.
+ * Region summaries use the coarsest zoom bins fully included in the region, and finer levels or raw data
+ * for the remaining parts at both ends, so that the result is exact while reading a number of records
+ * which is roughly independent of the size of the region.
+ */
+class ScoreTrackReader
+{
+private:
+  struct ChunkIndex_
+  {
+    uint32_t chrId;
+    uint32_t start;
+    uint32_t end;
+    uint64_t offset;
+    uint32_t nbRecords;
+  };
+
+  struct Level_
+  {
+    uint32_t binSize; // 0 for raw data.
+    std::vector<ChunkIndex_> chunks;
+
+    Level_() : binSize(0), chunks() {}
+  };
+
+private:
+  std::ifstream input_;
+  std::vector<std::string> chromosomes_;
+  std::vector<uint64_t> chromosomeSizes_;
+  std::map<std::string, uint32_t> chromosomeIds_;
+  std::vector<Level_> levels_;
+  std::string buffer_;
+
+public:
+  /**
+   * @param path The path of the file to read.
+   */
+  ScoreTrackReader(const std::string& path);
+
+  virtual ~ScoreTrackReader() {}
+
+private:
+  ScoreTrackReader(const ScoreTrackReader&) = delete;
+  ScoreTrackReader& operator=(const ScoreTrackReader&) = delete;
+
+public:
+  const std::vector<std::string>& getChromosomes() const { return chromosomes_; }
+
+  /**
+   * @return The position following the last position with a score on a chromosome.
+   */
+  uint64_t getChromosomeSize(const std::string& chr) const
+  {
+    return chromosomeSizes_[getChromosomeId_(chr)];
+  }
+
+  /**
+   * @return The bin sizes of the zoom levels.
+   */
+  std::vector<uint32_t> getZoomBinSizes() const;
+
+  /**
+   * @brief Get the records overlapping a region.
+   *
+   * Records are clipped to the region.
+   *
+   * @param chr The chromosome.
+   * @param start The start of the region, 0-based.
+   * @param end The end of the region, excluded.
+   * @param records A vector where to append the records.
+   */
+  void getRecords(const std::string& chr, uint64_t start, uint64_t end, std::vector<ScoreTrackRecord>& records);
+
+  /**
+   * @brief Get the summary of scores over a region.
+   *
+   * @param chr The chromosome.
+   * @param start The start of the region, 0-based.
+   * @param end The end of the region, excluded.
+   * @return The summary of all scores in the region.
+   */
+  ScoreTrackSummary getSummary(const std::string& chr, uint64_t start, uint64_t end);
+
+private:
+  uint32_t getChromosomeId_(const std::string& chr) const
+  {
+    auto it = chromosomeIds_.find(chr);
+    if (it == chromosomeIds_.end())
+      throw Exception("ScoreTrackReader. Unknown chromosome: " + chr + ".");
+    return it->second;
+  }
+
+  void summarize_(size_t level, uint32_t chrId, uint64_t start, uint64_t end, ScoreTrackSummary& summary);
+
+  /**
+   * @brief Read a chunk in buffer_.
+   */
+  void readChunk_(const ChunkIndex_& chunk, size_t recordSize);
+
+  /**
+   * @return The range of chunks of a level which may overlap a region.
+   */
+  std::pair<size_t, size_t> findChunks_(const Level_& level, uint32_t chrId, uint64_t start, uint64_t end) const;
+};
+} // end of namespace bpp.
+
+#endif // _SCORETRACK_H_
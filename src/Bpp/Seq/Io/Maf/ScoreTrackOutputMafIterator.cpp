@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "ScoreTrackOutputMafIterator.h"
+#include "DnaTraits.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <cmath>
+
+using namespace std;
+
+double ScoreTrackOutputMafIterator::computeScore_(const vector<const MafSequence*>& sequences, size_t i) const
+{
+  // Counts are indexed by state + 1, gaps being 0:
+  unsigned int counts[17] = {0};
+  for (const MafSequence* seq : sequences)
+  {
+    int x = (*seq)[i];
+    counts[x < 15 ? x + 1 : 16]++;
+  }
+  double n = static_cast<double>(sequences.size());
+  switch (score_)
+  {
+  case SCORE_GAP_FRACTION:
+    return static_cast<double>(counts[0]) / n;
+  case SCORE_NB_ALLELES:
+  {
+    unsigned int nbAlleles = 0;
+    for (int s = DnaTraits::A; s <= DnaTraits::T; ++s)
+    {
+      if (counts[s + 1] > 0)
+        nbAlleles++;
+    }
+    return static_cast<double>(nbAlleles);
+  }
+  default:
+  {
+    double h = 0;
+    for (unsigned int c : counts)
+    {
+      if (c > 0)
+      {
+        double p = static_cast<double>(c) / n;
+        h -= p * log(p);
+      }
+    }
+    return h / log(5.);
+  }
+  }
+}
+
+void ScoreTrackOutputMafIterator::writeBlock_(const MafBlock& block)
+{
+  if (!block.hasSequenceForSpecies(refSpecies_))
+    return;
+  const MafSequence& refSeq = block.sequenceForSpecies(refSpecies_);
+  if (!refSeq.hasCoordinates())
+    throw Exception("ScoreTrackOutputMafIterator::writeBlock_. Reference sequence has no coordinates: " + refSeq.getDescription() + ".");
+
+  vector<const MafSequence*> sequences;
+  if (species_.empty())
+  {
+    for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+    {
+      sequences.push_back(&block.sequence(i));
+    }
+  }
+  else
+  {
+    for (const auto& sp : species_)
+    {
+      if (block.hasSequenceForSpecies(sp))
+        sequences.push_back(&block.sequenceForSpecies(sp));
+    }
+  }
+  if (sequences.empty())
+    return;
+
+  scores_.clear();
+  for (size_t j = 0; j < block.getNumberOfSites(); ++j)
+  {
+    if (!DnaTraits::isGap(refSeq[j]))
+      scores_.push_back(computeScore_(sequences, j));
+  }
+  // Scores are written in increasing order of positions on the positive strand:
+  const string& chr = refSeq.getChromosome();
+  size_t n = scores_.size();
+  if (refSeq.getStrand() == '-')
+  {
+    size_t first = refSeq.getSrcSize() - refSeq.stop();
+    for (size_t k = 0; k < n; ++k)
+    {
+      writer_->addScore(chr, first + k, scores_[n - 1 - k]);
+    }
+  }
+  else
+  {
+    for (size_t k = 0; k < n; ++k)
+    {
+      writer_->addScore(chr, refSeq.start() + k, scores_[k]);
+    }
+  }
+}
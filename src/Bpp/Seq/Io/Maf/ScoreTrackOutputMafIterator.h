@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _SCORETRACKOUTPUTMAFITERATOR_H_
+#define _SCORETRACKOUTPUTMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+#include "ScoreTrack.h"
+
+// From the STL:
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief This iterator computes a score for each alignment column and records it in a binary score track,
+ * at the corresponding position of the reference sequence.
+ *
+ * Columns with a gap in the reference sequence are ignored.
+ * Coordinates are given on the positive strand of the reference sequence,
+ * and the blocks must be sorted according to these coordinates (see ScoreTrackWriter).
+ * Blocks without the reference species are forwarded without output.
+ * The track is closed when the end of the input is reached.
+ *
+ * The following scores are available:
+ * - SCORE_ENTROPY: the Shannon entropy of the column, gaps and unresolved characters being considered as distinct states,
+ *   divided by log(5) as in EntropyFilterMafIterator,
+ * - SCORE_GAP_FRACTION: the proportion of gaps in the column,
+ * - SCORE_NB_ALLELES: the number of distinct nucleotides (A, C, G, T) in the column.
+ */
+class ScoreTrackOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+public:
+  static constexpr short SCORE_ENTROPY = 0;
+  static constexpr short SCORE_GAP_FRACTION = 1;
+  static constexpr short SCORE_NB_ALLELES = 2;
+
+private:
+  std::shared_ptr<ScoreTrackWriter> writer_;
+  std::string refSpecies_;
+  std::vector<std::string> species_;
+  short score_;
+  std::vector<double> scores_;
+
+public:
+  /**
+   * @brief Build a new ScoreTrackOutputMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param writer The track writer.
+   * @param reference The species to use as a reference for coordinates.
+   * @param species The species used to compute scores. In case one species is duplicated in a block,
+   * the first sequence will be used. If empty, all sequences in each block are used.
+   * @param score The score to compute.
+   */
+  ScoreTrackOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      std::shared_ptr<ScoreTrackWriter> writer,
+      const std::string& reference,
+      const std::vector<std::string>& species = std::vector<std::string>(),
+      short score = SCORE_ENTROPY) :
+    AbstractFilterMafIterator(iterator),
+    writer_(writer),
+    refSpecies_(reference),
+    species_(species),
+    score_(score),
+    scores_()
+  {
+    if (score_ < SCORE_ENTROPY || score_ > SCORE_NB_ALLELES)
+      throw Exception("ScoreTrackOutputMafIterator. Unknown score: " + TextTools::toString(score_) + ".");
+  }
+
+private:
+  ScoreTrackOutputMafIterator(const ScoreTrackOutputMafIterator& iterator) :
+    AbstractFilterMafIterator(0),
+    writer_(iterator.writer_),
+    refSpecies_(iterator.refSpecies_),
+    species_(iterator.species_),
+    score_(iterator.score_),
+    scores_()
+  {}
+
+  ScoreTrackOutputMafIterator& operator=(const ScoreTrackOutputMafIterator& iterator)
+  {
+    writer_     = iterator.writer_;
+    refSpecies_ = iterator.refSpecies_;
+    species_    = iterator.species_;
+    score_      = iterator.score_;
+    return *this;
+  }
+
+public:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_()
+  {
+    currentBlock_ = iterator_->nextBlock();
+    if (writer_)
+    {
+      if (currentBlock_)
+        writeBlock_(*currentBlock_);
+      else
+        writer_->close();
+    }
+    return std::move(currentBlock_);
+  }
+
+private:
+  void writeBlock_(const MafBlock& block);
+
+  double computeScore_(const std::vector<const MafSequence*>& sequences, size_t i) const;
+};
+} // end of namespace bpp.
+
+#endif // _SCORETRACKOUTPUTMAFITERATOR_H_
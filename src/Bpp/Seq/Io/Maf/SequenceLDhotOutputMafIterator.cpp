@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "SequenceLDhotOutputMafIterator.h"
+#include "DnaTraits.h"
 
 // From bpp-seq:
 #include <Bpp/Seq/Container/SequenceContainerTools.h>
@@ -66,7 +67,7 @@ void SequenceLDhotOutputMafIterator::writeBlock(std::ostream& out, const MafBloc
     int x = -1;
     for (size_t j = 0; j < s.size() && count < 2; ++j)
     {
-      if (!AlphabetTools::DNA_ALPHABET->isGap(s[j]) && !AlphabetTools::DNA_ALPHABET->isUnresolved(s[j]))
+      if (DnaTraits::isResolved(s[j]))
       {
         if (count == 0)
         {
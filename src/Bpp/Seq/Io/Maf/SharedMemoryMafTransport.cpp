@@ -0,0 +1,483 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "SharedMemoryMafTransport.h"
+#include "../BinaryIoTools.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+
+// From bpp-core:
+#include <Bpp/App/ApplicationTools.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_MAF_USE_SHM
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+const char MAGIC[8] = { 'B', 'P', 'P', 'M', 'A', 'F', 'S', 'M' };
+const uint32_t FORMAT_VERSION = 2;
+const uint32_t RECORD_BLOCK = 0;
+const uint32_t RECORD_PADDING = 1;
+const size_t RECORD_HEADER_SIZE = 8;
+
+const uint32_t SLOT_FREE = 0;
+const uint32_t SLOT_REGISTERING = 1;
+const uint32_t SLOT_ACTIVE = 2;
+
+/**
+ * @brief Consumer slot. The read position is the reference held by the consumer on the ring data.
+ */
+struct Slot
+{
+  std::atomic<uint32_t> state;
+  std::atomic<int64_t> pid;
+  std::atomic<uint64_t> readPos;
+};
+
+/**
+ * @brief Layout of the beginning of the segment. The ring data follows, at offset HEADER_SIZE.
+ * The segment is zero-filled when created, which is a valid initial state for all atomic members.
+ */
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t maxConsumers;
+  uint64_t capacity;
+  std::atomic<uint32_t> ready;
+  std::atomic<uint32_t> finished;
+  std::atomic<uint32_t> nbConsumers;
+  std::atomic<uint64_t> writePos;
+  Slot slots[SharedMemoryOutputMafIterator::MAX_CONSUMERS];
+};
+
+const size_t HEADER_SIZE = (sizeof(Header) + 63) / 64 * 64;
+
+Header* header(char* data) { return reinterpret_cast<Header*>(data); }
+
+void backoff() { this_thread::sleep_for(chrono::microseconds(50)); }
+
+/**
+ * @brief Helper for the waiting loops of the producer.
+ */
+class Waiter
+{
+private:
+  chrono::steady_clock::time_point start_;
+  chrono::steady_clock::time_point lastCheck_;
+  double timeout_;
+  string message_;
+
+public:
+  /**
+   * @param timeout The maximum waiting time in seconds, 0 for no limit.
+   * @param message The message of the exception thrown if the timeout is reached.
+   */
+  Waiter(double timeout, const string& message) :
+    start_(chrono::steady_clock::now()),
+    lastCheck_(start_),
+    timeout_(timeout),
+    message_(message)
+  {}
+
+public:
+  /**
+   * @brief Wait a little.
+   *
+   * @return true if consumers should be checked, which is done every 100 milliseconds.
+   */
+  bool wait()
+  {
+    backoff();
+    auto now = chrono::steady_clock::now();
+    if (timeout_ > 0 && chrono::duration<double>(now - start_).count() > timeout_)
+      throw Exception(message_);
+    if (now - lastCheck_ < chrono::milliseconds(100))
+      return false;
+    lastCheck_ = now;
+    return true;
+  }
+};
+}
+
+/******************************************************************************/
+
+SharedMemoryOutputMafIterator::SharedMemoryOutputMafIterator(
+    shared_ptr<MafIteratorInterface> iterator,
+    const string& name,
+    uint64_t capacity,
+    unsigned int expectedConsumers,
+    double timeout,
+    bool removeExisting) :
+  AbstractFilterMafIterator(iterator),
+  name_(name),
+  capacity_((capacity + 7) / 8 * 8),
+  expectedConsumers_(expectedConsumers),
+  timeout_(timeout),
+  data_(nullptr),
+  size_(0),
+  started_(false),
+  finished_(false),
+  buffer_()
+{
+#ifdef BPP_MAF_USE_SHM
+  if (capacity_ < 4096)
+    throw Exception("SharedMemoryOutputMafIterator. Capacity is too small: " + TextTools::toString(capacity) + ".");
+  if (capacity_ > numeric_limits<uint32_t>::max())
+    throw Exception("SharedMemoryOutputMafIterator. Capacity is too large: " + TextTools::toString(capacity) + ".");
+  if (expectedConsumers_ > MAX_CONSUMERS)
+    throw Exception("SharedMemoryOutputMafIterator. Too many consumers, maximum is " + TextTools::toString(MAX_CONSUMERS) + ".");
+  if (removeExisting)
+    shm_unlink(name_.c_str());
+  int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0 && errno == EEXIST)
+    throw Exception("SharedMemoryOutputMafIterator. Shared memory segment " + name_ + " already exists. It may be used by another producer, or have been left by an interrupted run, in which case it can be removed with removeExisting.");
+  if (fd < 0)
+    throw Exception("SharedMemoryOutputMafIterator. Unable to create shared memory segment " + name_ + ".");
+  size_ = HEADER_SIZE + static_cast<size_t>(capacity_);
+  void* p = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size_)) == 0)
+    p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+  {
+    shm_unlink(name_.c_str());
+    throw Exception("SharedMemoryOutputMafIterator. Unable to map shared memory segment " + name_ + ".");
+  }
+  data_ = static_cast<char*>(p);
+  Header* h = header(data_);
+  if (!h->writePos.is_lock_free() || !h->finished.is_lock_free() || !h->slots[0].pid.is_lock_free())
+  {
+    munmap(data_, size_);
+    shm_unlink(name_.c_str());
+    throw Exception("SharedMemoryOutputMafIterator. Atomic operations are not lock-free on this platform.");
+  }
+  memcpy(h->magic, MAGIC, 8);
+  h->version = FORMAT_VERSION;
+  h->maxConsumers = MAX_CONSUMERS;
+  h->capacity = capacity_;
+  h->ready.store(1, memory_order_release);
+#else
+  throw Exception("SharedMemoryOutputMafIterator. Shared memory is not supported on this platform.");
+#endif
+}
+
+SharedMemoryOutputMafIterator::~SharedMemoryOutputMafIterator()
+{
+#ifdef BPP_MAF_USE_SHM
+  if (data_)
+  {
+    finish();
+    munmap(data_, size_);
+    shm_unlink(name_.c_str());
+  }
+#endif
+}
+
+void SharedMemoryOutputMafIterator::finish()
+{
+  if (!finished_)
+  {
+    header(data_)->finished.store(1, memory_order_release);
+    finished_ = true;
+  }
+}
+
+unique_ptr<MafBlock> SharedMemoryOutputMafIterator::analyseCurrentBlock_()
+{
+  currentBlock_ = iterator_->nextBlock();
+  if (!currentBlock_)
+  {
+    finish();
+    return nullptr;
+  }
+  if (!started_)
+  {
+    if (verbose_ && expectedConsumers_ > 0)
+      ApplicationTools::displayMessage("SharedMemoryOutputMafIterator: waiting for " + TextTools::toString(expectedConsumers_) + " consumer(s).");
+    Waiter waiter(timeout_, "SharedMemoryOutputMafIterator::analyseCurrentBlock_. Timeout while waiting for consumers to register on segment " + name_ + ".");
+    while (header(data_)->nbConsumers.load(memory_order_acquire) < expectedConsumers_)
+    {
+      if (waiter.wait())
+        releaseDeadConsumers_();
+    }
+    started_ = true;
+  }
+  publish_(*currentBlock_);
+  return std::move(currentBlock_);
+}
+
+void SharedMemoryOutputMafIterator::publish_(const MafBlock& block)
+{
+  if (finished_)
+    throw Exception("SharedMemoryOutputMafIterator::publish_. Iterator was already finished.");
+
+  // Serialize the block:
+  buffer_.assign(RECORD_HEADER_SIZE, '\0');
+  BinaryIoTools::putDouble(buffer_, block.getScore());
+  BinaryIoTools::putInteger(buffer_, block.getPass(), 4);
+  BinaryIoTools::putInteger(buffer_, block.getNumberOfSequences(), 4);
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    const MafSequence& seq = block.sequence(i);
+    const string& name = seq.getName();
+    BinaryIoTools::putInteger(buffer_, name.size(), 4);
+    buffer_ += name;
+    bool hasCoordinates = seq.hasCoordinates();
+    buffer_.push_back(static_cast<char>(hasCoordinates ? 1 : 0));
+    buffer_.push_back(hasCoordinates ? seq.getStrand() : '?');
+    BinaryIoTools::putInteger(buffer_, hasCoordinates ? seq.start() : 0, 8);
+    BinaryIoTools::putInteger(buffer_, hasCoordinates ? seq.getSrcSize() : 0, 8);
+    const vector<int>& content = seq.getContent();
+    BinaryIoTools::putInteger(buffer_, content.size(), 8);
+    size_t offset = buffer_.size();
+    buffer_.resize(offset + content.size());
+    for (size_t j = 0; j < content.size(); ++j)
+    {
+      buffer_[offset + j] = static_cast<char>(content[j]);
+    }
+  }
+  buffer_.resize((buffer_.size() + 7) / 8 * 8, '\0');
+  uint64_t size = buffer_.size();
+  string recordHeader;
+  BinaryIoTools::putInteger(recordHeader, size, 4);
+  BinaryIoTools::putInteger(recordHeader, RECORD_BLOCK, 4);
+  memcpy(&buffer_[0], recordHeader.data(), RECORD_HEADER_SIZE);
+  if (size > capacity_)
+    throw Exception("SharedMemoryOutputMafIterator::publish_. Block is too large for the ring buffer: " + TextTools::toString(size) + " bytes.");
+
+  // Records do not wrap around the end of the ring, a padding record fills the remaining space if needed:
+  Header* h = header(data_);
+  char* ring = data_ + HEADER_SIZE;
+  uint64_t pos = h->writePos.load(memory_order_relaxed);
+  uint64_t tail = capacity_ - pos % capacity_;
+  uint64_t needed = (tail < size ? tail + size : size);
+
+  // Wait until all consumers have released the space we need:
+  Waiter waiter(timeout_, "SharedMemoryOutputMafIterator::publish_. Timeout while waiting for consumers to read segment " + name_ + ".");
+  while (true)
+  {
+    uint64_t minRead = pos;
+    for (unsigned int k = 0; k < MAX_CONSUMERS; ++k)
+    {
+      if (h->slots[k].state.load(memory_order_acquire) == SLOT_ACTIVE)
+        minRead = min(minRead, h->slots[k].readPos.load(memory_order_acquire));
+    }
+    if (pos + needed - minRead <= capacity_)
+      break;
+    if (waiter.wait())
+      releaseDeadConsumers_();
+  }
+
+  if (tail < size)
+  {
+    string padding;
+    BinaryIoTools::putInteger(padding, tail, 4);
+    BinaryIoTools::putInteger(padding, RECORD_PADDING, 4);
+    memcpy(ring + pos % capacity_, padding.data(), RECORD_HEADER_SIZE);
+    pos += tail;
+  }
+  memcpy(ring + pos % capacity_, buffer_.data(), static_cast<size_t>(size));
+  h->writePos.store(pos + size, memory_order_release);
+}
+
+void SharedMemoryOutputMafIterator::releaseDeadConsumers_()
+{
+#ifdef BPP_MAF_USE_SHM
+  Header* h = header(data_);
+  for (unsigned int k = 0; k < MAX_CONSUMERS; ++k)
+  {
+    Slot& slot = h->slots[k];
+    if (slot.state.load(memory_order_acquire) != SLOT_ACTIVE)
+      continue;
+    pid_t pid = static_cast<pid_t>(slot.pid.load(memory_order_acquire));
+    if (pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH)
+      continue;
+    // The consumer may unregister at the same time, only one of us releases the slot:
+    uint32_t expected = SLOT_ACTIVE;
+    if (slot.state.compare_exchange_strong(expected, SLOT_FREE))
+    {
+      h->nbConsumers.fetch_sub(1);
+      if (verbose_)
+        ApplicationTools::displayWarning("SharedMemoryOutputMafIterator: consumer process " + TextTools::toString(pid) + " is not running anymore, its slot was released.");
+    }
+  }
+#endif
+}
+
+/******************************************************************************/
+
+SharedMemoryMafIterator::SharedMemoryMafIterator(const string& name, double timeout) :
+  name_(name),
+  data_(nullptr),
+  size_(0),
+  slot_(0),
+  content_()
+{
+#ifdef BPP_MAF_USE_SHM
+  auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeout));
+  auto checkTimeout = [&]() {
+        if (chrono::steady_clock::now() > deadline)
+          throw Exception("SharedMemoryMafIterator. Timeout while waiting for shared memory segment " + name_ + ".");
+        backoff();
+      };
+
+  // Wait for the producer to create and initialize the segment:
+  int fd;
+  while ((fd = shm_open(name_.c_str(), O_RDWR, 0)) < 0)
+  {
+    checkTimeout();
+  }
+  struct stat st;
+  while (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE)
+  {
+    try
+    {
+      checkTimeout();
+    }
+    catch (...)
+    {
+      close(fd);
+      throw;
+    }
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    throw Exception("SharedMemoryMafIterator. Unable to map shared memory segment " + name_ + ".");
+  data_ = static_cast<char*>(p);
+  Header* h = header(data_);
+  try
+  {
+    while (h->ready.load(memory_order_acquire) == 0)
+    {
+      checkTimeout();
+    }
+    if (memcmp(h->magic, MAGIC, 8) != 0 || h->version != FORMAT_VERSION || HEADER_SIZE + h->capacity != size_)
+      throw Exception("SharedMemoryMafIterator. Segment " + name_ + " was not created by a compatible SharedMemoryOutputMafIterator.");
+
+    // Register:
+    bool registered = false;
+    for (unsigned int k = 0; !registered && k < h->maxConsumers && k < SharedMemoryOutputMafIterator::MAX_CONSUMERS; ++k)
+    {
+      uint32_t expected = SLOT_FREE;
+      if (h->slots[k].state.compare_exchange_strong(expected, SLOT_REGISTERING))
+      {
+        h->slots[k].readPos.store(h->writePos.load(memory_order_acquire), memory_order_release);
+        h->slots[k].pid.store(static_cast<int64_t>(getpid()), memory_order_release);
+        h->slots[k].state.store(SLOT_ACTIVE, memory_order_release);
+        h->nbConsumers.fetch_add(1);
+        slot_ = k;
+        registered = true;
+      }
+    }
+    if (!registered)
+      throw Exception("SharedMemoryMafIterator. Too many consumers for segment " + name_ + ".");
+  }
+  catch (...)
+  {
+    munmap(data_, size_);
+    throw;
+  }
+#else
+  throw Exception("SharedMemoryMafIterator. Shared memory is not supported on this platform.");
+#endif
+}
+
+SharedMemoryMafIterator::~SharedMemoryMafIterator()
+{
+#ifdef BPP_MAF_USE_SHM
+  if (data_)
+  {
+    // Release our reference, so that the producer does not wait for us anymore:
+    Header* h = header(data_);
+    uint32_t expected = SLOT_ACTIVE;
+    if (h->slots[slot_].state.compare_exchange_strong(expected, SLOT_FREE))
+      h->nbConsumers.fetch_sub(1);
+    munmap(data_, size_);
+  }
+#endif
+}
+
+unique_ptr<MafBlock> SharedMemoryMafIterator::analyseCurrentBlock_()
+{
+  Header* h = header(data_);
+  Slot& slot = h->slots[slot_];
+  const char* ring = data_ + HEADER_SIZE;
+  uint64_t capacity = h->capacity;
+  while (true)
+  {
+    if (slot.state.load(memory_order_acquire) != SLOT_ACTIVE)
+      throw Exception("SharedMemoryMafIterator::analyseCurrentBlock_. The slot of this consumer was released by the producer of segment " + name_ + ".");
+    uint64_t pos = slot.readPos.load(memory_order_relaxed);
+    if (pos == h->writePos.load(memory_order_acquire))
+    {
+      if (h->finished.load(memory_order_acquire) && pos == h->writePos.load(memory_order_acquire))
+        return nullptr;
+      backoff();
+      continue;
+    }
+    const char* record = ring + pos % capacity;
+    uint64_t size = BinaryIoTools::getUInt32(record);
+    uint32_t type = BinaryIoTools::getUInt32(record + 4);
+    if (type == RECORD_PADDING)
+    {
+      slot.readPos.store(pos + size, memory_order_release);
+      continue;
+    }
+
+    // Decode the block directly from the ring:
+    const char* q = record + RECORD_HEADER_SIZE;
+    auto block = make_unique<MafBlock>();
+    block->setScore(BinaryIoTools::getDouble(q));
+    block->setPass(BinaryIoTools::getUInt32(q + 8));
+    uint32_t nbSequences = BinaryIoTools::getUInt32(q + 12);
+    q += 16;
+    for (uint32_t i = 0; i < nbSequences; ++i)
+    {
+      uint32_t nameLength = BinaryIoTools::getUInt32(q);
+      string name(q + 4, nameLength);
+      q += 4 + nameLength;
+      bool hasCoordinates = q[0] != 0;
+      char strand = q[1];
+      size_t start = static_cast<size_t>(BinaryIoTools::getInteger(q + 2, 8));
+      size_t srcSize = static_cast<size_t>(BinaryIoTools::getInteger(q + 10, 8));
+      size_t nbSites = static_cast<size_t>(BinaryIoTools::getInteger(q + 18, 8));
+      q += 26;
+      content_.resize(nbSites);
+      for (size_t j = 0; j < nbSites; ++j)
+      {
+        content_[j] = static_cast<signed char>(q[j]);
+      }
+      q += nbSites;
+      bool parseName = name.find('.') != string::npos;
+      unique_ptr<MafSequence> seq;
+      if (hasCoordinates)
+        seq.reset(new MafSequence(name, "", start, strand, srcSize, parseName));
+      else
+        seq.reset(new MafSequence(name, "", parseName));
+      seq->setContent(content_);
+      block->addSequence(seq);
+    }
+    slot.readPos.store(pos + size, memory_order_release);
+    return block;
+  }
+}
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _SHAREDMEMORYMAFTRANSPORT_H_
+#define _SHAREDMEMORYMAFTRANSPORT_H_
+
+#include "AbstractMafIterator.h"
+
+// From the STL:
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief Pass blocks to other processes on the same node through a POSIX shared memory ring buffer.
+ *
+ * This iterator publishes each block it reads in a shared memory segment, in a packed binary layout,
+ * and returns the block unchanged so that it can be further processed locally.
+ * Other processes read the blocks with a SharedMemoryMafIterator opened with the same segment name,
+ * which avoids parsing the MAF text once per process.
+ *
+ * The segment holds a ring buffer of the given capacity. Each consumer registers in the segment and
+ * publishes the position of the last block it has read, which acts as a reference on all later data:
+ * space is only reused once all registered consumers have read the corresponding blocks,
+ * so that slow consumers make the producer wait (backpressure). A block larger than the capacity cannot be sent.
+ *
+ * The producer waits for the expected number of consumers to register before publishing the first block.
+ * Consumers registering later start with the next published block, and consumers destroyed before the end
+ * release their reference. Each consumer also records its process id: while waiting, the producer regularly checks
+ * that registered consumers are still running, and releases the reference of crashed ones, so that they cannot block it forever.
+ * Consumers must therefore run in the same PID namespace as the producer.
+ * An optional timeout bounds all waits of the producer, after which an exception is thrown.
+ *
+ * Creating a producer fails if a segment with the same name already exists, as it may belong to another running producer.
+ * A segment left by an interrupted run can be removed by setting removeExisting to true.
+ * The segment is removed from the namespace when the producer is destroyed; consumers which already opened it are not affected.
+ *
+ * Only the content, coordinates, score and pass of blocks are transported, not the annotations and properties.
+ * Sequences are expected to be DNA sequences.
+ *
+ * Only available on POSIX systems, an exception is thrown otherwise.
+ */
+class SharedMemoryOutputMafIterator :
+  public AbstractFilterMafIterator
+{
+private:
+  std::string name_;
+  uint64_t capacity_;
+  unsigned int expectedConsumers_;
+  double timeout_;
+  char* data_;
+  size_t size_;
+  bool started_;
+  bool finished_;
+  std::string buffer_;
+
+public:
+  /**
+   * @param iterator The input iterator.
+   * @param name The name of the shared memory segment, starting with a '/'.
+   * @param capacity The size of the ring buffer, in bytes.
+   * @param expectedConsumers The number of consumers to wait for before publishing the first block.
+   * @param timeout The maximum time to wait for consumers, either to register or to release space in the ring buffer, in seconds.
+   * 0 means no limit.
+   * @param removeExisting Remove any existing segment with the same name, instead of failing.
+   * Only use this if no other producer can be using the name.
+   */
+  SharedMemoryOutputMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      const std::string& name,
+      uint64_t capacity = 67108864,
+      unsigned int expectedConsumers = 1,
+      double timeout = 0.,
+      bool removeExisting = false);
+
+  virtual ~SharedMemoryOutputMafIterator();
+
+private:
+  SharedMemoryOutputMafIterator(const SharedMemoryOutputMafIterator&) = delete;
+  SharedMemoryOutputMafIterator& operator=(const SharedMemoryOutputMafIterator&) = delete;
+
+public:
+  /**
+   * @brief Tell consumers that no more block will be published.
+   *
+   * This is done automatically when the end of the input is reached, or when the iterator is destroyed.
+   */
+  void finish();
+
+  /**
+   * @brief Maximum number of consumers for a segment.
+   */
+  static constexpr unsigned int MAX_CONSUMERS = 64;
+
+private:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_();
+
+  void publish_(const MafBlock& block);
+
+  /**
+   * @brief Release the slots of consumers whose process is not running anymore.
+   */
+  void releaseDeadConsumers_();
+};
+
+/**
+ * @brief Read blocks published by a SharedMemoryOutputMafIterator in another process.
+ *
+ * Blocks are decoded directly from the shared memory segment, without intermediate copy.
+ * See SharedMemoryOutputMafIterator for details.
+ */
+class SharedMemoryMafIterator :
+  public AbstractMafIterator
+{
+private:
+  std::string name_;
+  char* data_;
+  size_t size_;
+  unsigned int slot_;
+  std::vector<int> content_;
+
+public:
+  /**
+   * @param name The name of the shared memory segment, as given to the producer.
+   * @param timeout The maximum time to wait for the producer to create the segment, in seconds.
+   */
+  SharedMemoryMafIterator(const std::string& name, double timeout = 10.);
+
+  virtual ~SharedMemoryMafIterator();
+
+private:
+  SharedMemoryMafIterator(const SharedMemoryMafIterator&) = delete;
+  SharedMemoryMafIterator& operator=(const SharedMemoryMafIterator&) = delete;
+
+private:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_();
+};
+} // end of namespace bpp.
+
+#endif // _SHAREDMEMORYMAFTRANSPORT_H_
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "StatisticsTableReader.h"
+#include "AbstractIterationListener.h"
+#include "../BinaryIoTools.h"
+
+using namespace bpp;
+
+// From the STL:
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPP_STATISTICS_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+StatisticsTableReader::StatisticsTableReader(const string& path) :
+  data_(nullptr),
+  size_(0),
+  isMapped_(false),
+  buffer_(),
+  names_(),
+  types_(),
+  chromosomes_(),
+  rowGroups_(),
+  nbRows_(0)
+{
+#ifdef BPP_STATISTICS_USE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw Exception("StatisticsTableReader. Unable to open file " + path + ".");
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED)
+    {
+      data_ = static_cast<const char*>(p);
+      size_ = static_cast<size_t>(st.st_size);
+      isMapped_ = true;
+    }
+  }
+  close(fd);
+#endif
+  if (!isMapped_)
+  {
+    ifstream input(path.c_str(), ios::in | ios::binary);
+    if (!input)
+      throw Exception("StatisticsTableReader. Unable to open file " + path + ".");
+    buffer_.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+  try
+  {
+    readFooter_(path);
+  }
+  catch (...)
+  {
+#ifdef BPP_STATISTICS_USE_MMAP
+    if (isMapped_)
+      munmap(const_cast<char*>(data_), size_);
+#endif
+    throw;
+  }
+}
+
+StatisticsTableReader::~StatisticsTableReader()
+{
+#ifdef BPP_STATISTICS_USE_MMAP
+  if (isMapped_)
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+void StatisticsTableReader::readFooter_(const string& path)
+{
+  if (size_ < 32 || string(data_, 8) != "BPPSTATS" || string(data_ + size_ - 8, 8) != "BPPSTEND")
+    throw Exception("StatisticsTableReader. Not a statistics file, or truncated file: " + path + ".");
+  if (BinaryIoTools::getUInt32(data_ + 8) != 1)
+    throw Exception("StatisticsTableReader. Unsupported format version in " + path + ".");
+  uint64_t footerOffset = BinaryIoTools::getInteger(data_ + size_ - 16, 8);
+  if (footerOffset > size_ - 16)
+    throw Exception("StatisticsTableReader. Corrupted file: " + path + ".");
+  const char* p = data_ + footerOffset;
+  const char* end = data_ + size_ - 16;
+  auto next = [&](size_t nbBytes) {
+        if (static_cast<size_t>(end - p) < nbBytes)
+          throw Exception("StatisticsTableReader. Truncated footer in " + path + ".");
+        const char* q = p;
+        p += nbBytes;
+        return q;
+      };
+  auto nextString = [&]() {
+        uint32_t len = BinaryIoTools::getUInt32(next(4));
+        return string(next(len), len);
+      };
+
+  uint32_t nbColumns = BinaryIoTools::getUInt32(next(4));
+  for (uint32_t i = 0; i < nbColumns; ++i)
+  {
+    names_.push_back(nextString());
+    types_.push_back(static_cast<uint8_t>(*next(1)));
+  }
+  uint32_t nbChromosomes = BinaryIoTools::getUInt32(next(4));
+  for (uint32_t i = 0; i < nbChromosomes; ++i)
+  {
+    chromosomes_.push_back(nextString());
+  }
+  uint64_t nbGroups = BinaryIoTools::getInteger(next(8), 8);
+  for (uint64_t g = 0; g < nbGroups; ++g)
+  {
+    RowGroup_ group;
+    group.nbRows = BinaryIoTools::getInteger(next(8), 8);
+    for (uint32_t i = 0; i < nbColumns; ++i)
+    {
+      ColumnChunk_ chunk;
+      chunk.offset = BinaryIoTools::getInteger(next(8), 8);
+      chunk.size = BinaryIoTools::getInteger(next(8), 8);
+      chunk.encoding = static_cast<uint8_t>(*next(1));
+      if (chunk.offset > footerOffset || chunk.size > footerOffset - chunk.offset)
+        throw Exception("StatisticsTableReader. Corrupted file: " + path + ".");
+      group.chunks.push_back(chunk);
+    }
+    nbRows_ += group.nbRows;
+    rowGroups_.push_back(group);
+  }
+}
+
+size_t StatisticsTableReader::getColumnIndex(const string& name) const
+{
+  for (size_t i = 0; i < names_.size(); ++i)
+  {
+    if (names_[i] == name)
+      return i;
+  }
+  throw Exception("StatisticsTableReader::getColumnIndex. No column with name: " + name + ".");
+}
+
+void StatisticsTableReader::getIntegerColumn(const string& name, vector<uint64_t>& values) const
+{
+  size_t col = getColumnIndex(name);
+  uint8_t type = types_[col];
+  if (type == BinaryStatisticsOutputIterationListener::TYPE_DOUBLE)
+    throw Exception("StatisticsTableReader::getIntegerColumn. Column " + name + " does not contain integers.");
+  size_t nbBytes = (type == BinaryStatisticsOutputIterationListener::TYPE_DICTIONARY ? 4 : 8);
+  values.clear();
+  values.reserve(static_cast<size_t>(nbRows_));
+  for (const auto& group : rowGroups_)
+  {
+    const ColumnChunk_& chunk = group.chunks[col];
+    const char* p = data_ + chunk.offset;
+    const char* end = p + chunk.size;
+    if (chunk.encoding == BinaryStatisticsOutputIterationListener::ENCODING_DELTA_VARINT)
+    {
+      uint64_t x = 0;
+      for (uint64_t i = 0; i < group.nbRows; ++i)
+      {
+        x += static_cast<uint64_t>(BinaryIoTools::zigzagDecode(BinaryIoTools::getVarint(p, end)));
+        values.push_back(x);
+      }
+    }
+    else
+    {
+      if (chunk.size < group.nbRows * nbBytes)
+        throw Exception("StatisticsTableReader::getIntegerColumn. Truncated chunk.");
+      for (uint64_t i = 0; i < group.nbRows; ++i, p += nbBytes)
+      {
+        values.push_back(BinaryIoTools::getInteger(p, nbBytes));
+      }
+    }
+  }
+  // Missing identifiers are stored on 32 bits:
+  if (nbBytes == 4)
+  {
+    for (auto& x : values)
+    {
+      if (x == numeric_limits<uint32_t>::max())
+        x = numeric_limits<uint64_t>::max();
+    }
+  }
+}
+
+void StatisticsTableReader::getColumn(const string& name, vector<double>& values) const
+{
+  size_t col = getColumnIndex(name);
+  values.clear();
+  if (types_[col] != BinaryStatisticsOutputIterationListener::TYPE_DOUBLE)
+  {
+    vector<uint64_t> integers;
+    getIntegerColumn(name, integers);
+    values.reserve(integers.size());
+    for (uint64_t x : integers)
+    {
+      values.push_back(x == numeric_limits<uint64_t>::max() ? numeric_limits<double>::quiet_NaN() : static_cast<double>(x));
+    }
+    return;
+  }
+  values.reserve(static_cast<size_t>(nbRows_));
+  for (const auto& group : rowGroups_)
+  {
+    const ColumnChunk_& chunk = group.chunks[col];
+    if (chunk.size < group.nbRows * 8)
+      throw Exception("StatisticsTableReader::getColumn. Truncated chunk.");
+    const char* p = data_ + chunk.offset;
+    for (uint64_t i = 0; i < group.nbRows; ++i, p += 8)
+    {
+      values.push_back(BinaryIoTools::getDouble(p));
+    }
+  }
+}
+
+void StatisticsTableReader::getChromosomes(vector<string>& chromosomes) const
+{
+  vector<uint64_t> ids;
+  getIntegerColumn("Chr", ids);
+  chromosomes.clear();
+  chromosomes.reserve(ids.size());
+  for (uint64_t id : ids)
+  {
+    chromosomes.push_back(id < chromosomes_.size() ? chromosomes_[static_cast<size_t>(id)] : "NA");
+  }
+}
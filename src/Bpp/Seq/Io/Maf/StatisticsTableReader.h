@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _STATISTICSTABLEREADER_H_
+#define _STATISTICSTABLEREADER_H_
+
+#include <Bpp/Exceptions.h>
+
+// From the STL:
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace bpp
+{
+/**
+ * @brief Read a binary statistics file written by BinaryStatisticsOutputIterationListener.
+ *
+ * The file is memory-mapped when the platform allows it, and read in memory otherwise.
+ * Only the footer is decoded when the file is opened. Columns are then decoded on demand,
+ * so that loading a few columns of a large file only touches the corresponding chunks.
+ */
+class StatisticsTableReader
+{
+private:
+  struct ColumnChunk_
+  {
+    uint64_t offset;
+    uint64_t size;
+    uint8_t encoding;
+  };
+
+  struct RowGroup_
+  {
+    uint64_t nbRows;
+    std::vector<ColumnChunk_> chunks;
+
+    RowGroup_() : nbRows(0), chunks() {}
+  };
+
+private:
+  const char* data_;
+  size_t size_;
+  bool isMapped_;
+  std::string buffer_; // Used when the file is not mapped.
+  std::vector<std::string> names_;
+  std::vector<uint8_t> types_;
+  std::vector<std::string> chromosomes_;
+  std::vector<RowGroup_> rowGroups_;
+  uint64_t nbRows_;
+
+public:
+  /**
+   * @param path The path of the file to read.
+   */
+  StatisticsTableReader(const std::string& path);
+
+  virtual ~StatisticsTableReader();
+
+private:
+  StatisticsTableReader(const StatisticsTableReader&) = delete;
+  StatisticsTableReader& operator=(const StatisticsTableReader&) = delete;
+
+public:
+  /**
+   * @return The names of all columns, including "Chr", "Start" and "Stop".
+   */
+  const std::vector<std::string>& getColumnNames() const { return names_; }
+
+  uint64_t getNumberOfRows() const { return nbRows_; }
+
+  /**
+   * @return The chromosome names, indexed by their identifier.
+   */
+  const std::vector<std::string>& getChromosomeDictionary() const { return chromosomes_; }
+
+  /**
+   * @return The index of a column.
+   * @param name The name of the column.
+   */
+  size_t getColumnIndex(const std::string& name) const;
+
+  /**
+   * @brief Load an integer column ("Chr", "Start" or "Stop").
+   *
+   * Missing values are set to the largest value of the integer type.
+   *
+   * @param name The name of the column.
+   * @param values The vector where to store the values. Its content is replaced.
+   */
+  void getIntegerColumn(const std::string& name, std::vector<uint64_t>& values) const;
+
+  /**
+   * @brief Load a column as doubles.
+   *
+   * Integer columns are converted, missing values being NaN.
+   *
+   * @param name The name of the column.
+   * @param values The vector where to store the values. Its content is replaced.
+   */
+  void getColumn(const std::string& name, std::vector<double>& values) const;
+
+  /**
+   * @brief Load the chromosome column, as names.
+   *
+   * @param chromosomes The vector where to store the names, "NA" for missing values. Its content is replaced.
+   */
+  void getChromosomes(std::vector<std::string>& chromosomes) const;
+
+private:
+  void readFooter_(const std::string& path);
+};
+} // end of namespace bpp.
+
+#endif // _STATISTICSTABLEREADER_H_
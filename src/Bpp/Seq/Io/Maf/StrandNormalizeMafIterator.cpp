@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include "StrandNormalizeMafIterator.h"
+#include "DnaTraits.h"
+
+// From bpp-seq:
+#include <Bpp/Seq/SequenceWithQuality.h>
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
+
+using namespace bpp;
+
+// From the STL:
+#include <string>
+#include <vector>
+
+using namespace std;
+
+unique_ptr<MafSequence> StrandNormalizeMafIterator::reverseComplement(const MafSequence& seq, vector<int>& buffer)
+{
+  // Complementary states, indexed by state + 1 (gap first):
+  static constexpr int complement[16] = {
+    DnaTraits::complement(-1), DnaTraits::complement(0), DnaTraits::complement(1), DnaTraits::complement(2),
+    DnaTraits::complement(3), DnaTraits::complement(4), DnaTraits::complement(5), DnaTraits::complement(6),
+    DnaTraits::complement(7), DnaTraits::complement(8), DnaTraits::complement(9), DnaTraits::complement(10),
+    DnaTraits::complement(11), DnaTraits::complement(12), DnaTraits::complement(13), DnaTraits::complement(14)
+  };
+  const vector<int>& content = seq.getContent();
+  size_t n = content.size();
+  buffer.resize(n);
+  // Single pass on the states, without branching: the compiler can vectorize the table lookup and reversal.
+  for (size_t j = 0; j < n; ++j)
+  {
+    buffer[n - 1 - j] = complement[static_cast<size_t>(content[j] + 1) & 15];
+  }
+
+  char strand = seq.getStrand();
+  if (strand == '+')
+    strand = '-';
+  else if (strand == '-')
+    strand = '+';
+  size_t begin = 0;
+  if (seq.hasCoordinates() && strand != '?')
+    begin = seq.getSrcSize() - seq.stop();
+  auto newSeq = make_unique<MafSequence>(seq.getName(), buffer, begin, strand, seq.getSrcSize());
+  if (!seq.hasCoordinates() || strand == '?')
+    newSeq->removeCoordinates();
+
+  // Reverse annotations:
+  if (seq.hasAnnotation(SequenceMask::MASK))
+  {
+    const SequenceMask& mask = dynamic_cast<const SequenceMask&>(seq.annotation(SequenceMask::MASK));
+    vector<bool> newMask(n);
+    for (size_t j = 0; j < n; ++j)
+    {
+      newMask[n - 1 - j] = mask[j];
+    }
+    newSeq->addAnnotation(make_shared<SequenceMask>(newMask));
+  }
+  if (seq.hasAnnotation(SequenceQuality::QUALITY_SCORE))
+  {
+    const SequenceQuality& qual = dynamic_cast<const SequenceQuality&>(seq.annotation(SequenceQuality::QUALITY_SCORE));
+    auto newQual = make_shared<SequenceQuality>(n);
+    for (size_t j = 0; j < n; ++j)
+    {
+      newQual->setScore(n - 1 - j, qual.getScore(j));
+    }
+    newSeq->addAnnotation(newQual);
+  }
+  return newSeq;
+}
+
+unique_ptr<MafBlock> StrandNormalizeMafIterator::reverseComplement(const MafBlock& block, vector<int>& buffer)
+{
+  auto newBlock = make_unique<MafBlock>();
+  newBlock->setScore(block.getScore());
+  newBlock->setPass(block.getPass());
+  newBlock->copyProperties(block);
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    auto seq = reverseComplement(block.sequence(i), buffer);
+    newBlock->addSequence(seq);
+  }
+  return newBlock;
+}
+
+unique_ptr<MafBlock> StrandNormalizeMafIterator::analyseCurrentBlock_()
+{
+  currentBlock_ = iterator_->nextBlock();
+  if (currentBlock_ && currentBlock_->hasSequenceForSpecies(refSpecies_))
+  {
+    if (currentBlock_->sequenceForSpecies(refSpecies_).getStrand() == '-')
+    {
+      if (logstream_)
+      {
+        (*logstream_ << "STRAND NORMALIZER: block " << currentBlock_->getDescription() << " was reverse-complemented.").endLine();
+      }
+      currentBlock_ = reverseComplement(*currentBlock_, buffer_);
+    }
+  }
+  return std::move(currentBlock_);
+}
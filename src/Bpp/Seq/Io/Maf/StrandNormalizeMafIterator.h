@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#ifndef _STRANDNORMALIZEMAFITERATOR_H_
+#define _STRANDNORMALIZEMAFITERATOR_H_
+
+#include "AbstractMafIterator.h"
+
+// From the STL:
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bpp
+{
+/**
+ * @brief Reverse-complement blocks so that the reference sequence is on the positive strand.
+ *
+ * Blocks where the reference species is on the '-' strand are reverse-complemented as a whole.
+ * For all sequences, the strand is swapped, and the start position is converted accordingly,
+ * as srcSize - (start + size). Masks and quality scores are reversed.
+ * Sequences with an undefined strand ('?') keep it, and remain without coordinates.
+ * Blocks without the reference species, or with the reference on the '+' strand, are forwarded unchanged.
+ *
+ * Downstream iterators can then use reference coordinates directly, without special-casing the negative strand.
+ * Blocks are processed independently of each other.
+ * Sequences are expected to be DNA sequences: states are complemented directly, as with DnaTraits::complement.
+ */
+class StrandNormalizeMafIterator :
+  public AbstractFilterMafIterator
+{
+private:
+  std::string refSpecies_;
+  std::vector<int> buffer_;
+
+public:
+  /**
+   * @brief Creates a new StrandNormalizeMafIterator object.
+   *
+   * @param iterator The input iterator.
+   * @param reference The reference species.
+   */
+  StrandNormalizeMafIterator(
+      std::shared_ptr<MafIteratorInterface> iterator,
+      const std::string& reference) :
+    AbstractFilterMafIterator(iterator),
+    refSpecies_(reference),
+    buffer_()
+  {}
+
+private:
+  StrandNormalizeMafIterator(const StrandNormalizeMafIterator& iterator) :
+    AbstractFilterMafIterator(nullptr),
+    refSpecies_(iterator.refSpecies_),
+    buffer_()
+  {}
+
+  StrandNormalizeMafIterator& operator=(const StrandNormalizeMafIterator& iterator)
+  {
+    refSpecies_ = iterator.refSpecies_;
+    return *this;
+  }
+
+public:
+  /**
+   * @brief Reverse-complement a sequence and update its coordinates and annotations.
+   *
+   * @param seq The input sequence.
+   * @param buffer A buffer, reused between calls.
+   * @return A new sequence, on the other strand.
+   */
+  static std::unique_ptr<MafSequence> reverseComplement(const MafSequence& seq, std::vector<int>& buffer);
+
+  /**
+   * @brief Reverse-complement a whole block.
+   *
+   * @param block The input block.
+   * @param buffer A buffer, reused between calls.
+   * @return A new block, with the same score, pass and properties.
+   */
+  static std::unique_ptr<MafBlock> reverseComplement(const MafBlock& block, std::vector<int>& buffer);
+
+private:
+  std::unique_ptr<MafBlock> analyseCurrentBlock_();
+};
+} // end of namespace bpp.
+
+#endif // _STRANDNORMALIZEMAFITERATOR_H_
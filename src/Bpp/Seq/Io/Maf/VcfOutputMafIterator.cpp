@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: CECILL-2.1
 
 #include "VcfOutputMafIterator.h"
+#include "DnaTraits.h"
 
 // From bpp-seq:
 #include <Bpp/Seq/SequenceWithAnnotationTools.h>
@@ -145,7 +146,7 @@ void VcfOutputMafIterator::writeBlock_(std::ostream& out, const MafBlock& block)
             else
             {
               int state = (*sequences[0])[i];
-              if (AlphabetTools::DNA_ALPHABET->isGap(state) || AlphabetTools::DNA_ALPHABET->isUnresolved(state))
+              if (!DnaTraits::isResolved(state))
                 geno += (generateDiploids_ ? ".|." : ".");
               else
               {
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/DnaTraits.h>
+#include <Bpp/Seq/Io/Maf/MafSequence.h>
+#include <Bpp/Seq/Alphabet/AlphabetTools.h>
+#include <Bpp/Seq/SequenceTools.h>
+
+#include <iostream>
+#include <string>
+#include <cctype>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  try
+  {
+    shared_ptr<const Alphabet> dna = AlphabetTools::DNA_ALPHABET;
+
+    // Check that the traits agree with the DNA alphabet, for all states:
+    for (int x = -1; x < DnaTraits::NUMBER_OF_STATES; ++x)
+    {
+      if (DnaTraits::isGap(x) != dna->isGap(x) ||
+          DnaTraits::isUnresolved(x) != dna->isUnresolved(x) ||
+          DnaTraits::isResolved(x) != (!dna->isGap(x) && !dna->isUnresolved(x)) ||
+          string(1, DnaTraits::intToChar(x)) != dna->intToChar(x) ||
+          DnaTraits::charToInt(dna->intToChar(x)[0]) != dna->charToInt(dna->intToChar(x)) ||
+          DnaTraits::charToInt(static_cast<char>(tolower(dna->intToChar(x)[0]))) != x)
+      {
+        cerr << "Mismatch for state " << x << " (" << dna->intToChar(x) << ")." << endl;
+        return 1;
+      }
+    }
+
+    // Check complements against the reverse complement computed by bpp-seq:
+    string letters;
+    for (int x = -1; x < DnaTraits::NUMBER_OF_STATES; ++x)
+    {
+      letters += dna->intToChar(x);
+    }
+    MafSequence seq("test", letters, false);
+    SequenceTools::invertComplement(seq);
+    size_t n = letters.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+      int x = dna->charToInt(string(1, letters[i]));
+      if (DnaTraits::complement(x) != seq[n - 1 - i] ||
+          DnaTraits::complement(DnaTraits::complement(x)) != x)
+      {
+        cerr << "Wrong complement for state " << x << " (" << letters[i] << ")." << endl;
+        return 1;
+      }
+    }
+    static_assert(DnaTraits::complement(DnaTraits::A) == DnaTraits::T, "Wrong complement.");
+    static_assert(DnaTraits::complement(DnaTraits::C) == DnaTraits::G, "Wrong complement.");
+
+    // The dispatched kernel gives the same result as the alphabet:
+    vector<int> content(seq.getContent());
+    size_t count1 = 0;
+    for (int x : content)
+    {
+      if (!dna->isGap(x) && !dna->isUnresolved(x))
+        count1++;
+    }
+    size_t count2 = AlphabetTraitsTools::dispatch(*dna, [&](const auto& traits) {
+          size_t c = 0;
+          for (int x : content)
+          {
+            if (traits.isResolved(x))
+              c++;
+          }
+          return c;
+        });
+    if (count1 != count2)
+    {
+      cerr << "Counts differ: " << count1 << " vs " << count2 << "." << endl;
+      return 1;
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Feature/FeatureDatabase.h>
+#include <Bpp/Seq/Feature/Gff/GffFeatureReader.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <random>
+#include <cstdio>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  string path = "test_feature_database.bfdb";
+  try
+  {
+    // Random features on two sequences:
+    mt19937 rng(42);
+    uniform_int_distribution<size_t> startDist(0, 10000);
+    uniform_int_distribution<size_t> lengthDist(1, 500);
+    vector<string> seqIds = { "chr2", "chr1" };
+    map<string, BasicSequenceFeature> features;
+    FeatureDatabaseWriter writer;
+    for (size_t i = 0; i < 400; ++i)
+    {
+      string id = "f" + TextTools::toString(i);
+      size_t start = startDist(rng);
+      BasicSequenceFeature feature(id, seqIds[i % 2], "test", (i % 3 == 0 ? "CDS" : "exon"),
+          start, start + lengthDist(rng), (i % 4 == 0 ? '-' : '+'), static_cast<double>(i));
+      feature.setAttribute("Name", id + "_name");
+      if (i % 3 == 0)
+        feature.setAttribute(GffFeatureReader::GFF_PHASE, TextTools::toString(i % 3 + i % 2));
+      writer.addFeature(feature);
+      features.emplace(id, feature);
+    }
+    writer.write(path);
+
+    FeatureDatabase db(path);
+    if (db.getNumberOfFeatures() != features.size() || db.getSequences() != vector<string>({ "chr1", "chr2" }))
+    {
+      cerr << "Wrong database content." << endl;
+      return 1;
+    }
+
+    // All fields and attributes are restored:
+    for (size_t i = 0; i < db.getNumberOfFeatures(); ++i)
+    {
+      BasicSequenceFeature feature = db.getFeature(i);
+      const BasicSequenceFeature& original = features.at(feature.getId());
+      if (feature.getSequenceId() != original.getSequenceId() ||
+          feature.getStart() != original.getStart() ||
+          feature.getEnd() != original.getEnd() ||
+          feature.getType() != original.getType() ||
+          feature.getSource() != original.getSource() ||
+          feature.isNegativeStrand() != original.isNegativeStrand() ||
+          feature.getScore() != original.getScore() ||
+          feature.getAttributes() != original.getAttributes())
+      {
+        cerr << "Wrong feature: " << feature.getId() << "." << endl;
+        return 1;
+      }
+      string phase = original.getAttribute(GffFeatureReader::GFF_PHASE);
+      if (db.getPhase(i) != (phase == "" ? FeatureDatabase::NO_PHASE : TextTools::to<int>(phase)))
+      {
+        cerr << "Wrong phase for feature: " << feature.getId() << "." << endl;
+        return 1;
+      }
+    }
+
+    // Overlapping features, compared to a naive search:
+    for (size_t q = 0; q < 200; ++q)
+    {
+      const string& seqId = seqIds[q % 2];
+      size_t begin = startDist(rng);
+      size_t end = begin + lengthDist(rng) * (q % 5);
+      set<string> expected;
+      for (const auto& it : features)
+      {
+        const BasicSequenceFeature& f = it.second;
+        if (f.getSequenceId() == seqId && begin < end && f.getStart() < end && f.getEnd() > begin)
+          expected.insert(f.getId());
+      }
+      vector<size_t> indices;
+      db.getOverlappingFeatureIndices(seqId, begin, end, indices);
+      set<string> observed;
+      for (size_t k = 0; k < indices.size(); ++k)
+      {
+        if (k > 0 && indices[k] <= indices[k - 1])
+        {
+          cerr << "Indices are not increasing." << endl;
+          return 1;
+        }
+        observed.insert(db.getId(indices[k]));
+      }
+      if (observed != expected)
+      {
+        cerr << "Wrong overlapping features for " << seqId << ":" << begin << "-" << end << ": "
+             << observed.size() << " found, " << expected.size() << " expected." << endl;
+        return 1;
+      }
+    }
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    remove(path.c_str());
+    return 1;
+  }
+  remove(path.c_str());
+  return 0;
+}
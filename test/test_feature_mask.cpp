@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/FeatureFilterMafIterator.h>
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * Blocks with an ungapped reference sequence on the positive strand, and gapped sequences on both strands.
+ */
+string makeMaf(size_t nbBlocks)
+{
+  string maf = "##maf version=1\n\n";
+  for (size_t b = 0; b < nbBlocks; ++b)
+  {
+    maf += "a score=0\n";
+    maf += "s hg.chr1 " + TextTools::toString(b * 100) + " 12 + 100000 ACGTACGTACGT\n";
+    maf += "s mm.chr2 " + TextTools::toString(b * 50) + " 8 - 100000 AC--AC-GT-GT\n";
+    maf += "s rn.chr3 " + TextTools::toString(b * 50) + " 9 + 100000 -CGTAC--ACGT\n";
+    maf += "\n";
+  }
+  return maf;
+}
+
+int main()
+{
+  try
+  {
+    size_t nbBlocks = 5;
+    string maf = makeMaf(nbBlocks);
+
+    // Features within blocks, overlapping block ends, spanning two blocks, and covering a whole block:
+    SequenceFeatureSet features;
+    vector<pair<size_t, size_t>> ranges = { { 3, 6 }, { 10, 12 }, { 108, 115 }, { 195, 205 }, { 300, 312 } };
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+      features.addFeature(BasicSequenceFeature("f" + TextTools::toString(i), "chr1", "test", "repeat", ranges[i].first, ranges[i].second, '+'));
+    }
+
+    vector<unique_ptr<MafBlock>> blocks;
+    MafParser parser(make_shared<istringstream>(maf));
+    while (auto block = parser.nextBlock())
+    {
+      blocks.push_back(std::move(block));
+    }
+
+    auto input = make_shared<MafParser>(make_shared<istringstream>(maf));
+    FeatureFilterMafIterator iterator(input, "hg", features, false, FeatureFilterMafIterator::MODE_MASK, true);
+    iterator.setLogStream(nullptr);
+    iterator.setVerbose(false);
+    size_t b = 0;
+    while (auto block = iterator.nextBlock())
+    {
+      if (b >= nbBlocks)
+      {
+        cerr << "Too many blocks." << endl;
+        return 1;
+      }
+      const MafBlock& original = *blocks[b];
+      if (block->getNumberOfSequences() != original.getNumberOfSequences() ||
+          block->getNumberOfSites() != original.getNumberOfSites())
+      {
+        cerr << "Block " << b << " was not kept intact." << endl;
+        return 1;
+      }
+
+      // Masked columns, from the ungapped reference sequence:
+      size_t refStart = original.sequence(0).start();
+      vector<bool> columns(original.getNumberOfSites(), false);
+      for (size_t c = 0; c < columns.size(); ++c)
+      {
+        for (const auto& range : ranges)
+        {
+          columns[c] = columns[c] || (refStart + c >= range.first && refStart + c < range.second);
+        }
+      }
+
+      for (size_t j = 0; j < block->getNumberOfSequences(); ++j)
+      {
+        const MafSequence& seq = block->sequence(j);
+        const MafSequence& originalSeq = original.sequence(j);
+
+        // Coordinates are unchanged:
+        if (seq.getName() != originalSeq.getName() || seq.getStrand() != originalSeq.getStrand() ||
+            seq.start() != originalSeq.start() || seq.stop() != originalSeq.stop() ||
+            seq.getGenomicSize() != originalSeq.getGenomicSize() || seq.getSrcSize() != originalSeq.getSrcSize() ||
+            SequenceTools::getNumberOfSites(seq) != seq.getGenomicSize())
+        {
+          cerr << "Coordinates changed in block " << b << ", sequence " << seq.getName() << "." << endl;
+          return 1;
+        }
+
+        // Residues in masked columns are replaced by N, gaps are left unchanged:
+        string expected = originalSeq.toString();
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+          if (columns[c] && expected[c] != '-')
+            expected[c] = 'N';
+        }
+        if (seq.toString() != expected)
+        {
+          cerr << "Wrong masking in block " << b << ", sequence " << seq.getName() << ": " << seq.toString() << ", expected " << expected << "." << endl;
+          return 1;
+        }
+        // Blocks without any feature are not annotated:
+        bool isMasked = find(columns.begin(), columns.end(), true) != columns.end();
+        if (seq.hasAnnotation(SequenceMask::MASK) != isMasked ||
+            (isMasked && dynamic_cast<const SequenceMask&>(seq.annotation(SequenceMask::MASK)).getMask() != columns))
+        {
+          cerr << "Wrong mask annotation in block " << b << ", sequence " << seq.getName() << "." << endl;
+          return 1;
+        }
+      }
+      ++b;
+    }
+    if (b != nbBlocks)
+    {
+      cerr << "Missing blocks." << endl;
+      return 1;
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/BiallelicHaplotypeMatrix.h>
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  try
+  {
+    // Random haplotypes, with monomorphic columns, so that site positions are irregular:
+    size_t nbHaplotypes = 12;
+    size_t length = 300;
+    mt19937 rng(42);
+    vector<string> rows(nbHaplotypes, string(length, 'A'));
+    const string bases = "ACGT";
+    for (size_t c = 0; c < length; ++c)
+    {
+      char a = bases[rng() % 4];
+      char b = bases[rng() % 4];
+      bool variable = rng() % 2 == 0;
+      for (size_t h = 0; h < nbHaplotypes; ++h)
+      {
+        unsigned int u = static_cast<unsigned int>(rng() % 20);
+        rows[h][c] = u == 0 ? '-' : (u == 1 ? 'N' : (variable && u % 2 ? b : a));
+      }
+    }
+    vector<unique_ptr<MafSequence>> sequences;
+    vector<const MafSequence*> haplotypes;
+    for (size_t h = 0; h < nbHaplotypes; ++h)
+    {
+      sequences.push_back(make_unique<MafSequence>("h" + to_string(h), rows[h], false));
+      haplotypes.push_back(sequences.back().get());
+    }
+    BiallelicHaplotypeMatrix matrix;
+    matrix.build(haplotypes);
+    size_t n = matrix.getNumberOfSites();
+    if (n < 10)
+    {
+      cerr << "Too few sites: " << n << "." << endl;
+      return 1;
+    }
+
+    for (size_t maxDistance : vector<size_t>({ 0, 1, 5, 10, 40, 1000 }))
+    {
+      // Naive computation:
+      map<pair<size_t, size_t>, double> expected;
+      PairwiseLinkageDisequilibrium ld;
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = i + 1; j < n; ++j)
+        {
+          if (matrix.getPosition(j) - matrix.getPosition(i) <= maxDistance && matrix.computeLinkageDisequilibrium(i, j, ld))
+            expected[make_pair(i, j)] = ld.r2;
+        }
+      }
+      for (size_t tileSize : vector<size_t>({ 1, 2, 3, 7, 64, 1000 }))
+      {
+        map<pair<size_t, size_t>, double> observed;
+        bool duplicated = false;
+        auto f = [&](size_t i, size_t j, const PairwiseLinkageDisequilibrium& x) {
+              if (!observed.insert(make_pair(make_pair(i, j), x.r2)).second)
+                duplicated = true;
+            };
+        matrix.computeAllPairs(maxDistance, f, tileSize);
+        if (duplicated || observed != expected)
+        {
+          cerr << "Tiled computation differs from the naive one for maxDistance=" << maxDistance << " and tileSize=" << tileSize << ": "
+               << observed.size() << " pairs instead of " << expected.size() << "." << endl;
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
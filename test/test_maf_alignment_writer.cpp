@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/MafAlignmentWriter.h>
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <string>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  try
+  {
+    string maf =
+      "##maf version=1\n"
+      "\n"
+      "a score=1\n"
+      "s hg.chr1 10 12 + 100 ACGTMRwsykVH\n"
+      "s mm.chr2  5 11 -  50 DBN-acgtACGT\n"
+      "\n";
+    auto input = make_shared<istringstream>(maf);
+    MafParser parser(input, true);
+    auto block = parser.nextBlock();
+    if (!block || block->getNumberOfSequences() != 2)
+    {
+      cerr << "No block." << endl;
+      return 1;
+    }
+
+    // Masked positions are written in lowercase:
+    FastaMafAlignmentWriter fasta("%s.%c", 0);
+    fasta.setMask(true);
+    ostringstream out1;
+    fasta.writeBlock(out1, *block);
+    string expected1 = ">hg.chr1\nACGTMRwsykVH\n>mm.chr2\nDBN-acgtACGT\n";
+    if (out1.str() != expected1)
+    {
+      cerr << "Wrong FASTA output:" << endl << out1.str();
+      return 1;
+    }
+
+    PhylipMafAlignmentWriter phylip("%s.%c");
+    phylip.setMask(true);
+    ostringstream out2;
+    phylip.writeBlock(out2, *block);
+    string expected2 = "2 12\nhg.chr1  ACGTMRwsykVH\nmm.chr2  DBN-acgtACGT\n";
+    if (out2.str() != expected2)
+    {
+      cerr << "Wrong PHYLIP output:" << endl << out2.str();
+      return 1;
+    }
+
+    // Without masking, all positions are in uppercase:
+    fasta.setMask(false);
+    fasta.setLineLength(5);
+    ostringstream out3;
+    fasta.writeBlock(out3, *block);
+    string expected3 = ">hg.chr1\nACGTM\nRWSYK\nVH\n>mm.chr2\nDBN-A\nCGTAC\nGT\n";
+    if (out3.str() != expected3)
+    {
+      cerr << "Wrong unmasked FASTA output:" << endl << out3.str();
+      return 1;
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
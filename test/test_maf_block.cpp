@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafBlock.h>
+#include <Bpp/Numeric/Number.h>
+
+#include <iostream>
+#include <memory>
+#include <utility>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  try
+  {
+    MafBlock block;
+    block.setScore(3.);
+    auto seq1 = make_unique<MafSequence>("hg.chr1", "ACGT-ACGT", 10, '+', 1000);
+    auto seq2 = make_unique<MafSequence>("mm.chr2", "ACG--ACGA", 20, '-', 500);
+    block.addSequence(seq1);
+    block.addSequence(seq2);
+    block.setProperty("test", make_unique<BppInteger>(1));
+
+    // A copy shares all rows:
+    MafBlock copy(block);
+    if (&copy.sequence(0) != &block.sequence(0) || &copy.sequence(1) != &block.sequence(1) ||
+        !copy.isSequenceShared(0) || !block.isSequenceShared(1) ||
+        &copy.getProperty("test") != &block.getProperty("test"))
+    {
+      cerr << "Copy does not share rows." << endl;
+      return 1;
+    }
+
+    // Writing a row of the copy only copies this row:
+    copy.mutableSequence(0).setChromosome("chrZ");
+    if (block.sequence(0).getChromosome() != "chr1" || copy.sequence(0).getChromosome() != "chrZ" ||
+        &copy.sequence(1) != &block.sequence(1) || copy.isSequenceShared(0) || block.isSequenceShared(0))
+    {
+      cerr << "Copy on write failed." << endl;
+      return 1;
+    }
+
+    // A row which is not shared is modified in place:
+    const MafSequence* row = &copy.sequence(0);
+    copy.removeCoordinatesFromSequence(0);
+    if (&copy.sequence(0) != row || copy.sequence(0).hasCoordinates() || !block.sequence(0).hasCoordinates())
+    {
+      cerr << "Unshared row was copied." << endl;
+      return 1;
+    }
+
+    // Deleting sites does not affect the original block:
+    copy.deleteSites(3, 2);
+    if (copy.getNumberOfSites() != 7 || copy.sequence(1).toString() != "ACGACGA" ||
+        block.getNumberOfSites() != 9 || block.sequence(1).toString() != "ACG--ACGA" ||
+        block.site(4).toString() != "--" || copy.site(3).toString() != "AA")
+    {
+      cerr << "Wrong sites after deletion." << endl;
+      return 1;
+    }
+
+    // Moving a block moves its rows:
+    const MafSequence* row1 = &block.sequence(1);
+    MafBlock moved(std::move(block));
+    if (moved.getNumberOfSequences() != 2 || &moved.sequence(1) != row1 || moved.getScore() != 3. ||
+        !moved.hasProperty("test") || block.getNumberOfSequences() != 0)
+    {
+      cerr << "Move failed." << endl;
+      return 1;
+    }
+    MafBlock assigned;
+    assigned = std::move(moved);
+    if (&assigned.sequence(1) != row1 || moved.getNumberOfSequences() != 0)
+    {
+      cerr << "Move assignment failed." << endl;
+      return 1;
+    }
+
+    // Rows must have the length of the alignment:
+    auto seq3 = make_unique<MafSequence>("rn.chr3", "ACGT", 0, '+', 100);
+    try
+    {
+      assigned.addSequence(seq3);
+      cerr << "Sequence with a wrong length was added." << endl;
+      return 1;
+    }
+    catch (Exception&)
+    {}
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/MafCatalog.h>
+#include <Bpp/Seq/Io/Maf/CatalogMafIterator.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <cmath>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * Blocks with various species, reference chromosomes, strands, lengths and scores.
+ * Each block is identified by the start position of the 'mm' sequence, which is always present.
+ */
+string makeMaf(size_t nbBlocks)
+{
+  string maf = "##maf version=1\n\n";
+  for (size_t b = 0; b < nbBlocks; ++b)
+  {
+    size_t length = 3 + b % 7;
+    string seq(length, 'C');
+    string size = " " + TextTools::toString(length) + " ";
+    maf += "a" + (b % 7 == 6 ? string("") : " score=" + TextTools::toString(static_cast<double>(b) * 1.5)) + "\n";
+    if (b % 6 != 3)
+      maf += "s hg.chr" + TextTools::toString(1 + b % 2) + " " + TextTools::toString(b * 100) + size + (b % 5 == 4 ? "-" : "+") + " 100000 " + seq + "\n";
+    maf += "s mm.chr1 " + TextTools::toString(b * 10) + size + "+ 100000 " + seq + "\n";
+    if (b % 2 == 0)
+      maf += "s rn.chr3 " + TextTools::toString(b * 10) + size + "+ 100000 " + seq + "\n";
+    if (b % 3 == 0)
+      maf += "s cf.chr4 " + TextTools::toString(b * 10) + size + "+ 100000 " + seq + "\n";
+    if (b % 4 == 1)
+      maf += "s bt.chr5 " + TextTools::toString(b * 10) + size + "+ 100000 " + seq + "\n";
+    maf += "\n";
+  }
+  return maf;
+}
+
+bool isSelected(const MafBlock& block, const MafCatalogQuery& query)
+{
+  for (const auto& sp : query.allSpecies)
+  {
+    if (!block.hasSequenceForSpecies(sp))
+      return false;
+  }
+  bool any = query.anySpecies.empty();
+  for (const auto& sp : query.anySpecies)
+  {
+    any = any || block.hasSequenceForSpecies(sp);
+  }
+  if (!any)
+    return false;
+  for (const auto& sp : query.excludedSpecies)
+  {
+    if (block.hasSequenceForSpecies(sp))
+      return false;
+  }
+  if (!query.chromosomes.empty() &&
+      (!block.hasSequenceForSpecies("hg") || query.chromosomes.count(block.sequenceForSpecies("hg").getChromosome()) == 0))
+    return false;
+  return block.getNumberOfSites() >= query.minLength &&
+         block.getNumberOfSequences() >= query.minSize &&
+         block.getScore() >= query.minScore;
+}
+
+int main()
+{
+  try
+  {
+    size_t nbBlocks = 40;
+    string maf = makeMaf(nbBlocks);
+
+    // Parse all blocks, for comparison:
+    vector<unique_ptr<MafBlock>> blocks;
+    auto input = make_shared<istringstream>(maf);
+    MafParser parser(input);
+    while (auto block = parser.nextBlock())
+    {
+      blocks.push_back(std::move(block));
+    }
+
+    // Build, write and read back the catalog:
+    istringstream catalogInput(maf);
+    MafCatalog built("hg");
+    built.build(catalogInput);
+    stringstream binary(ios::in | ios::out | ios::binary);
+    built.write(binary);
+    auto catalog = make_shared<MafCatalog>();
+    catalog->read(binary);
+
+    if (catalog->getNumberOfBlocks() != nbBlocks || blocks.size() != nbBlocks ||
+        catalog->getReferenceSpecies() != "hg" ||
+        catalog->getSpeciesList() != built.getSpeciesList() ||
+        catalog->getChromosomeList() != built.getChromosomeList())
+    {
+      cerr << "Wrong catalog content." << endl;
+      return 1;
+    }
+    for (size_t i = 0; i < nbBlocks; ++i)
+    {
+      const MafBlock& block = *blocks[i];
+      const MafCatalog::Entry& entry = catalog->getEntry(i);
+      const MafCatalog::Entry& builtEntry = built.getEntry(i);
+      bool ok = entry.offset == builtEntry.offset && entry.byteLength == builtEntry.byteLength &&
+                maf.compare(static_cast<size_t>(entry.offset), 1, "a") == 0 &&
+                entry.nbSequences == block.getNumberOfSequences() &&
+                entry.nbSites == block.getNumberOfSites() &&
+                (entry.score == block.getScore() || (std::isinf(entry.score) && std::isinf(block.getScore())));
+      if (block.hasSequenceForSpecies("hg"))
+      {
+        const MafSequence& refSeq = block.sequenceForSpecies("hg");
+        size_t start = refSeq.getStrand() == '-' ? refSeq.getSrcSize() - refSeq.start() - refSeq.getGenomicSize() : refSeq.start();
+        ok = ok && entry.chromosome != MafCatalog::NO_CHROMOSOME &&
+             catalog->getChromosomeList()[entry.chromosome] == refSeq.getChromosome() &&
+             entry.refStrand == refSeq.getStrand() &&
+             entry.refStart == start && entry.refStop == start + refSeq.getGenomicSize();
+      }
+      else
+      {
+        ok = ok && entry.chromosome == MafCatalog::NO_CHROMOSOME;
+      }
+      for (const auto& sp : catalog->getSpeciesList())
+      {
+        ok = ok && catalog->hasSpecies(i, sp) == block.hasSequenceForSpecies(sp);
+      }
+      if (!ok)
+      {
+        cerr << "Wrong entry for block " << i << "." << endl;
+        return 1;
+      }
+    }
+
+    // Queries, compared to a selection on parsed blocks:
+    vector<MafCatalogQuery> queries(9);
+    queries[1].allSpecies = { "hg", "rn" };
+    queries[2].anySpecies = { "cf", "bt" };
+    queries[3].excludedSpecies = { "rn" };
+    queries[4].chromosomes = { "chr2" };
+    queries[5].minLength = 6;
+    queries[5].minSize = 3;
+    queries[6].minScore = 10.;
+    queries[7].allSpecies = { "hg", "unknown" };
+    queries[8].anySpecies = { "cf", "unknown" };
+    queries[8].chromosomes = { "chr1" };
+    queries[8].minScore = 5.;
+    for (size_t q = 0; q < queries.size(); ++q)
+    {
+      vector<size_t> expected;
+      for (size_t i = 0; i < nbBlocks; ++i)
+      {
+        if (isSelected(*blocks[i], queries[q]))
+          expected.push_back(i);
+      }
+      if (catalog->select(queries[q]) != expected)
+      {
+        cerr << "Wrong selection for query " << q << "." << endl;
+        return 1;
+      }
+
+      // Selected blocks are read by seeking in the MAF stream, with read size limits
+      // smaller than a block, than a few blocks, and larger than the whole file:
+      for (size_t maxReadSize : { static_cast<size_t>(1), static_cast<size_t>(200), CatalogMafIterator::DEFAULT_MAX_READ_SIZE })
+      {
+        auto mafInput = make_shared<istringstream>(maf);
+        CatalogMafIterator iterator(mafInput, catalog, queries[q], false, true, MafParser::DOT_ERROR, maxReadSize);
+        if (iterator.getNumberOfSelectedBlocks() != expected.size())
+        {
+          cerr << "Wrong number of selected blocks for query " << q << "." << endl;
+          return 1;
+        }
+        size_t k = 0;
+        while (auto block = iterator.nextBlock())
+        {
+          if (k >= expected.size() ||
+              block->sequenceForSpecies("mm").start() != blocks[expected[k]]->sequenceForSpecies("mm").start() ||
+              block->getNumberOfSequences() != blocks[expected[k]]->getNumberOfSequences())
+          {
+            cerr << "Wrong block returned for query " << q << " (read size: " << maxReadSize << ")." << endl;
+            return 1;
+          }
+          ++k;
+        }
+        if (k != expected.size())
+        {
+          cerr << "Missing blocks for query " << q << " (read size: " << maxReadSize << ")." << endl;
+          return 1;
+        }
+      }
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/SequenceFilterMafIterator.h>
+#include <Bpp/Seq/Io/Maf/ChromosomeMafIterator.h>
+#include <Bpp/Seq/Io/Maf/BlockLengthMafIterator.h>
+#include <Bpp/Seq/Io/Maf/BlockSizeMafIterator.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <random>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * Random blocks, with duplicated species, quality lines, and blocks without the reference species.
+ */
+string makeMaf(size_t nbBlocks)
+{
+  mt19937 rng(12345);
+  vector<string> species = { "hg", "mm", "rn", "cf" };
+  string bases = "ACGT";
+  string maf = "##maf version=1\n\n";
+  for (size_t b = 0; b < nbBlocks; ++b)
+  {
+    size_t length = 2 + rng() % 9;
+    size_t nbRows = 1 + rng() % 5;
+    maf += "a score=" + TextTools::toString(b) + "\n";
+    for (size_t r = 0; r < nbRows; ++r)
+    {
+      string sp = species[rng() % species.size()];
+      string chr = "chr" + TextTools::toString(1 + rng() % 3);
+      string seq, quality;
+      for (size_t j = 0; j < length; ++j)
+      {
+        seq += bases[rng() % 4];
+        quality += static_cast<char>('0' + rng() % 10);
+      }
+      maf += "s " + sp + "." + chr + " " + TextTools::toString(b * 20 + r) + " " + TextTools::toString(length) + " + 100000 " + seq + "\n";
+      if (sp != "hg" && rng() % 3 == 0)
+        maf += "q " + sp + "." + chr + " " + quality + "\n";
+    }
+    maf += "\n";
+  }
+  return maf;
+}
+
+void setQuiet(AbstractMafIterator& iterator)
+{
+  iterator.setVerbose(false);
+  iterator.setLogStream(nullptr);
+}
+
+string describe(const MafBlock& block)
+{
+  string description = TextTools::toString(block.getScore());
+  for (size_t i = 0; i < block.getNumberOfSequences(); ++i)
+  {
+    const MafSequence& seq = block.sequence(i);
+    description += " " + seq.getName() + ":" + TextTools::toString(seq.start()) + ":" + seq.toString();
+  }
+  return description;
+}
+
+int main()
+{
+  try
+  {
+    string maf = makeMaf(200);
+    vector<MafParserPushdown> pushdowns(7);
+    pushdowns[1].species = { "hg", "mm" };
+    pushdowns[2].reference = "hg";
+    pushdowns[2].chromosomes = { "chr2" };
+    pushdowns[3].species = { "rn", "cf" };
+    pushdowns[3].minLength = 6;
+    pushdowns[4].species = { "hg", "rn" };
+    pushdowns[4].reference = "hg";
+    pushdowns[4].chromosomes = { "chr1", "chr3" };
+    pushdowns[4].minLength = 5;
+    pushdowns[4].minSize = 2;
+    pushdowns[5].minSize = 3;
+    // The reference species is not selected, so that no block remains:
+    pushdowns[6].species = { "mm" };
+    pushdowns[6].reference = "hg";
+    pushdowns[6].chromosomes = { "chr1" };
+
+    for (size_t p = 0; p < pushdowns.size(); ++p)
+    {
+      const MafParserPushdown& pushdown = pushdowns[p];
+
+      // Parse with the pushdown:
+      vector<string> observed;
+      auto parser = make_shared<MafParser>(make_shared<istringstream>(maf), false, true, MafParser::DOT_ERROR, pushdown);
+      setQuiet(*parser);
+      while (auto block = parser->nextBlock())
+      {
+        observed.push_back(describe(*block));
+      }
+
+      // Parse, then apply the equivalent filters:
+      vector<string> expected;
+      auto chainParser = make_shared<MafParser>(make_shared<istringstream>(maf));
+      setQuiet(*chainParser);
+      shared_ptr<AbstractMafIterator> iterator = chainParser;
+      if (!pushdown.species.empty())
+      {
+        iterator = make_shared<SequenceFilterMafIterator>(iterator, vector<string>(pushdown.species.begin(), pushdown.species.end()));
+        setQuiet(*iterator);
+      }
+      if (!pushdown.chromosomes.empty())
+      {
+        iterator = make_shared<ChromosomeMafIterator>(iterator, pushdown.reference, pushdown.chromosomes);
+        setQuiet(*iterator);
+      }
+      if (pushdown.minLength > 0)
+      {
+        iterator = make_shared<BlockLengthMafIterator>(iterator, pushdown.minLength);
+        setQuiet(*iterator);
+      }
+      if (pushdown.minSize > 0)
+      {
+        iterator = make_shared<BlockSizeMafIterator>(iterator, static_cast<unsigned int>(pushdown.minSize));
+        setQuiet(*iterator);
+      }
+      while (auto block = iterator->nextBlock())
+      {
+        expected.push_back(describe(*block));
+      }
+
+      if (observed != expected)
+      {
+        cerr << "Pushdown " << p << ": " << observed.size() << " blocks, " << expected.size() << " with the filter chain." << endl;
+        for (size_t i = 0; i < min(observed.size(), expected.size()); ++i)
+        {
+          if (observed[i] != expected[i])
+          {
+            cerr << "First difference:" << endl << observed[i] << endl << expected[i] << endl;
+            break;
+          }
+        }
+        return 1;
+      }
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/ScoreTrack.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * @brief Compute the summary of a region directly from the scores.
+ */
+ScoreTrackSummary naiveSummary(const vector<double>& scores, uint64_t start, uint64_t end)
+{
+  ScoreTrackSummary summary;
+  for (uint64_t i = start; i < end && i < scores.size(); ++i)
+  {
+    if (!std::isnan(scores[i]))
+      summary.add(static_cast<double>(static_cast<float>(scores[i])));
+  }
+  return summary;
+}
+
+bool isEqual(const ScoreTrackSummary& s1, const ScoreTrackSummary& s2)
+{
+  return s1.coverage == s2.coverage && s1.min == s2.min && s1.max == s2.max &&
+         std::abs(s1.sum - s2.sum) <= 1e-9 * max(1., std::abs(s2.sum));
+}
+
+int main()
+{
+  string path = "test_score_track.bst";
+  try
+  {
+    // Scores on several chromosomes, with runs of identical values, unscored regions and NaNs:
+    mt19937 rng(2024);
+    uniform_int_distribution<int> dist(0, 99);
+    vector<string> chromosomes = { "chr2", "chr1", "chrX" };
+    vector<double> values = { 0.1, -2., 1.25, 3.3333333333 };
+    map<string, vector<double>> scores;
+    for (size_t c = 0; c < chromosomes.size(); ++c)
+    {
+      vector<double>& chrScores = scores[chromosomes[c]];
+      chrScores.resize(3000 + 1000 * c, numeric_limits<double>::quiet_NaN());
+      double value = values[0];
+      for (size_t i = 0; i < chrScores.size(); ++i)
+      {
+        // Unscored region, overlapping several bins:
+        if (i >= 1234 && i < 1789)
+          continue;
+        int r = dist(rng);
+        if (r < 5)
+          continue;
+        if (r < 25)
+          value = values[static_cast<size_t>(r) % values.size()];
+        else if (r < 30)
+          value = static_cast<double>(r) / 7.;
+        chrScores[i] = value;
+      }
+    }
+
+    // Write the track, with small chunks and bins so that queries cross many of them:
+    auto output = make_shared<ofstream>(path.c_str(), ios::out | ios::binary);
+    ScoreTrackWriter writer(output, {10, 100, 1000}, 3);
+    for (const auto& chr : chromosomes)
+    {
+      const vector<double>& chrScores = scores[chr];
+      for (size_t i = 0; i < chrScores.size(); ++i)
+      {
+        writer.addScore(chr, i, chrScores[i]);
+      }
+    }
+    writer.close();
+    output->close();
+
+    ScoreTrackReader reader(path);
+    if (reader.getChromosomes() != chromosomes || reader.getZoomBinSizes() != vector<uint32_t>({10, 100, 1000}))
+    {
+      cerr << "Wrong track description." << endl;
+      return 1;
+    }
+
+    for (const auto& chr : chromosomes)
+    {
+      const vector<double>& chrScores = scores[chr];
+      uint64_t size = chrScores.size();
+      while (std::isnan(chrScores[size - 1]))
+      {
+        size--;
+      }
+      if (reader.getChromosomeSize(chr) != size)
+      {
+        cerr << "Wrong size for chromosome " << chr << "." << endl;
+        return 1;
+      }
+
+      // Regions starting and ending mid-bin, on bin bounds, empty, or beyond the end of the chromosome:
+      vector<pair<uint64_t, uint64_t>> regions = { { 0, chrScores.size() }, { 5, 5 }, { 1000, 2000 }, { 1240, 1780 }, { 2995, 10000 } };
+      uniform_int_distribution<uint64_t> posDist(0, chrScores.size() + 50);
+      for (size_t q = 0; q < 200; ++q)
+      {
+        uint64_t a = posDist(rng);
+        uint64_t b = posDist(rng);
+        regions.push_back(a < b ? make_pair(a, b) : make_pair(b, a));
+      }
+
+      for (const auto& region : regions)
+      {
+        uint64_t start = region.first;
+        uint64_t end = region.second;
+        string description = chr + ":" + TextTools::toString(start) + "-" + TextTools::toString(end);
+
+        // Records must cover exactly the scored positions of the region:
+        vector<ScoreTrackRecord> records;
+        reader.getRecords(chr, start, end, records);
+        vector<double> observed(chrScores.size(), numeric_limits<double>::quiet_NaN());
+        uint64_t previousEnd = start;
+        for (const auto& record : records)
+        {
+          if (record.start < previousEnd || record.start >= record.end || record.end > end)
+          {
+            cerr << "Records are not sorted or not clipped in " << description << "." << endl;
+            return 1;
+          }
+          previousEnd = record.end;
+          for (uint32_t i = record.start; i < record.end; ++i)
+          {
+            observed[i] = static_cast<double>(record.value);
+          }
+        }
+        for (uint64_t i = 0; i < chrScores.size(); ++i)
+        {
+          bool expectScore = i >= start && i < end && !std::isnan(chrScores[i]);
+          if (expectScore != !std::isnan(observed[i]) ||
+              (expectScore && observed[i] != static_cast<double>(static_cast<float>(chrScores[i]))))
+          {
+            cerr << "Wrong record at position " << i << " in " << description << "." << endl;
+            return 1;
+          }
+        }
+
+        // Summaries use zoom levels, and must match the scores:
+        ScoreTrackSummary summary = reader.getSummary(chr, start, end);
+        ScoreTrackSummary expected = naiveSummary(chrScores, start, end);
+        if (!isEqual(summary, expected))
+        {
+          cerr << "Wrong summary in " << description << ": coverage " << summary.coverage << ", sum " << summary.sum
+               << ", expected coverage " << expected.coverage << ", sum " << expected.sum << "." << endl;
+          return 1;
+        }
+      }
+    }
+
+    // Unsorted scores are rejected:
+    auto output2 = make_shared<ofstream>(path.c_str(), ios::out | ios::binary);
+    ScoreTrackWriter writer2(output2);
+    writer2.addScore("chr1", 10, 1.);
+    try
+    {
+      writer2.addScore("chr1", 5, 1.);
+      cerr << "Unsorted positions were accepted." << endl;
+      return 1;
+    }
+    catch (Exception&)
+    {}
+    writer2.addScore("chr2", 0, 1.);
+    try
+    {
+      writer2.addScore("chr1", 20, 1.);
+      cerr << "Unsorted chromosomes were accepted." << endl;
+      return 1;
+    }
+    catch (Exception&)
+    {}
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    remove(path.c_str());
+    return 1;
+  }
+  remove(path.c_str());
+  return 0;
+}
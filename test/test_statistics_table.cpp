@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/MafStatistics.h>
+#include <Bpp/Seq/Io/Maf/SequenceStatisticsMafIterator.h>
+#include <Bpp/Seq/Io/Maf/AbstractIterationListener.h>
+#include <Bpp/Seq/Io/Maf/StatisticsTableReader.h>
+#include <Bpp/Text/TextTools.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+
+using namespace bpp;
+using namespace std;
+
+/**
+ * Blocks on several chromosomes, with coordinates going up and down so that deltas are negative,
+ * large coordinates, and blocks without the reference species.
+ */
+string makeMaf()
+{
+  vector<string> chromosomes = { "chr1", "chr2", "chrX" };
+  string maf = "##maf version=1\n\n";
+  for (size_t b = 0; b < 23; ++b)
+  {
+    size_t length = 5 + b % 4;
+    string seq(length, 'A');
+    maf += "a score=0\n";
+    if (b % 5 != 2)
+    {
+      size_t start = (b % 3 == 0 ? 1000000000 + (23 - b) * 1000 : b * 100);
+      maf += "s hg." + chromosomes[b % 3] + " " + TextTools::toString(start) + " " + TextTools::toString(length) + " + 2000000000 " + seq + "\n";
+    }
+    maf += "s mm.chr1 " + TextTools::toString(b * 10) + " " + TextTools::toString(length) + " + 100000 " + seq + "\n";
+    if (b % 2 == 0)
+      maf += "s rn.chr1 " + TextTools::toString(b * 10) + " " + TextTools::toString(length) + " + 100000 " + seq + "\n";
+    maf += "\n";
+  }
+  return maf;
+}
+
+int checkTable(const string& maf, bool compress)
+{
+  string path = "test_statistics_table.bin";
+
+  // Write the table:
+  {
+    auto input = make_shared<istringstream>(maf);
+    auto parser = make_shared<MafParser>(input);
+    vector<shared_ptr<MafStatisticsInterface>> statistics;
+    statistics.push_back(make_shared<BlockSizeMafStatistics>());
+    statistics.push_back(make_shared<BlockLengthMafStatistics>());
+    auto statsIterator = make_shared<SequenceStatisticsMafIterator>(parser, statistics);
+    auto output = make_shared<ofstream>(path.c_str(), ios::out | ios::binary);
+    // Small row groups, so that the table has several of them, the last one being incomplete:
+    statsIterator->addIterationListener(make_unique<BinaryStatisticsOutputIterationListener>(statsIterator, "hg", output, 4, compress));
+    while (statsIterator->nextBlock())
+    {}
+    output->close();
+  }
+
+  // Expected values, from the blocks themselves:
+  vector<string> chromosomes;
+  vector<uint64_t> starts, stops;
+  vector<double> sizes, lengths;
+  auto input = make_shared<istringstream>(maf);
+  MafParser parser(input);
+  while (auto block = parser.nextBlock())
+  {
+    if (block->hasSequenceForSpecies("hg"))
+    {
+      const MafSequence& refSeq = block->sequenceForSpecies("hg");
+      chromosomes.push_back(refSeq.getChromosome());
+      starts.push_back(refSeq.start());
+      stops.push_back(refSeq.stop());
+    }
+    else
+    {
+      chromosomes.push_back("NA");
+      starts.push_back(numeric_limits<uint64_t>::max());
+      stops.push_back(numeric_limits<uint64_t>::max());
+    }
+    sizes.push_back(static_cast<double>(block->getNumberOfSequences()));
+    lengths.push_back(static_cast<double>(block->getNumberOfSites()));
+  }
+
+  StatisticsTableReader reader(path);
+  const vector<string>& names = reader.getColumnNames();
+  if (reader.getNumberOfRows() != sizes.size() || names.size() != 5 ||
+      names[0] != "Chr" || names[1] != "Start" || names[2] != "Stop")
+  {
+    cerr << "Wrong table dimensions." << endl;
+    return 1;
+  }
+  vector<string> observedChromosomes;
+  reader.getChromosomes(observedChromosomes);
+  vector<uint64_t> observedStarts, observedStops, chrIds;
+  reader.getIntegerColumn("Start", observedStarts);
+  reader.getIntegerColumn("Stop", observedStops);
+  reader.getIntegerColumn("Chr", chrIds);
+  vector<double> observedSizes, observedLengths, chrValues;
+  reader.getColumn(names[3], observedSizes);
+  reader.getColumn(names[4], observedLengths);
+  reader.getColumn("Chr", chrValues);
+  if (observedChromosomes != chromosomes || observedStarts != starts || observedStops != stops ||
+      observedSizes != sizes || observedLengths != lengths)
+  {
+    cerr << "Wrong values (compression: " << compress << ")." << endl;
+    return 1;
+  }
+  // Missing identifiers are the largest integer, or NaN when read as doubles:
+  for (size_t i = 0; i < chromosomes.size(); ++i)
+  {
+    bool isMissing = (chromosomes[i] == "NA");
+    if (isMissing != (chrIds[i] == numeric_limits<uint64_t>::max()) || isMissing != std::isnan(chrValues[i]))
+    {
+      cerr << "Wrong missing value at row " << i << " (compression: " << compress << ")." << endl;
+      return 1;
+    }
+  }
+  remove(path.c_str());
+  return 0;
+}
+
+int main()
+{
+  try
+  {
+    string maf = makeMaf();
+    if (checkTable(maf, true) != 0)
+      return 1;
+    if (checkTable(maf, false) != 0)
+      return 1;
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}
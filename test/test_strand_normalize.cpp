@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: The Bio++ Development Group
+//
+// SPDX-License-Identifier: CECILL-2.1
+
+#include <Bpp/Seq/Io/Maf/MafParser.h>
+#include <Bpp/Seq/Io/Maf/StrandNormalizeMafIterator.h>
+#include <Bpp/Seq/SequenceWithAnnotationTools.h>
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <vector>
+
+using namespace bpp;
+using namespace std;
+
+int main()
+{
+  try
+  {
+    string maf =
+      "##maf version=1\n"
+      "\n"
+      "a score=1\n"
+      "s hg.chr1 10 9 - 100 ACMRWSYK-N\n"
+      "s mm.chr2  5 8 +  50 VHDBacgt--\n"
+      "\n";
+    auto input = make_shared<istringstream>(maf);
+    auto parser = make_shared<MafParser>(input, true);
+    StrandNormalizeMafIterator iterator(parser, "hg");
+    auto block = iterator.nextBlock();
+    if (!block || block->getNumberOfSequences() != 2)
+    {
+      cerr << "No block." << endl;
+      return 1;
+    }
+
+    const MafSequence& hg = block->sequence(0);
+    const MafSequence& mm = block->sequence(1);
+    if (hg.toString() != "N-MRSWYKGT" || mm.toString() != "--ACGTVHDB")
+    {
+      cerr << "Wrong reverse complement: " << hg.toString() << " " << mm.toString() << "." << endl;
+      return 1;
+    }
+    if (hg.getStrand() != '+' || hg.start() != 81 || hg.getGenomicSize() != 9 ||
+        mm.getStrand() != '-' || mm.start() != 37 || mm.getGenomicSize() != 8)
+    {
+      cerr << "Wrong coordinates." << endl;
+      return 1;
+    }
+    vector<bool> expectedMask = { false, false, true, true, true, true, false, false, false, false };
+    if (!mm.hasAnnotation(SequenceMask::MASK) ||
+        dynamic_cast<const SequenceMask&>(mm.annotation(SequenceMask::MASK)).getMask() != expectedMask)
+    {
+      cerr << "Wrong mask." << endl;
+      return 1;
+    }
+    return 0;
+  }
+  catch (exception& ex)
+  {
+    cerr << ex.what() << endl;
+    return 1;
+  }
+}